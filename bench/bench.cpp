@@ -0,0 +1,505 @@
+/*
+ bench.cpp
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <arpa/inet.h>
+#include <rgp/Chord>
+#include <rgp/Log.h>
+
+using namespace rgp;
+
+// operation of a workload
+typedef enum : uint8_t {
+    BenchOperationLookup = 0,
+    BenchOperationPut = 1,
+    BenchOperationGet = 2
+} BenchOperation;
+
+// configuration of all workloads
+struct BenchConfiguration {
+    int nodes { 32 };
+    bool memory { false };
+    int latency { 0 };
+    int stabilize { 500 };
+    int maxStabilize { 8000 };
+    int workers { ChordReactor::kDefaultWorkerCount };
+    std::vector<BenchOperation> operations;
+    int operationCount { 10000 };
+    int warmupCount { 1000 };
+    int keyCount { 10000 };
+    bool zipf { false };
+    double zipfExponent { 0.99 };
+    uint32_t valueSize { 128 };
+    int concurrency { 8 };
+    int timeout { 10 };
+    int convergenceTimeout { 120 };
+    std::string output;
+};
+
+// measurements of one thread (merged after the workload)
+struct BenchSamples {
+    std::vector<double> latencies; // microseconds
+    std::vector<int> hops;
+    int failed { 0 };
+};
+
+// print usage information to the output (if usage was wrong)
+void printUsage (const char *programName)
+{
+    std::cout << "usage: " << programName << " [options]" << std::endl
+              << "  -nodes <count>         number of nodes (default 32)" << std::endl
+              << "  -memory                run the ring on the in-memory network (default tcp on loopback)" << std::endl
+              << "  -latency <ms>          one way latency of the in-memory network (default 0)" << std::endl
+              << "  -stabilize <ms>        stabilize interval of the nodes (default 500)" << std::endl
+              << "  -max-stabilize <ms>    stabilize interval of a stable ring (default 8000)" << std::endl
+              << "  -workers <count>       worker threads of the transport (default "
+              << ChordReactor::kDefaultWorkerCount << ")" << std::endl
+              << "  -workload <list>       comma separated operations: lookup, put, get (default lookup,put,get)" << std::endl
+              << "  -ops <count>           operations per workload (default 10000)" << std::endl
+              << "  -warmup <count>        lookups before the workloads to open the connections (default 1000)" << std::endl
+              << "  -keys <count>          number of different keys (default 10000)" << std::endl
+              << "  -distribution <name>   key distribution: uniform or zipf (default uniform)" << std::endl
+              << "  -zipf <exponent>       exponent of the zipf distribution (default 0.99)" << std::endl
+              << "  -value-size <bytes>    size of the stored values (default 128, at least 4)" << std::endl
+              << "  -concurrency <count>   operations running at the same time (default 8)" << std::endl
+              << "  -timeout <s>           timeout of every operation (default 10)" << std::endl
+              << "  -converge <s>          maximum time to wait for the ring to converge (default 120)" << std::endl
+              << "  -output <file>         write the json result to the file (default stdout)" << std::endl
+              << "  -log-level <level>     0: errors, 1: warnings, 2: info, 3: verbose (default 1)" << std::endl;
+}
+
+// name of the operation in the result
+const char * nameForOperation (BenchOperation operation)
+{
+    switch (operation) {
+        case BenchOperationLookup:
+            return "lookup";
+        case BenchOperationPut:
+            return "put";
+        case BenchOperationGet:
+            return "get";
+    }
+    
+    return "unknown";
+}
+
+// parses a comma separated list of operations
+// returns false if an operation is unknown
+bool parseOperations (std::string list, std::vector<BenchOperation> *operations)
+{
+    operations->clear();
+    
+    std::stringstream stream(list);
+    std::string name;
+    
+    while (std::getline(stream, name, ',')) {
+        if (name == "lookup") {
+            operations->push_back(BenchOperationLookup);
+        } else if (name == "put") {
+            operations->push_back(BenchOperationPut);
+        } else if (name == "get") {
+            operations->push_back(BenchOperationGet);
+        } else {
+            return false;
+        }
+    }
+    
+    return !operations->empty();
+}
+
+// value of the given percentile (nearest rank) of sorted values
+template <typename T>
+T percentile (const std::vector<T> &sortedValues, double fraction)
+{
+    if (sortedValues.empty()) {
+        return T();
+    }
+    
+    size_t rank { static_cast<size_t>(std::ceil(fraction * sortedValues.size())) };
+    return sortedValues[std::min(sortedValues.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+// average of the values
+template <typename T>
+double average (const std::vector<T> &values)
+{
+    if (values.empty()) {
+        return 0;
+    }
+    
+    double sum { 0 };
+    for (T value : values) {
+        sum += value;
+    }
+    
+    return sum / values.size();
+}
+
+// creates a value with the given size (the data starts with its size - see ChordDataStore)
+std::shared_ptr<uint8_t> createValue (uint32_t size)
+{
+    size = std::max<uint32_t>(size, sizeof(uint32_t));
+    
+    std::shared_ptr<uint8_t> data { new uint8_t[size], std::default_delete<uint8_t[]>() };
+    memset(data.get(), 0xAB, size);
+    
+    uint32_t networkSize { htonl(size) };
+    memcpy(data.get(), &networkSize, sizeof(networkSize));
+    
+    return data;
+}
+
+// executes one operation from the node and waits for the result
+// a lookup stores the hops of its route in hops (if not nullptr)
+// returns false if the operation failed
+bool executeOperation (BenchOperation operation, std::shared_ptr<Chord> node, ChordId key,
+                       std::shared_ptr<uint8_t> value, std::chrono::seconds timeout, int *hops = nullptr)
+{
+    switch (operation) {
+        case BenchOperationLookup: {
+            std::shared_ptr<std::promise<int>> promise { std::make_shared<std::promise<int>>() };
+            std::future<int> future { promise->get_future() };
+            
+            node->routedLookupAsync(key, [promise] (std::exception_ptr error, ChordHeaderNode, int routeHops) {
+                if (error) {
+                    promise->set_exception(error);
+                } else {
+                    promise->set_value(routeHops);
+                }
+            });
+            
+            if (future.wait_for(timeout) != std::future_status::ready) {
+                return false;
+            }
+            try {
+                int routeHops { future.get() };
+                if (hops) {
+                    *hops = routeHops;
+                }
+            } catch (...) {
+                return false;
+            }
+            return true;
+        }
+        case BenchOperationPut: {
+            std::future<bool> future { node->putAsync(key, value) };
+            return future.wait_for(timeout) == std::future_status::ready && future.get();
+        }
+        case BenchOperationGet: {
+            std::future<std::shared_ptr<uint8_t>> future { node->getAsync(key) };
+            return future.wait_for(timeout) == std::future_status::ready && future.get() != nullptr;
+        }
+    }
+    
+    return false;
+}
+
+// runs count operations with the given concurrency (one thread per running operation)
+// every operation is started from a random node with a key of the distribution
+// returns the json object of the workload
+std::string runWorkload (ChordSimulator &simulator, const BenchConfiguration &configuration,
+                         BenchOperation operation, const std::vector<ChordId> &keys,
+                         std::discrete_distribution<size_t> keyDistribution)
+{
+    std::vector<std::shared_ptr<Chord>> nodes { simulator.nodes() };
+    std::shared_ptr<uint8_t> value { createValue(configuration.valueSize) };
+    
+    std::atomic<int> nextOperation { 0 };
+    std::vector<BenchSamples> samples(configuration.concurrency);
+    std::vector<std::thread> threads;
+    
+    std::chrono::steady_clock::time_point start { std::chrono::steady_clock::now() };
+    
+    for (int k = 0; k < configuration.concurrency; k++) {
+        threads.push_back(std::thread([&, k] () {
+            
+            BenchSamples &threadSamples = samples[k];
+            std::mt19937 random { std::random_device()() };
+            std::discrete_distribution<size_t> threadKeyDistribution { keyDistribution };
+            std::uniform_int_distribution<size_t> nodeDistribution(0, nodes.size() - 1);
+            
+            while (nextOperation++ < configuration.operationCount) {
+                
+                std::shared_ptr<Chord> node { nodes[nodeDistribution(random)] };
+                ChordId key { keys[threadKeyDistribution(random)] };
+                
+                int hops { -1 };
+                
+                std::chrono::steady_clock::time_point operationStart { std::chrono::steady_clock::now() };
+                bool succeeded { executeOperation(operation, node, key, value, std::chrono::seconds(configuration.timeout), &hops) };
+                std::chrono::duration<double, std::micro> duration { std::chrono::steady_clock::now() - operationStart };
+                
+                if (!succeeded) {
+                    threadSamples.failed++;
+                    continue;
+                }
+                
+                threadSamples.latencies.push_back(duration.count());
+                
+                // hops of the route the lookup took (gets and puts don't report theirs)
+                if (hops >= 0) {
+                    threadSamples.hops.push_back(hops);
+                }
+            }
+        }));
+    }
+    
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    
+    std::chrono::duration<double> duration { std::chrono::steady_clock::now() - start };
+    
+    // merge the measurements of all threads
+    BenchSamples merged;
+    for (BenchSamples &threadSamples : samples) {
+        merged.latencies.insert(merged.latencies.end(), threadSamples.latencies.begin(), threadSamples.latencies.end());
+        merged.hops.insert(merged.hops.end(), threadSamples.hops.begin(), threadSamples.hops.end());
+        merged.failed += threadSamples.failed;
+    }
+    std::sort(merged.latencies.begin(), merged.latencies.end());
+    std::sort(merged.hops.begin(), merged.hops.end());
+    
+    std::stringstream json;
+    json << std::fixed << std::setprecision(3)
+         << "{\"operation\": \"" << nameForOperation(operation) << "\", "
+         << "\"operations\": " << configuration.operationCount << ", "
+         << "\"succeeded\": " << merged.latencies.size() << ", "
+         << "\"failed\": " << merged.failed << ", "
+         << "\"seconds\": " << duration.count() << ", "
+         << "\"ops_per_second\": " << merged.latencies.size() / duration.count() << ", "
+         << "\"latency_us\": {"
+         << "\"mean\": " << average(merged.latencies) << ", "
+         << "\"p50\": " << percentile(merged.latencies, 0.5) << ", "
+         << "\"p99\": " << percentile(merged.latencies, 0.99) << ", "
+         << "\"p999\": " << percentile(merged.latencies, 0.999) << ", "
+         << "\"max\": " << (merged.latencies.empty() ? 0 : merged.latencies.back()) << "}";
+    
+    if (operation == BenchOperationLookup) {
+        json << ", \"hops\": {"
+             << "\"mean\": " << average(merged.hops) << ", "
+             << "\"p50\": " << percentile(merged.hops, 0.5) << ", "
+             << "\"p99\": " << percentile(merged.hops, 0.99) << ", "
+             << "\"max\": " << (merged.hops.empty() ? 0 : merged.hops.back()) << "}";
+    }
+    json << "}";
+    
+    return json.str();
+}
+
+// puts every key once (with the concurrency of the workloads)
+// returns the number of failed puts
+int preloadKeys (ChordSimulator &simulator, const BenchConfiguration &configuration, const std::vector<ChordId> &keys)
+{
+    std::vector<std::shared_ptr<Chord>> nodes { simulator.nodes() };
+    std::shared_ptr<uint8_t> value { createValue(configuration.valueSize) };
+    
+    std::atomic<size_t> nextKey { 0 };
+    std::atomic<int> failed { 0 };
+    std::vector<std::thread> threads;
+    
+    for (int k = 0; k < configuration.concurrency; k++) {
+        threads.push_back(std::thread([&] () {
+            
+            size_t key;
+            while ((key = nextKey++) < keys.size()) {
+                if (!executeOperation(BenchOperationPut, nodes[key % nodes.size()], keys[key], value,
+                                      std::chrono::seconds(configuration.timeout))) {
+                    failed++;
+                }
+            }
+        }));
+    }
+    
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    
+    return failed;
+}
+
+int main (int argc, const char **argv)
+{
+    BenchConfiguration configuration;
+    parseOperations("lookup,put,get", &configuration.operations);
+    
+    for (int k = 1; k < argc; k++) {
+        
+        bool hasValue { k + 1 < argc };
+        
+        if (strcmp(argv[k], "-memory") == 0) {
+            configuration.memory = true;
+        } else if (strcmp(argv[k], "-nodes") == 0 && hasValue) {
+            configuration.nodes = atoi(argv[++k]);
+        } else if (strcmp(argv[k], "-latency") == 0 && hasValue) {
+            configuration.latency = atoi(argv[++k]);
+        } else if (strcmp(argv[k], "-stabilize") == 0 && hasValue) {
+            configuration.stabilize = atoi(argv[++k]);
+        } else if (strcmp(argv[k], "-max-stabilize") == 0 && hasValue) {
+            configuration.maxStabilize = atoi(argv[++k]);
+        } else if (strcmp(argv[k], "-workers") == 0 && hasValue) {
+            configuration.workers = atoi(argv[++k]);
+        } else if (strcmp(argv[k], "-workload") == 0 && hasValue) {
+            if (!parseOperations(argv[++k], &configuration.operations)) {
+                printUsage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[k], "-ops") == 0 && hasValue) {
+            configuration.operationCount = atoi(argv[++k]);
+        } else if (strcmp(argv[k], "-warmup") == 0 && hasValue) {
+            configuration.warmupCount = atoi(argv[++k]);
+        } else if (strcmp(argv[k], "-keys") == 0 && hasValue) {
+            configuration.keyCount = atoi(argv[++k]);
+        } else if (strcmp(argv[k], "-distribution") == 0 && hasValue) {
+            std::string distribution { argv[++k] };
+            if (distribution != "uniform" && distribution != "zipf") {
+                printUsage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            configuration.zipf = distribution == "zipf";
+        } else if (strcmp(argv[k], "-zipf") == 0 && hasValue) {
+            configuration.zipfExponent = atof(argv[++k]);
+        } else if (strcmp(argv[k], "-value-size") == 0 && hasValue) {
+            configuration.valueSize = static_cast<uint32_t>(atoi(argv[++k]));
+        } else if (strcmp(argv[k], "-concurrency") == 0 && hasValue) {
+            configuration.concurrency = atoi(argv[++k]);
+        } else if (strcmp(argv[k], "-timeout") == 0 && hasValue) {
+            configuration.timeout = atoi(argv[++k]);
+        } else if (strcmp(argv[k], "-converge") == 0 && hasValue) {
+            configuration.convergenceTimeout = atoi(argv[++k]);
+        } else if (strcmp(argv[k], "-output") == 0 && hasValue) {
+            configuration.output = argv[++k];
+        } else if (strcmp(argv[k], "-log-level") == 0 && hasValue) {
+            int level { atoi(argv[++k]) };
+            ChordLog::sharedLog()->setLevel(static_cast<ChordLogLevel>(std::max(0, std::min(level, static_cast<int>(ChordLogLevelVerbose)))));
+        } else {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    
+    if (configuration.nodes < 1 || configuration.operationCount < 1 || configuration.warmupCount < 0 || configuration.keyCount < 1 ||
+        configuration.concurrency < 1 || configuration.timeout < 1 || configuration.convergenceTimeout < 0 ||
+        configuration.zipfExponent < 0) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    configuration.valueSize = std::max<uint32_t>(configuration.valueSize, sizeof(uint32_t));
+    
+    // keys of the workloads and their probabilities (rank k has weight 1/k^s for zipf)
+    std::vector<ChordId> keys;
+    std::vector<double> weights;
+    for (int k = 0; k < configuration.keyCount; k++) {
+        keys.push_back(ChordHash::keyForString(std::string("bench-key-") += std::to_string(k)));
+        weights.push_back(configuration.zipf ? 1.0 / std::pow(k + 1, configuration.zipfExponent) : 1.0);
+    }
+    std::discrete_distribution<size_t> keyDistribution(weights.begin(), weights.end());
+    
+    ChordSimulator simulator(configuration.workers, configuration.memory ? ChordSimulator::ChordSimulatorNetworkMemory
+                                                                         : ChordSimulator::ChordSimulatorNetworkLoopback);
+    if (simulator.network()) {
+        simulator.network()->setLatency(std::chrono::milliseconds(configuration.latency), std::chrono::milliseconds(0));
+    }
+    simulator.setStabilizeInterval(std::chrono::milliseconds(configuration.stabilize),
+                                   std::chrono::milliseconds(configuration.maxStabilize));
+    
+    // progress is written to stderr - stdout only contains the result
+    std::cerr << "starting " << configuration.nodes << " nodes ..." << std::endl;
+    
+    // build the ring - the workloads need correct successors
+    std::chrono::steady_clock::time_point start { std::chrono::steady_clock::now() };
+    simulator.addNodes(configuration.nodes);
+    bool converged { simulator.waitForConvergence(std::chrono::seconds(configuration.convergenceTimeout)) };
+    std::chrono::duration<double> setupDuration { std::chrono::steady_clock::now() - start };
+    
+    if (converged) {
+        std::cerr << "converged after " << setupDuration.count() << " s" << std::endl;
+    } else {
+        Log::sharedLog()->error("ring didn't converge - the results include routing errors");
+    }
+    
+    // gets need existing data
+    int failedPreloads { 0 };
+    if (std::find(configuration.operations.begin(), configuration.operations.end(), BenchOperationGet) !=
+        configuration.operations.end()) {
+        std::cerr << "storing " << configuration.keyCount << " keys ..." << std::endl;
+        failedPreloads = preloadKeys(simulator, configuration, keys);
+    }
+    
+    // the first operations between two nodes open their connections
+    if (configuration.warmupCount > 0) {
+        BenchConfiguration warmup { configuration };
+        warmup.operationCount = configuration.warmupCount;
+        runWorkload(simulator, warmup, BenchOperationLookup, keys, keyDistribution);
+    }
+    
+    std::stringstream json;
+    json << std::fixed << std::setprecision(3)
+         << "{\"nodes\": " << configuration.nodes << ", "
+         << "\"network\": \"" << (configuration.memory ? "memory" : "loopback") << "\", "
+         << "\"id_bits\": " << RGPCHORD_ID_BITS << ", "
+         << "\"keys\": " << configuration.keyCount << ", "
+         << "\"distribution\": \"" << (configuration.zipf ? "zipf" : "uniform") << "\", "
+         << "\"zipf_exponent\": " << configuration.zipfExponent << ", "
+         << "\"value_size\": " << configuration.valueSize << ", "
+         << "\"concurrency\": " << configuration.concurrency << ", "
+         << "\"setup_seconds\": " << setupDuration.count() << ", "
+         << "\"converged\": " << (converged ? "true" : "false") << ", "
+         << "\"failed_preloads\": " << failedPreloads << ", "
+         << "\"workloads\": [";
+    
+    for (size_t k = 0; k < configuration.operations.size(); k++) {
+        std::cerr << "running " << nameForOperation(configuration.operations[k]) << " workload ..." << std::endl;
+        json << (k > 0 ? ", " : "")
+             << runWorkload(simulator, configuration, configuration.operations[k], keys, keyDistribution);
+    }
+    json << "]}" << std::endl;
+    
+    if (configuration.output.empty()) {
+        std::cout << json.str();
+    } else {
+        std::ofstream file(configuration.output);
+        file << json.str();
+        
+        if (!file) {
+            Log::sharedLog()->error(std::string("couldn't write ") += configuration.output);
+            return EXIT_FAILURE;
+        }
+    }
+    
+    return EXIT_SUCCESS;
+}
@@ -31,41 +31,124 @@
 
 #include <list>
 #include <map>
+#include <vector>
 #include <thread>
+#include <mutex>
+#include <atomic>
 #include <memory>
+#include <future>
+#include <chrono>
+#include <condition_variable>
 
 #include <rgp/Chord>
+#include <rgp/ChordShardedDataStore.h>
+#include <rgp/ChordLocationCache.h>
+#include <rgp/ChordMetrics.h>
+#include <rgp/ChordMetricsServer.h>
+#include <rgp/ChordTracer.h>
+#include <rgp/ChordAdaptiveInterval.h>
 
 namespace rgp {
     
     // forward declaration
     class ChordNode;
+    class ChordConnection;
+    class ChordTransport;
+    struct ChordIterativeLookup;
+    struct ChordKeyGrouping;
+    struct ChordMultiRequest;
     
-    class Chord : std::enable_shared_from_this<Chord>
+    // keys grouped by the id of their responsible node
+    typedef std::map<ChordId, std::pair<ChordHeaderNode, std::vector<ChordId>>> ChordKeysByNode;
+    
+    // the node has to be created as shared_ptr and started with start()
+    class Chord : public std::enable_shared_from_this<Chord>
     {
         
     public:
-        Chord (std::string ipAddress, uint16_t port);
-        Chord (std::string ipAddress, uint16_t port, std::string c_ipAddress, uint16_t c_port);
+        // node that communicates over TCP (ChordSocketTransport)
+        // identity: configured name of the node - the node id is its hash
+        // (empty: the id is the hash of ip:port, see ChordHash::keyForNode)
+        // the same identity always gets the same id on every start
+        Chord (std::string ipAddress, uint16_t port, std::string identity = "");
+        Chord (std::string ipAddress, uint16_t port, std::string c_ipAddress, uint16_t c_port,
+               std::string identity = "");
+        
+        // node with the given id that uses the given transport
+        // (f.e. the in-memory transport of ChordSimulator)
+        // an empty c_ipAddress creates a new ring
+        // listen: false if someone else accepts our connections (ChordHost)
+        // dataMap / replicaMap: stores shared with other nodes of the process
+        // (nullptr: the node uses its own stores)
+        Chord (ChordId nodeId, std::string ipAddress, uint16_t port, std::string c_ipAddress, uint16_t c_port,
+               std::shared_ptr<ChordTransport> transport, bool listen = true,
+               std::shared_ptr<ChordShardedDataStore> dataMap = nullptr,
+               std::shared_ptr<ChordShardedDataStore> replicaMap = nullptr);
         ~Chord ();
         
+        // creates (or joins) the ring and starts the protocols
+        // has to be called once after the node was created (as shared_ptr)
+        void start ();
+        
+        // stops the protocols and waits for their threads
+        // has to be called before the owner releases the node - a protocol thread
+        // may hold the last reference otherwise (and would destroy the node itself)
+        void stop ();
+        
+        // interval of the stabilize and fix fingers protocols
+        // (minimum after membership changes, doubled after every round without change till the maximum)
+        void setStabilizeInterval (std::chrono::milliseconds minimum, std::chrono::milliseconds maximum);
+        // fixed interval (no backoff)
+        void setStabilizeInterval (std::chrono::milliseconds interval) { setStabilizeInterval(interval, interval); }
+        // a node joined or left - the protocols run with the minimum interval
+        // (f.e. a connection to another node was closed)
+        void membershipChanged ();
+        
         // key lenght (exponent m of the formular)
-        static const int kKeyLenght { 32 };
+        static const int kKeyLenght { ChordIdRing::kKeyLength };
+        
+        // number of successors every node remembers (r)
+        // the ring survives as long as not all of them fail at once
+        static const int kSuccessorListLength { 4 };
+        
+        // default range of the stabilize interval (milliseconds)
+        static const int kMinStabilizeInterval { 1000 };
+        static const int kMaxStabilizeInterval { 30000 };
         
         // helper to quickly create a Chord Header
         ChordHeader createChordHeader (ChordMessageType);
         
         // highest possible hash id
-        ChordId highestID () const;
+        static constexpr ChordId highestID () { return ChordIdRing::highestId(); }
         
         // check if i'm responsible for the given key
         bool keyIsInMyRange (ChordId key) const;
         
+        // checks if key is inside the ring interval (from, to]
+        static bool keyIsInRange (ChordId key, ChordId from, ChordId to);
+        
+        // checks if key is inside the ring interval (from, to)
+        static bool keyIsBetween (ChordId key, ChordId from, ChordId to);
+        
         // perform a search for the given key
-        ChordHeaderNode searchForKey (ChordId searchingNode, ChordId key) const;
+        // returns own node if the search failed
+        ChordHeaderNode searchForKey (ChordId searchingNode, ChordId key);
+        
+        // perform an asynchronous search for the given key
+        // (searchingNode is the node that started the search)
+        void searchForKeyAsync (ChordId searchingNode, ChordId key, ChordLookupHandler handler);
+        // traceId: forwarded searches carry the trace (0: untraced)
+        // hops: number of nodes the search already passed
+        // the handler gets the requests we sent for the search and the path of the following nodes
+        void searchForKeyAsync (ChordId searchingNode, ChordId key, uint32_t traceId, uint8_t hops,
+                                ChordTracedLookupHandler handler);
         
         // update predecessor if needed
+        // (our old predecessor is told about the new one)
         ChordHeaderNode updatePredecessor (ChordHeaderNode node);
+        // our successor told us about a node that joined between us
+        // stabilizes right away if it is closer than our successor
+        void successorSuggested (ChordHeaderNode node);
         
         // searches all data from chord for given node id
         // returns nullptr if not found
@@ -74,50 +157,277 @@ namespace rgp {
         // adds data from remote node to local data map - if we are responsible
         // returns true on success
         // returns false if we aren't responsible
-        bool addDataToHashMap (std::shared_ptr<uint8_t> data);
+        bool addDataToHashMap (ChordId key, std::shared_ptr<uint8_t> data);
+        // adds all items we are responsible for (replicated as one batch)
+        // returns false if we aren't responsible for any of them
+        bool addDataItemsToHashMap (const std::vector<ChordDataItem> &items);
+        
+        // adds a copy of data one of our predecessors is responsible for
+        // the copy will be used if we become responsible for it
+        void addReplicaToHashMap (ChordId key, std::shared_ptr<uint8_t> data);
         
         // searches local data for data id and returns the data
+        // (replicas are used if the responsible node died)
         // returns nullptr if there is no data with that key
         std::shared_ptr<uint8_t> getDataWithKey (ChordId dataId);
         
+        // number of nodes that store each data (default 1 - no replicas)
+        // the data is copied to the next replicationFactor-1 successors
+        void setReplicationFactor (int replicationFactor);
+        
+        // asynchronous api - these methods don't wait for the network
+        // the handler is called as soon as the operation finished
+        // (by a transport worker or directly if no remote node is involved)
+        
+        // searches the node that is responsible for the key
+        // (routed as configured with setLookupMode)
+        void lookupAsync (ChordId key, ChordLookupHandler handler);
+        std::future<ChordHeaderNode> lookupAsync (ChordId key);
+        // the handler also gets the hops of the lookup (the value of chord_lookup_hops)
+        void routedLookupAsync (ChordId key, ChordRoutedLookupHandler handler);
+        
+        // receives the data with the key from the responsible node
+        // the result is nullptr if there is no data with that key
+        void getAsync (ChordId key, ChordGetHandler handler);
+        std::future<std::shared_ptr<uint8_t>> getAsync (ChordId key);
+        
+        // adds the data to the responsible node
+        // the key is the hash of the content (see ChordHash::keyForData)
+        void putAsync (std::shared_ptr<uint8_t> data, ChordPutHandler handler);
+        std::future<bool> putAsync (std::shared_ptr<uint8_t> data);
+        
+        // adds the data with an application key (f.e. ChordHash::keyForString)
+        void putAsync (ChordId key, std::shared_ptr<uint8_t> data, ChordPutHandler handler);
+        std::future<bool> putAsync (ChordId key, std::shared_ptr<uint8_t> data);
+        
+        // receives the data of several keys - the keys are grouped by their
+        // responsible node, every node gets one request (all in parallel)
+        void multiGetAsync (std::vector<ChordId> keys, ChordMultiGetHandler handler);
+        std::future<std::map<ChordId, std::shared_ptr<uint8_t>>> multiGetAsync (std::vector<ChordId> keys);
+        
+        // adds several data items - one batched transfer per responsible node
+        // added is false if any item wasn't added
+        void multiPutAsync (std::vector<ChordDataItem> items, ChordPutHandler handler);
+        std::future<bool> multiPutAsync (std::vector<ChordDataItem> items);
+        
+        // configures how lookups of this node are routed (default is recursive)
+        // parallelism: number of nodes an iterative lookup asks at the same time
+        void setLookupMode (ChordLookupMode mode, int parallelism = 1);
+        
+        // traces every interval-th recursive lookup of this node (0: off - default)
+        // the path with the time of every hop is passed to the trace handler
+        void setTraceSampling (uint32_t interval) { _tracer.setSamplingInterval(interval); }
+        // called with every traced lookup (default: logged with ChordLogLevelInfo)
+        void setTraceHandler (ChordTraceHandler handler) { _tracer.setHandler(handler); }
+        
+        // answers one step of an iterative search (only checks local state)
+        // returns true if nodes contains the responsible node
+        // returns false if nodes contains up to count nodes closest preceding the key
+        bool nextHopsForKey (ChordId key, uint8_t count, std::vector<ChordHeaderNode> *nodes);
+        
+        // our successor followed by its successors
+        // (send with every predecessor answer)
+        std::vector<ChordHeaderNode> successorList ();
+        
+        // takes over a new connection after its identify message was received
+        // (ChordHost passes the connections of its virtual nodes)
+        // (closes the connection if the node uses another id width)
+        void adoptConnection (std::shared_ptr<ChordConnection> connection, ChordHeader identifyHeader,
+                              std::shared_ptr<uint8_t> identifyData);
+        
+        // our own node
+        std::shared_ptr<ChordNode> ownNode () const { return _ownNode; }
+        
+        // connects the nodes and runs all handlers
+        std::shared_ptr<ChordTransport> transport () const { return _transport; }
+        
+        // counters and latencies of this node
+        std::shared_ptr<ChordMetrics> metrics () const { return _metrics; }
+        
+        // all metrics of this node as text (see ChordMetrics::snapshot)
+        // adds the current size of the stores and the traffic per connected node
+        std::string metricsSnapshot ();
+        
+        // serves metricsSnapshot() on the unix domain socket (see ChordMetricsServer)
+        // returns false if the socket can't be created
+        bool startMetricsServer (std::string socketPath);
+        
     private:
-        // will be initialised from constructor
+        // configuration till the node is started
+        ChordId _nodeId { 0 };
+        std::string _ipAddress { "" };
+        uint16_t _port { 0 };
+        // node to join (empty: create a new ring)
+        std::string _joinIpAddress { "" };
+        uint16_t _joinPort { 0 };
+        // accept connections ourself
+        bool _listen { true };
+        
+        // will be initialised by start()
         std::shared_ptr<ChordNode> _ownNode { nullptr };
         std::shared_ptr<ChordNode> _successor { nullptr };
         std::shared_ptr<ChordNode> _predecessor { nullptr };
-        std::list<std::shared_ptr<ChordNode>> _fingerTable;
+        // protect successor, predecessor and responsibilityRange
+        // (changed by stabilize and the workers, read by every lookup)
+        mutable std::mutex _neighbours_mutex;
+        // serializes the predecessor updates of the workers
+        std::mutex _updatePredecessor_mutex;
+        
+        // the next kSuccessorListLength nodes on the ring (first is our successor)
+        // if the successor fails the next living node is used immediately
+        std::vector<std::shared_ptr<ChordNode>> _successorList;
+        // protect successorList
+        std::mutex _successorList_mutex;
+        
+        // finger i points to the successor of (own node id + 2^i)
+        // (finger 0 is always our successor)
+        std::vector<std::shared_ptr<ChordNode>> _fingerTable;
+        // protect fingerTable
+        std::mutex _fingerTable_mutex;
         
         // table of all local data (the data this node is responsible for)
-        std::map<int, std::shared_ptr<uint8_t>> _dataMap;
+        // (thread safe - locked per shard)
+        // virtual nodes of one host share the store (their ranges don't overlap)
+        std::shared_ptr<ChordShardedDataStore> _dataMap;
+        
+        // copies of the data of our predecessors
+        std::shared_ptr<ChordShardedDataStore> _replicaMap;
         
-        // protect dataMap
-        std::mutex _dataMap_mutex;
-        // thread to which unknown nodes can connect to
-        std::thread _connectThread;
-        // set this true to close connectThread
-        std::atomic<bool> _stopConnectThread { false };
+        // responsible nodes of recent lookups
+        ChordLocationCache _locationCache;
+        
+        // samples our lookups
+        ChordTracer _tracer;
+        
+        // number of nodes that store each data
+        std::atomic<int> _replicationFactor { 1 };
+        
+        // connections to other nodes and handler execution
+        std::shared_ptr<ChordTransport> _transport { nullptr };
+        // given to our nodes (set by start)
+        // the protocol threads run till the destructor stopped them - shared_from_this() would throw then
+        std::weak_ptr<Chord> _weakSelf;
+        // we listen on our address (false for virtual nodes - the host listens for them)
+        bool _listening { false };
         
         // thread for the stabilization protocol
         std::thread _stabilizeThread;
         // stops the stabilization thread
         std::atomic<bool> _stopStabilizeThread { false };
+        // interval of the stabilization protocol
+        ChordAdaptiveInterval _stabilizeInterval { std::chrono::milliseconds(kMinStabilizeInterval),
+                                                   std::chrono::milliseconds(kMaxStabilizeInterval) };
+        
+        // thread for the fix fingers protocol
+        std::thread _fixFingersThread;
+        // stops the fix fingers thread
+        std::atomic<bool> _stopFixFingersThread { false };
+        // interval of the fix fingers protocol (backs off while the fingers don't change)
+        ChordAdaptiveInterval _fixFingersInterval { std::chrono::milliseconds(kMinStabilizeInterval),
+                                                    std::chrono::milliseconds(kMaxStabilizeInterval) };
+        
+        // wakes up the protocol threads when the node is stopped (or the membership changed)
+        std::condition_variable _stop_condition;
+        std::mutex _stop_mutex;
+        // only one caller joins the protocol threads
+        std::mutex _stopThreads_mutex;
+        // waits till the next round of the protocol - returns false if the node was stopped
+        // (fails the expired requests of our nodes meanwhile)
+        bool waitForNextRound (ChordAdaptiveInterval &interval, const std::atomic<bool> &stop);
+        // fails the requests of all connected nodes that wait too long
+        void failExpiredRequests ();
+        // next finger that will be refreshed by fixFingers
+        int _nextFingerToFix { 0 };
         
         // all currently connected nodes
         std::list<std::shared_ptr<ChordNode>> _connectedNodes;
         // safeguard access to connectedNodes list
         std::mutex _connectedNodes_mutex;
+        // routing of our own lookups
+        std::atomic<ChordLookupMode> _lookupMode { ChordLookupModeRecursive };
+        // number of parallel requests of an iterative lookup
+        std::atomic<int> _lookupParallelism { 1 };
+        
         // range that i'm responsible for
         ChordRange _responsibilityRange { .from = 0, .to = 0 };
+        // false while joining - the range is a guess until our first predecessor is known
+        bool _responsibilityRangeKnown { false };
         
-        // method of connectThread
-        void waitForIncommingConnections ();
+        // counters and latencies (shared with our nodes)
+        std::shared_ptr<ChordMetrics> _metrics { std::make_shared<ChordMetrics>() };
+        // admin socket (nullptr till startMetricsServer)
+        std::unique_ptr<ChordMetricsServer> _metricsServer;
+        
+        // waits (transport) for incomming connections on our address
+        void startListening ();
+        // waits for the identify message of an incomming connection (called by transport)
+        void acceptConnection (std::shared_ptr<ChordConnection> connection);
+        // node id of the configuration (hash of the identity or of ip:port)
+        static ChordId nodeIdForConfiguration (std::string ipAddress, uint16_t port, std::string identity);
         // my IP-Address and my Port
-        void initOwnNode (std::string ipAddress, uint16_t port);
+        void initOwnNode (ChordId nodeId, std::string ipAddress, uint16_t port);
         // join existing DHT using given ip and port
+        // terminates if another node already has our id
         void joinDHT (std::string c_ipAddress, uint16_t c_port);
         // sets the given node as predecessor
         inline void setPredecessor (ChordHeaderNode node);
         
+        // copies of the neighbours and the range (thread safe)
+        std::shared_ptr<ChordNode> currentSuccessor () const;
+        std::shared_ptr<ChordNode> currentPredecessor () const;
+        ChordRange responsibilityRange () const;
+        // replaces the successor (thread safe)
+        void setSuccessor (std::shared_ptr<ChordNode> node);
+        
+        // returns the known node for the given header node
+        // or creates (and remembers) a new one
+        std::shared_ptr<ChordNode> nodeForHeaderNode (ChordHeaderNode node);
+        
+        // first id that finger i is responsible for (own node id + 2^i)
+        ChordId fingerStart (int finger) const;
+        
+        // returns the node of the finger table that most closely precedes key
+        // returns nullptr if no finger precedes the key
+        std::shared_ptr<ChordNode> closestPrecedingNode (ChordId key);
+        
+        // iterative lookup: we ask every hop for the next one ourself
+        void iterativeLookupAsync (ChordId key, ChordRoutedLookupHandler handler);
+        // asks the closest known nodes (that weren't asked yet) for the next hops
+        void continueIterativeLookup (std::shared_ptr<ChordIterativeLookup> lookup);
+        
+        // looks up the responsible nodes of all keys (in parallel)
+        // useCache: keys of cached ranges don't need a lookup
+        // error is set if a lookup failed (its key is missing then)
+        void groupKeysByNode (std::vector<ChordId> keys, bool useCache,
+                              std::function<void (std::exception_ptr error, ChordKeysByNode groups)> handler);
+        
+        // get / put without the location cache (f.e. the cached node was wrong)
+        void lookupAndGetAsync (ChordId key, ChordGetHandler handler);
+        // receives the data from the given (responsible) node
+        void getFromNodeAsync (ChordHeaderNode node, ChordId key, ChordGetHandler handler);
+        void lookupAndPutAsync (ChordId key, std::shared_ptr<uint8_t> data, ChordPutHandler handler);
+        
+        // multi get / put - keys of cached nodes that failed are retried without cache
+        void multiGetAsync (std::vector<ChordId> keys, bool useCache, ChordMultiGetHandler handler);
+        void multiPutAsync (std::vector<ChordDataItem> items, bool useCache, ChordPutHandler handler);
+        
+        // checks if the given node is referenced by the finger table
+        bool isFinger (std::shared_ptr<ChordNode> node);
+        
+        // sends copies of the data to the next replicationFactor-1 successors
+        void replicateData (ChordId key, std::shared_ptr<uint8_t> data);
+        // sends copies of all items to the successors (one batched transfer per successor)
+        void replicateItems (std::shared_ptr<std::vector<ChordDataItem>> items);
+        // we became responsible for the replicas in [from, to] -> make them our own data
+        void promoteReplicas (ChordId from, ChordId to);
+        
+        // rebuilds the successor list from our successor and its successor list
+        // returns true if the list changed
+        bool updateSuccessorList (std::vector<ChordHeaderNode> successorsOfSuccessor);
+        // replaces the dead successor with the next living node of the successor list
+        // returns false if there is no living node
+        bool promoteNextSuccessor ();
+        
         // stabilize protocol
         void stabilize ();
         // fix fingers protocol
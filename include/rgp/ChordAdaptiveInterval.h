@@ -0,0 +1,81 @@
+/*
+ ChordAdaptiveInterval.h
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGP__Chord__ChordAdaptiveInterval__
+#define __RGP__Chord__ChordAdaptiveInterval__
+
+#include <iostream>
+
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+
+namespace rgp {
+    
+    /**
+     @brief Interval of a periodic protocol that adapts to the changes it finds.
+     @details After a reset (f.e. a node joined or failed) the protocol runs with
+     the minimum interval. Every round without a reset doubles the interval till
+     the maximum - a stable ring causes almost no background traffic.
+     Every delay is jittered, so the nodes of a ring don't run their rounds
+     (and send their messages) at the same time.
+     */
+    class ChordAdaptiveInterval {
+        
+    public:
+        // maximum deviation of a delay from the interval (percent)
+        static const int kJitterPercent { 20 };
+        
+        ChordAdaptiveInterval (std::chrono::milliseconds minimum, std::chrono::milliseconds maximum);
+        
+        // range of the interval (minimum == maximum: fixed interval)
+        void setRange (std::chrono::milliseconds minimum, std::chrono::milliseconds maximum);
+        
+        // the next rounds run with the minimum interval again
+        void reset ();
+        // true if reset was called since the last nextDelay (wakes up a waiting protocol)
+        bool wasReset () const { return _reset.load(); }
+        
+        // jittered delay till the next round - the following round waits twice as long
+        std::chrono::milliseconds nextDelay ();
+        
+        // current interval (without jitter)
+        std::chrono::milliseconds interval ();
+        
+    private:
+        int64_t _minimum;
+        int64_t _maximum;
+        int64_t _current;
+        // protect minimum, maximum and current
+        // (reset is written with current - but read without the lock by wasReset)
+        std::mutex _interval_mutex;
+        
+        std::atomic<bool> _reset { false };
+    };
+}
+
+#endif /* defined(__RGP__Chord__ChordAdaptiveInterval__) */
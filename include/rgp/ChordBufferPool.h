@@ -0,0 +1,71 @@
+/*
+ ChordBufferPool.h
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGP__Chord__ChordBufferPool__
+#define __RGP__Chord__ChordBufferPool__
+
+#include <iostream>
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace rgp {
+    
+    /**
+     @brief Reusable receive buffers of one connection.
+     @details A buffer goes back to the pool as soon as the last shared_ptr
+     to it is released, so receiving a message doesn't need an allocation
+     once the pool is warm. Only a few buffers up to kMaxPooledSize are
+     kept - bigger buffers are freed immediately.
+     Create the pool with std::make_shared.
+     */
+    class ChordBufferPool : public std::enable_shared_from_this<ChordBufferPool> {
+        
+    public:
+        // maximum number of unused buffers kept by the pool
+        static const size_t kMaxPooledBuffers { 16 };
+        // bigger buffers aren't pooled
+        static const uint32_t kMaxPooledSize { 1024 * 1024 };
+        
+        ~ChordBufferPool ();
+        
+        // returns a buffer with at least size bytes
+        std::shared_ptr<uint8_t> acquire (uint32_t size);
+        
+    private:
+        // unused buffers (capacity, buffer)
+        std::vector<std::pair<uint32_t, uint8_t *>> _freeBuffers;
+        // protect free buffers (buffers are released by any worker)
+        std::mutex _freeBuffers_mutex;
+        
+        // takes the buffer back (or frees it if the pool is full)
+        void release (uint8_t *buffer, uint32_t capacity);
+    };
+}
+
+#endif /* defined(__RGP__Chord__ChordBufferPool__) */
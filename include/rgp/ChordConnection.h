@@ -0,0 +1,68 @@
+/*
+ ChordConnection.h
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGP__Chord__ChordConnection__
+#define __RGP__Chord__ChordConnection__
+
+#include <iostream>
+
+#include <memory>
+#include <functional>
+
+#include <rgp/ChordTypes.h>
+
+namespace rgp {
+    
+    /**
+     @brief Connection between two nodes that transports messages.
+     @details Implemented by the transports (TCP sockets or the in-memory
+     network of the simulator). Messages arrive in the order they were send.
+     */
+    class ChordConnection {
+        
+    public:
+        // called for every received message
+        typedef std::function<void (ChordHeader header, std::shared_ptr<uint8_t> data)> ChordMessageHandler;
+        // called once if the connection was closed by the remote side or broke
+        typedef std::function<void ()> ChordClosedHandler;
+        
+        virtual ~ChordConnection () {}
+        
+        // sends the header followed by the data (can be used by several threads)
+        // throws ChordConnectionException on error
+        virtual void send (ChordHeader header, std::shared_ptr<uint8_t> data, uint32_t dataSize) = 0;
+        
+        // passes the received messages to the handler - one message at a time
+        // can be called again (f.e. by a handler) to pass the next messages to
+        // another handler
+        virtual void receive (ChordMessageHandler handler, ChordClosedHandler closedHandler) = 0;
+        
+        // closes the connection - the handlers will not be called anymore
+        virtual void close () = 0;
+    };
+}
+
+#endif /* defined(__RGP__Chord__ChordConnection__) */
@@ -0,0 +1,73 @@
+/*
+ ChordCounter.h
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGP__Chord__ChordCounter__
+#define __RGP__Chord__ChordCounter__
+
+#include <iostream>
+
+#include <atomic>
+#include <cstdint>
+
+namespace rgp {
+    
+    /**
+     @brief Counter that many threads can increment without contention.
+     @details Every thread adds to its own slot (one cache line each, no lock,
+     no shared cache line between the workers). Reading the value sums
+     the slots - that is slower, but only done for snapshots.
+     */
+    class ChordCounter {
+        
+    public:
+        // number of slots (threads beyond that share slots)
+        static const size_t kSlotCount { 8 };
+        
+        ChordCounter ();
+        
+        // adds the value to the slot of the calling thread
+        void add (uint64_t value = 1) { _slots[slotIndex()].value.fetch_add(value, std::memory_order_relaxed); }
+        
+        // sum of all slots
+        uint64_t value () const;
+        
+    private:
+        // size of a cache line (slots must not share one)
+        static const size_t kCacheLineSize { 64 };
+        
+        struct Slot {
+            std::atomic<uint64_t> value;
+            uint8_t padding[kCacheLineSize - sizeof(std::atomic<uint64_t>)];
+        };
+        
+        Slot _slots[kSlotCount];
+        
+        // slot of the calling thread (assigned on its first use)
+        static size_t slotIndex ();
+    };
+}
+
+#endif /* defined(__RGP__Chord__ChordCounter__) */
@@ -0,0 +1,121 @@
+/*
+ ChordDataStore.h
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGP__Chord__ChordDataStore__
+#define __RGP__Chord__ChordDataStore__
+
+#include <iostream>
+
+#include <vector>
+#include <memory>
+
+#include <rgp/ChordTypes.h>
+
+namespace rgp {
+    
+    /**
+     @brief Local data of a node, sorted by key.
+     @details The entries are kept in a sorted array instead of a tree, small
+     values are stored inside the entry and bigger values in one contiguous
+     arena. New keys are collected in a small sorted array that is merged
+     into the main array from time to time, so inserts don't move the whole
+     store. Because the keys are sorted a range of the ring can be removed
+     as one slice (key transfer).
+     The store isn't thread safe - the caller has to lock it.
+     */
+    class ChordDataStore {
+        
+    public:
+        // values up to this size are stored inside the entry
+        static const uint32_t kInlineSize { 16 };
+        
+        // new keys are merged into the main array if there are this many
+        static const size_t kMergeThreshold { 1024 };
+        
+        // adds (or replaces) the data with the key
+        // the data has to start with its size (network byte order)
+        void put (ChordId key, std::shared_ptr<uint8_t> data);
+        
+        // returns a copy of the data with the key or nullptr
+        std::shared_ptr<uint8_t> get (ChordId key) const;
+        
+        // removes the data with the key
+        // returns false if there was no data with the key
+        bool remove (ChordId key);
+        
+        // removes all data inside the ring interval [from, to]
+        // (wraps around zero if from > to)
+        // the removed data is appended to removed (if not nullptr)
+        void removeRange (ChordId from, ChordId to, std::vector<ChordDataItem> *removed);
+        
+        // number of stored keys
+        size_t size () const { return _entries.size() + _recentEntries.size(); }
+        
+    private:
+        struct Entry {
+            ChordId key;
+            uint32_t size;
+            union {
+                uint8_t bytes[kInlineSize]; // size <= kInlineSize
+                uint64_t offset;            // position inside the arena
+            } value;
+            
+            bool operator< (const Entry &other) const { return key < other.key; }
+        };
+        
+        // sorted by key
+        std::vector<Entry> _entries;
+        // sorted by key - keys that aren't in _entries yet
+        std::vector<Entry> _recentEntries;
+        
+        // values that don't fit into an entry
+        std::vector<uint8_t> _arena;
+        // bytes of the arena that belong to removed or replaced values
+        size_t _arenaGarbage { 0 };
+        
+        // returns the entry with the key or nullptr
+        static Entry *findEntry (std::vector<Entry> &entries, ChordId key);
+        static const Entry *findEntry (const std::vector<Entry> &entries, ChordId key);
+        
+        // stores the value inside the entry or the arena
+        void storeValue (Entry *entry, const uint8_t *data, uint32_t size);
+        // marks the arena bytes of the value as unused
+        void releaseValue (const Entry &entry);
+        // returns a copy of the value
+        std::shared_ptr<uint8_t> copyValue (const Entry &entry) const;
+        
+        // removes the slice [from, to] of the sorted entries
+        void removeSlice (std::vector<Entry> &entries, ChordId from, ChordId to,
+                          std::vector<ChordDataItem> *removed);
+        
+        // merges the recent entries into the main array
+        void mergeRecentEntries ();
+        // drops the unused bytes of the arena if they are the majority
+        void compactArenaIfNeeded ();
+    };
+}
+
+#endif /* defined(__RGP__Chord__ChordDataStore__) */
@@ -0,0 +1,98 @@
+/*
+ ChordFrameReader.h
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGP__Chord__ChordFrameReader__
+#define __RGP__Chord__ChordFrameReader__
+
+#include <iostream>
+
+#include <vector>
+#include <memory>
+#include <functional>
+
+#include <rgp/ChordTypes.h>
+#include <rgp/ChordWire.h>
+#include <rgp/ChordBufferPool.h>
+
+namespace rgp {
+    
+    /**
+     @brief Splits the byte stream of one connection into messages.
+     @details Every message is an encoded ChordHeader (see ChordWire)
+     followed by dataSize bytes.
+     The reader only reads what is available (it never blocks a worker) and
+     keeps incomplete messages until the rest arrives, so it doesn't matter
+     how TCP segments the stream. Small messages are read in one go into a
+     read buffer, the data of large messages is read directly into a buffer
+     of the connection's buffer pool.
+     A reader must only be used by one thread at a time (the reactor
+     guarantees this for a socket).
+     */
+    class ChordFrameReader {
+        
+    public:
+        // called for every complete message
+        typedef std::function<void (ChordHeader header, std::shared_ptr<uint8_t> data)> ChordFrameHandler;
+        
+        // size of the read buffer
+        static const size_t kReadBufferSize { 16 * 1024 };
+        // messages with more data are treated as a broken connection
+        static const uint32_t kMaxDataSize { 64 * 1024 * 1024 };
+        
+        ChordFrameReader ();
+        
+        // reads all available data from the socket and calls the handler
+        // for every complete message
+        // returns false if the connection was closed, broken or malformed
+        // (f.e. a header of an unsupported protocol version)
+        bool readFrames (int socket, ChordFrameHandler handler);
+        
+    private:
+        std::vector<uint8_t> _readBuffer;
+        // unused bytes of the read buffer are [readPosition, readEnd)
+        size_t _readPosition { 0 };
+        size_t _readEnd { 0 };
+        
+        // message that is currently received
+        ChordHeader _header;
+        bool _headerComplete { false };
+        // bytes of a header that is split over several reads
+        uint8_t _headerBuffer[ChordWire::kMaxHeaderSize];
+        size_t _headerBytes { 0 };
+        std::shared_ptr<uint8_t> _data;
+        uint32_t _dataSize { 0 };
+        uint32_t _dataBytes { 0 };
+        
+        // buffers for the data of the messages
+        std::shared_ptr<ChordBufferPool> _bufferPool;
+        
+        // reads available data into the given memory
+        // returns the number of bytes, 0 if there is no data or -1 on error
+        ssize_t readAvailable (int socket, uint8_t *buffer, size_t size);
+    };
+}
+
+#endif /* defined(__RGP__Chord__ChordFrameReader__) */
@@ -0,0 +1,68 @@
+/*
+ ChordHash.h
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGP__Chord__ChordHash__
+#define __RGP__Chord__ChordHash__
+
+#include <iostream>
+
+#include <string>
+#include <memory>
+
+#include <rgp/ChordTypes.h>
+
+namespace rgp {
+    
+    /**
+     @brief Maps data and application keys to ids on the chord ring.
+     @details The key only depends on the bytes that are hashed, so every
+     node computes the same key for the same data. The 64 bit hash
+     (FNV-1a with a final mix) is folded to the size of ChordId.
+     */
+    class ChordHash {
+        
+    public:
+        // 64 bit hash of the given bytes
+        static uint64_t hash64 (const void *bytes, size_t length);
+        
+        // key for the given bytes
+        static ChordId keyForBytes (const void *bytes, size_t length);
+        
+        // key for an application key (f.e. a file name)
+        static ChordId keyForString (const std::string &string);
+        
+        // node id for the given address ("ip:port" or "ip:port#salt")
+        // the same address always gets the same id - a salt gives the node
+        // another id (f.e. for several virtual nodes behind one address)
+        static ChordId keyForNode (const std::string &ipAddress, uint16_t port, const std::string &salt = "");
+        
+        // key for serialized data (see ChordData)
+        // the content is hashed - including the data size
+        static ChordId keyForData (std::shared_ptr<uint8_t> data);
+    };
+}
+
+#endif /* defined(__RGP__Chord__ChordHash__) */
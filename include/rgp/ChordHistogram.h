@@ -0,0 +1,86 @@
+/*
+ ChordHistogram.h
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGP__Chord__ChordHistogram__
+#define __RGP__Chord__ChordHistogram__
+
+#include <iostream>
+
+#include <atomic>
+#include <cstdint>
+
+namespace rgp {
+    
+    /**
+     @brief Lock free histogram with log-linear buckets (like HdrHistogram).
+     @details Every power of two is split into kSubBucketCount buckets, so a
+     percentile is at most 1/kSubBucketCount (12.5 %) above the real value -
+     independent of the magnitude. Small values (< kSubBucketCount) are
+     exact. Recording is a few relaxed atomic increments.
+     */
+    class ChordHistogram {
+        
+    public:
+        // buckets per power of two (2^kSubBucketBits)
+        static const int kSubBucketBits { 3 };
+        static const int kSubBucketCount { 1 << kSubBucketBits };
+        // values need at most this many bits (larger values count as the largest one)
+        static const int kMaxValueBits { 40 };
+        static const int kBucketCount { kSubBucketCount * (kMaxValueBits - kSubBucketBits + 1) };
+        
+        ChordHistogram ();
+        
+        // counts the value
+        void record (uint64_t value);
+        
+        // number of recorded values
+        uint64_t count () const { return _count.load(std::memory_order_relaxed); }
+        
+        // average of the recorded values (0 if there are none)
+        double mean () const;
+        
+        // largest recorded value
+        uint64_t max () const { return _max.load(std::memory_order_relaxed); }
+        
+        // value that the given fraction (0 - 1) of the recorded values don't exceed
+        // (upper bound of its bucket, 0 if there are no values)
+        uint64_t valueAtPercentile (double fraction) const;
+        
+    private:
+        std::atomic<uint64_t> _buckets[kBucketCount];
+        std::atomic<uint64_t> _count;
+        std::atomic<uint64_t> _sum;
+        std::atomic<uint64_t> _max;
+        
+        // bucket that counts the value
+        static int bucketForValue (uint64_t value);
+        
+        // largest value of the bucket
+        static uint64_t highestValueOfBucket (int bucket);
+    };
+}
+
+#endif /* defined(__RGP__Chord__ChordHistogram__) */
@@ -0,0 +1,109 @@
+/*
+ ChordHost.h
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGP__Chord__ChordHost__
+#define __RGP__Chord__ChordHost__
+
+#include <iostream>
+
+#include <vector>
+#include <mutex>
+#include <memory>
+
+#include <rgp/Chord.h>
+#include <rgp/ChordTransport.h>
+
+namespace rgp {
+    
+    /**
+     @brief Runs several virtual nodes of one ring in one process.
+     @details Every virtual node has its own id (and range of the ring), but
+     all of them share the host's listening port, transport and data stores.
+     A connection is handed to the virtual node named in its identify message.
+     The weight is the number of virtual nodes - a machine with twice the
+     weight gets about twice the keys (and requests). More virtual nodes also
+     even out the range sizes of a ring with only a few machines.
+     */
+    class ChordHost {
+        
+    public:
+        // creates a new ring
+        // virtual node i gets the id ChordHash::keyForNode(ip, port, "salt#i")
+        // (the salt is optional - it is only needed to get other ids)
+        ChordHost (std::string ipAddress, uint16_t port, int weight, std::string salt = "");
+        // joins the ring of the given node
+        ChordHost (std::string ipAddress, uint16_t port, int weight, std::string c_ipAddress, uint16_t c_port,
+                   std::string salt = "");
+        ~ChordHost ();
+        
+        // maximum number of virtual nodes per host
+        static const int kMaxWeight { 256 };
+        
+        // all virtual nodes of this host
+        std::vector<std::shared_ptr<Chord>> virtualNodes ();
+        
+        // returns the virtual node with the given id
+        // returns nullptr if there is no such node
+        std::shared_ptr<Chord> virtualNodeWithId (ChordId nodeId);
+        
+        // number of data items stored by all virtual nodes
+        size_t dataCount () const { return _dataMap->size(); }
+        
+    private:
+        std::string _ipAddress;
+        uint16_t _port;
+        // part of the ids of the virtual nodes
+        std::string _salt;
+        
+        // shared by all virtual nodes
+        std::shared_ptr<ChordTransport> _transport { nullptr };
+        std::shared_ptr<ChordShardedDataStore> _dataMap;
+        std::shared_ptr<ChordShardedDataStore> _replicaMap;
+        
+        // we listen on our address
+        bool _listening { false };
+        
+        // the virtual nodes (the first one receives connections without target)
+        std::vector<std::shared_ptr<Chord>> _virtualNodes;
+        // protect virtualNodes
+        std::mutex _virtualNodes_mutex;
+        
+        // starts listening and opens the shared stores
+        void start ();
+        // creates weight virtual nodes with distinct ids (derived from the address)
+        // the first one joins the given node, the others join the first one
+        // (an empty c_ipAddress creates a new ring)
+        void createVirtualNodes (int weight, std::string c_ipAddress, uint16_t c_port);
+        
+        // waits for the identify message of an incomming connection (called by transport)
+        void acceptConnection (std::shared_ptr<ChordConnection> connection);
+        // passes the connection to the virtual node named in the identify message
+        void identifyConnection (std::shared_ptr<ChordConnection> connection, ChordHeader header,
+                                 std::shared_ptr<uint8_t> data);
+    };
+}
+
+#endif /* defined(__RGP__Chord__ChordHost__) */
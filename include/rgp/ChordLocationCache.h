@@ -0,0 +1,97 @@
+/*
+ ChordLocationCache.h
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGP__Chord__ChordLocationCache__
+#define __RGP__Chord__ChordLocationCache__
+
+#include <iostream>
+
+#include <map>
+#include <list>
+#include <mutex>
+
+#include <rgp/ChordTypes.h>
+
+namespace rgp {
+    
+    /**
+     @brief Remembers which node is responsible for which part of the ring.
+     @details If a lookup for a key returned a node, that node is responsible
+     for every key from the searched key up to its own id. The cache keeps
+     one such range per node (extended by later lookups), so gets and puts
+     for keys of known ranges can go straight to the responsible node.
+     The least recently used range is dropped if the cache is full.
+     The cache is thread safe.
+     */
+    class ChordLocationCache {
+        
+    public:
+        // number of cached ranges if not specified
+        static const size_t kDefaultCapacity { 4096 };
+        
+        ChordLocationCache (size_t capacity = kDefaultCapacity);
+        
+        // returns true and the cached responsible node if the key is known
+        bool find (ChordId key, ChordHeaderNode *node);
+        
+        // a lookup for the key returned the node
+        void insert (ChordId key, ChordHeaderNode node);
+        
+        // the node died or isn't responsible for its cached range anymore
+        void removeNode (ChordId nodeId);
+        
+        // a new node joined - the range that contains its id is wrong now
+        void nodeJoined (ChordId nodeId);
+        
+        // drops all ranges
+        void clear ();
+        
+    private:
+        struct Entry {
+            // first key of the range (the last key is the node id)
+            ChordId from;
+            ChordHeaderNode node;
+            // position inside the lru list
+            std::list<ChordId>::iterator lruPosition;
+        };
+        
+        size_t _capacity;
+        
+        // ranges by node id (last key of the range)
+        std::map<ChordId, Entry> _entries;
+        // node ids - most recently used first
+        std::list<ChordId> _lru;
+        
+        // protect entries and lru list
+        std::mutex _mutex;
+        
+        // returns the entry whose range may contain the key
+        // (the first node id >= key, wraps around zero)
+        std::map<ChordId, Entry>::iterator entryForKey (ChordId key);
+    };
+}
+
+#endif /* defined(__RGP__Chord__ChordLocationCache__) */
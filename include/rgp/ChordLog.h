@@ -0,0 +1,143 @@
+/*
+ ChordLog.h
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGP__Chord__ChordLog__
+#define __RGP__Chord__ChordLog__
+
+#include <iostream>
+
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+#include <rgp/ChordConfig.h>
+
+// most verbose level that is compiled in (generated by cmake)
+// messages above it are removed by the compiler
+// 0: errors, 1: warnings, 2: info, 3: verbose
+#ifndef RGPCHORD_LOG_LEVEL
+#error "RGPCHORD_LOG_LEVEL isn't defined - rgp/ChordConfig.h has to be generated by cmake"
+#endif
+
+namespace rgp {
+    
+    typedef enum : uint8_t {
+        ChordLogLevelError = 0,
+        ChordLogLevelWarning = 1,
+        ChordLogLevelInfo = 2,
+        ChordLogLevelVerbose = 3
+    } ChordLogLevel;
+    
+    /**
+     @brief Log of the library with a runtime level and an asynchronous sink.
+     @details Use the CHORD_LOG macros: the message is a stream expression
+     (f.e. CHORD_LOGV("search for key: " << key)) that is only evaluated
+     if its level is enabled - a disabled message doesn't format or
+     allocate anything. Enabled messages are queued in a ring buffer and
+     written to rgp::Log by a background thread, so the caller never
+     waits for the output. If the ring is full new messages are dropped
+     (and counted) instead of blocking the caller.
+     */
+    class ChordLog {
+        
+    public:
+        // number of messages the ring buffer holds
+        static const size_t kRingCapacity { 4096 };
+        
+        // the log of the process (queued messages are written on exit)
+        static ChordLog * sharedLog ();
+        
+        // most verbose level that is written (default ChordLogLevelWarning)
+        void setLevel (ChordLogLevel level) { _level.store(level, std::memory_order_relaxed); }
+        ChordLogLevel level () const { return static_cast<ChordLogLevel>(_level.load(std::memory_order_relaxed)); }
+        
+        // checks if messages of the level are written
+        bool isEnabled (ChordLogLevel level) const { return level <= _level.load(std::memory_order_relaxed); }
+        
+        // queues the message (use the CHORD_LOG macros)
+        void write (ChordLogLevel level, std::string message);
+        
+        // waits till all queued messages are written
+        void flush ();
+        
+        // number of messages that were dropped because the ring was full
+        uint64_t droppedMessages () const { return _droppedMessages.load(std::memory_order_relaxed); }
+        
+    private:
+        ChordLog ();
+        ~ChordLog ();
+        
+        std::atomic<uint8_t> _level { ChordLogLevelWarning };
+        
+        typedef struct {
+            ChordLogLevel level;
+            std::string message;
+        } ChordLogEntry;
+        
+        // queued messages (oldest at ringHead)
+        std::vector<ChordLogEntry> _ring;
+        size_t _ringHead { 0 };
+        size_t _ringCount { 0 };
+        // the writer is writing taken messages
+        bool _writing { false };
+        // protect ring
+        std::mutex _ring_mutex;
+        // signals the writer that there are new messages
+        std::condition_variable _ring_condition;
+        // signals flush that the ring is empty
+        std::condition_variable _flush_condition;
+        
+        std::atomic<uint64_t> _droppedMessages { 0 };
+        
+        // writes the queued messages
+        std::thread _writerThread;
+        
+        // method of writerThread
+        void runWriter ();
+    };
+}
+
+// logs the message if its level is compiled in and enabled
+// the message is only evaluated (and formatted) in that case
+#define CHORD_LOG(level, message) \
+    do { \
+        if ((level) <= RGPCHORD_LOG_LEVEL && rgp::ChordLog::sharedLog()->isEnabled(level)) { \
+            std::ostringstream chordLogStream; \
+            chordLogStream << message; \
+            rgp::ChordLog::sharedLog()->write((level), chordLogStream.str()); \
+        } \
+    } while (0)
+
+#define CHORD_LOGE(message) CHORD_LOG(rgp::ChordLogLevelError, message)
+#define CHORD_LOGW(message) CHORD_LOG(rgp::ChordLogLevelWarning, message)
+#define CHORD_LOGI(message) CHORD_LOG(rgp::ChordLogLevelInfo, message)
+#define CHORD_LOGV(message) CHORD_LOG(rgp::ChordLogLevelVerbose, message)
+
+#endif /* defined(__RGP__Chord__ChordLog__) */
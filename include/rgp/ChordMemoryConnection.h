@@ -0,0 +1,112 @@
+/*
+ ChordMemoryConnection.h
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGP__Chord__ChordMemoryConnection__
+#define __RGP__Chord__ChordMemoryConnection__
+
+#include <iostream>
+
+#include <deque>
+#include <mutex>
+#include <chrono>
+#include <memory>
+
+#include <rgp/ChordConnection.h>
+
+namespace rgp {
+    
+    // forward declaration
+    class ChordMemoryNetwork;
+    
+    /**
+     @brief One end of a connection of the simulated network.
+     @details Messages are copied and handed to the remote end after the
+     network's latency. Received messages are passed to the handler one at a
+     time by a worker of the network. The end of the connection is also
+     passed as message, so it arrives after all messages that were send before.
+     */
+    class ChordMemoryConnection : public ChordConnection, public std::enable_shared_from_this<ChordMemoryConnection> {
+        
+    public:
+        ChordMemoryConnection (std::shared_ptr<ChordMemoryNetwork> network, std::string localAddress,
+                               std::string remoteAddress);
+        
+        void send (ChordHeader header, std::shared_ptr<uint8_t> data, uint32_t dataSize) override;
+        void receive (ChordMessageHandler handler, ChordClosedHandler closedHandler) override;
+        void close () override;
+        
+        // connects this end to the other end
+        void setPeer (std::shared_ptr<ChordMemoryConnection> peer) { _peer = peer; }
+        
+        // addresses (ip:port) of both ends
+        std::string localAddress () const { return _localAddress; }
+        std::string remoteAddress () const { return _remoteAddress; }
+        
+        // the connection broke (an address failed)
+        // local: this end failed - it is closed without calling the handlers
+        // otherwise the remote end failed - the closed handler is called at once
+        void breakConnection (bool local);
+        
+    private:
+        // received message (or the end of the connection)
+        struct ChordMemoryMessage {
+            ChordHeader header;
+            std::shared_ptr<uint8_t> data;
+            bool closed;
+        };
+        
+        std::weak_ptr<ChordMemoryNetwork> _network;
+        std::weak_ptr<ChordMemoryConnection> _peer;
+        std::string _localAddress;
+        std::string _remoteAddress;
+        
+        // received messages that weren't passed to the handler yet
+        std::deque<ChordMemoryMessage> _inbox;
+        ChordMessageHandler _handler { nullptr };
+        ChordClosedHandler _closedHandler { nullptr };
+        // receive() was called
+        bool _receiving { false };
+        // a worker passes the messages of the inbox to the handler
+        bool _draining { false };
+        // this end was closed
+        bool _closed { false };
+        // arrival time of the last send message (messages don't overtake each other)
+        std::chrono::steady_clock::time_point _lastArrival;
+        // protect all members above
+        std::mutex _mutex;
+        
+        // a message of the remote end arrived (called by the network's scheduler)
+        void deliver (ChordMemoryMessage message);
+        // starts a worker for the inbox if needed (mutex has to be locked)
+        void startDraining (std::shared_ptr<ChordMemoryNetwork> network);
+        // passes the messages of the inbox to the handler (called by a worker)
+        void drain ();
+        // closes this end (mutex has to be locked) - returns false if it was already closed
+        bool closeLocked ();
+    };
+}
+
+#endif /* defined(__RGP__Chord__ChordMemoryConnection__) */
@@ -0,0 +1,176 @@
+/*
+ ChordMemoryNetwork.h
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGP__Chord__ChordMemoryNetwork__
+#define __RGP__Chord__ChordMemoryNetwork__
+
+#include <iostream>
+
+#include <map>
+#include <set>
+#include <queue>
+#include <vector>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <functional>
+#include <condition_variable>
+
+#include <rgp/ChordTypes.h>
+#include <rgp/ChordTransport.h>
+
+namespace rgp {
+    
+    // forward declaration
+    class ChordMemoryConnection;
+    
+    /**
+     @brief Simulated network that connects the nodes of one process.
+     @details Messages are passed in memory and arrive after the configured
+     latency (in order per connection). Addresses can be failed, which breaks
+     all of their connections and refuses new ones - like a crashed machine.
+     The handlers of all nodes are executed by the network's workers.
+     Has to be destroyed after all of its nodes (and not by one of its workers).
+     */
+    class ChordMemoryNetwork : public std::enable_shared_from_this<ChordMemoryNetwork> {
+        
+    public:
+        // number of worker threads if not specified
+        static const int kDefaultWorkerCount { 16 };
+        
+        ChordMemoryNetwork (int workerCount = kDefaultWorkerCount);
+        ~ChordMemoryNetwork ();
+        
+        // one way delay of every message: latency plus a random part of jitter
+        void setLatency (std::chrono::microseconds latency, std::chrono::microseconds jitter = std::chrono::microseconds(0));
+        
+        // a failed address can't be reached and can't reach anybody
+        // (its connections break at once)
+        void setFailed (std::string ipAddress, uint16_t port, bool failed);
+        bool isFailed (std::string ipAddress, uint16_t port);
+        
+        // number of messages of the given type that were received by a node
+        uint64_t deliveredMessages (ChordMessageType type) const;
+        // number of all received messages
+        uint64_t deliveredMessages () const;
+        // sets all message counters to 0
+        void resetCounters ();
+        
+        // accepts connections to the given address (called by ChordMemoryTransport)
+        // returns false if the address is already used
+        bool listen (std::string ipAddress, uint16_t port, ChordTransport::ChordAcceptHandler handler);
+        void stopListening (std::string ipAddress, uint16_t port);
+        
+        // connects the local address to the remote address (called by ChordMemoryTransport)
+        // returns nullptr if nobody listens on the remote address or one of them failed
+        std::shared_ptr<ChordConnection> connect (std::string localIpAddress, uint16_t localPort,
+                                                  std::string ipAddress, uint16_t port);
+        
+        // executes the task on one of the worker threads
+        void dispatch (std::function<void ()> task);
+        
+        // executes the task after the latency (on the scheduler thread)
+        // tasks are executed in the order of their time (then in the order they were scheduled)
+        void schedule (std::chrono::steady_clock::time_point time, std::function<void ()> task);
+        
+        // time a message that is send now arrives
+        std::chrono::steady_clock::time_point arrivalTime ();
+        
+        // counts a received message (called by ChordMemoryConnection)
+        void countDelivered (ChordMessageType type);
+        
+        // forgets a closed connection (called by ChordMemoryConnection)
+        void removeConnection (std::shared_ptr<ChordMemoryConnection> connection);
+        
+    private:
+        // task of the scheduler
+        struct ChordScheduledTask {
+            std::chrono::steady_clock::time_point time;
+            uint64_t sequence;
+            std::function<void ()> task;
+            
+            // earliest task first (priority_queue returns the biggest element)
+            bool operator< (const ChordScheduledTask &other) const {
+                return time != other.time ? time > other.time : sequence > other.sequence;
+            }
+        };
+        
+        // accept handler of every listening address (ip:port)
+        std::map<std::string, ChordTransport::ChordAcceptHandler> _listeners;
+        // failed addresses (ip:port)
+        std::set<std::string> _failedAddresses;
+        // all open connection endpoints (the network keeps them alive till they are closed)
+        std::set<std::shared_ptr<ChordMemoryConnection>> _connections;
+        // protect listeners, failedAddresses and connections
+        std::mutex _network_mutex;
+        
+        // latency and jitter in microseconds
+        std::atomic<int64_t> _latency { 0 };
+        std::atomic<int64_t> _jitter { 0 };
+        // random part of the latency
+        std::mt19937 _random;
+        std::mutex _random_mutex;
+        
+        // received messages of every type
+        std::atomic<uint64_t> _deliveredMessages[256];
+        
+        // tasks waiting for a worker
+        std::queue<std::function<void ()>> _tasks;
+        // protect tasks
+        std::mutex _tasks_mutex;
+        // signals workers that there are new tasks
+        std::condition_variable _tasks_condition;
+        // threads that execute the tasks
+        std::vector<std::thread> _workerThreads;
+        
+        // tasks waiting for their time
+        std::priority_queue<ChordScheduledTask> _scheduledTasks;
+        // order of tasks with the same time
+        uint64_t _nextSequence { 0 };
+        // protect scheduledTasks and nextSequence
+        std::mutex _scheduledTasks_mutex;
+        // signals the scheduler that there is a new task
+        std::condition_variable _scheduledTasks_condition;
+        // thread that executes the scheduled tasks
+        std::thread _schedulerThread;
+        
+        // set this true to stop all threads
+        std::atomic<bool> _stop { false };
+        
+        // key of an address
+        static std::string addressKey (std::string ipAddress, uint16_t port);
+        
+        // method of workerThreads
+        void runWorker ();
+        // method of schedulerThread
+        void runScheduler ();
+    };
+}
+
+#endif /* defined(__RGP__Chord__ChordMemoryNetwork__) */
@@ -0,0 +1,64 @@
+/*
+ ChordMemoryTransport.h
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGP__Chord__ChordMemoryTransport__
+#define __RGP__Chord__ChordMemoryTransport__
+
+#include <iostream>
+
+#include <memory>
+
+#include <rgp/ChordTransport.h>
+#include <rgp/ChordMemoryNetwork.h>
+
+namespace rgp {
+    
+    /**
+     @brief Transport of one node in a simulated network (ChordMemoryNetwork).
+     @details Every node gets its own transport, so the network knows from
+     which address a connection comes.
+     */
+    class ChordMemoryTransport : public ChordTransport {
+        
+    public:
+        ChordMemoryTransport (std::shared_ptr<ChordMemoryNetwork> network, std::string ipAddress, uint16_t port);
+        
+        bool listen (std::string ipAddress, uint16_t port, ChordAcceptHandler handler) override;
+        void stopListening (std::string ipAddress, uint16_t port) override;
+        std::shared_ptr<ChordConnection> connect (std::string ipAddress, uint16_t port) override;
+        void dispatch (std::function<void ()> task) override;
+        
+        std::shared_ptr<ChordMemoryNetwork> network () const { return _network; }
+        
+    private:
+        std::shared_ptr<ChordMemoryNetwork> _network;
+        // address of the node
+        std::string _ipAddress;
+        uint16_t _port;
+    };
+}
+
+#endif /* defined(__RGP__Chord__ChordMemoryTransport__) */
@@ -0,0 +1,113 @@
+/*
+ ChordMetrics.h
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGP__Chord__ChordMetrics__
+#define __RGP__Chord__ChordMetrics__
+
+#include <iostream>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+#include <rgp/ChordTypes.h>
+#include <rgp/ChordCounter.h>
+#include <rgp/ChordHistogram.h>
+
+namespace rgp {
+    
+    /**
+     @brief Counters and latency histograms of the hot paths of one node.
+     @details Recording doesn't lock (see ChordCounter and ChordHistogram),
+     so every message can be counted. Durations are recorded in
+     microseconds. snapshot() returns all values as text, one value per
+     line: name{labels} value
+     */
+    class ChordMetrics {
+        
+    public:
+        // number of message types that can be counted (ChordMessageType values are below)
+        static const int kMessageTypeCount { 32 };
+        
+        ChordMetrics ();
+        ~ChordMetrics ();
+        
+        // a message was sent / received (dataSize: size of its data without the header)
+        void messageSent (ChordMessageType type, uint64_t dataSize);
+        void messageReceived (ChordMessageType type, uint64_t dataSize);
+        
+        // a request was answered (duration: from receiving it till its response was sent)
+        void requestHandled (ChordMessageType type, std::chrono::steady_clock::duration duration);
+        
+        // a lookup of this node finished
+        void lookupFinished (std::chrono::steady_clock::duration duration, bool failed);
+        // number of nodes a lookup of this node asked (0: resolved locally)
+        void lookupRouted (int hops) { _lookupHops.record(hops); }
+        
+        // a recursive search was answered by us / forwarded to the next node
+        void searchResolved () { _searchesResolved.add(); }
+        void searchForwarded () { _searchesForwarded.add(); }
+        
+        // one round of the stabilize protocol finished
+        void stabilizeRoundFinished (std::chrono::steady_clock::duration duration);
+        
+        // all values as text (labels are added to every line, f.e. node="42")
+        std::string snapshot (std::string labels) const;
+        
+        // name of the message type inside the snapshot (f.e. "search")
+        static const char * nameForMessageType (ChordMessageType type);
+        
+    private:
+        ChordCounter _messagesSent[kMessageTypeCount];
+        ChordCounter _messagesReceived[kMessageTypeCount];
+        ChordCounter _bytesSent;
+        ChordCounter _bytesReceived;
+        
+        // handling time of the requests per message type
+        // (created on first use - most types are responses that aren't handled)
+        std::atomic<ChordHistogram *> _requestLatencies[kMessageTypeCount];
+        
+        ChordHistogram _lookupLatency;
+        ChordHistogram _lookupHops;
+        ChordCounter _failedLookups;
+        
+        ChordCounter _searchesResolved;
+        ChordCounter _searchesForwarded;
+        
+        ChordHistogram _stabilizeRoundDuration;
+        
+        // histogram of the request type (creates it if needed)
+        ChordHistogram * requestLatency (ChordMessageType type);
+        
+        // index of the type inside the arrays (the last index counts unknown types)
+        static int indexForType (ChordMessageType type);
+        
+        // appends the lines of a histogram
+        static void appendHistogram (std::string *text, std::string name, std::string labels, const ChordHistogram &histogram);
+    };
+}
+
+#endif /* defined(__RGP__Chord__ChordMetrics__) */
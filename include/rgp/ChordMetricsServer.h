@@ -0,0 +1,79 @@
+/*
+ ChordMetricsServer.h
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGP__Chord__ChordMetricsServer__
+#define __RGP__Chord__ChordMetricsServer__
+
+#include <iostream>
+
+#include <string>
+#include <thread>
+#include <atomic>
+#include <functional>
+
+namespace rgp {
+    
+    /**
+     @brief Admin socket that serves the metrics of a running node.
+     @details Listens on a unix domain socket. Every client gets one
+     snapshot and is disconnected, so the metrics can be read with
+     f.e. "socat - UNIX-CONNECT:/path/to/socket" without touching the
+     Chord protocol port.
+     */
+    class ChordMetricsServer {
+        
+    public:
+        // returns the text that is sent to a client
+        typedef std::function<std::string ()> ChordMetricsProvider;
+        
+        ChordMetricsServer (std::string socketPath, ChordMetricsProvider provider);
+        ~ChordMetricsServer ();
+        
+        // binds the socket and starts serving (false on error)
+        bool start ();
+        
+    private:
+        std::string _socketPath;
+        ChordMetricsProvider _provider;
+        
+        // listening unix socket
+        int _listenSocket { -1 };
+        // used to wake up the server thread on shutdown
+        int _wakeupSocket { -1 };
+        
+        // thread that accepts the clients
+        std::thread _serverThread;
+        // set this true to stop the thread
+        std::atomic<bool> _stop { false };
+        
+        // method of serverThread
+        void runServer ();
+        // sends the snapshot to the client and closes it
+        void serveClient (int socket);
+    };
+}
+
+#endif /* defined(__RGP__Chord__ChordMetricsServer__) */
@@ -29,34 +29,47 @@
 
 #include <iostream>
 
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <chrono>
+
 #include <rgp/Chord>
 
 namespace rgp {
     
     // forward declaration
     class Chord;
+    class ChordConnection;
+    struct ChordTransfer;
     
-    class ChordNode {
+    class ChordNode : public std::enable_shared_from_this<ChordNode> {
         
     public:
         // Constructor
         // Node ID, IP-Address, Port, associated Chord
+        // (the chord may already be expired while it is destroyed)
         ChordNode (ChordId node, std::string ip, uint16_t port,
-                   std::shared_ptr<Chord> chord);
+                   std::weak_ptr<Chord> chord);
         // Destructor
         ~ChordNode ();
         
+        // seconds to wait for the response of a request
+        static const int kRequestTimeoutSeconds { 10 };
+        
+        // maximum size of one batch of a data transfer
+        static const uint32_t kTransferBatchSize { 64 * 1024 };
+        // number of batches of a data transfer that may wait for their ack
+        static const int kTransferWindow { 4 };
+        
         // getter
         ChordId getNodeID () const { return this->_nodeID; }
         std::string getIPAddress () const { return this->_ipAddress; }
         int getPort () const { return this->_port; }
-        int getReceiveSocket () const { return this->_receiveSocket; }
-        int getSendSocket () const { return this->_sendSocket; }
         
-        // setter
-        void setSendSocket (int socket) { this->_sendSocket = socket; }
-        // sets new receive socket and starts listening thread
-        void setReceiveSocket (int socket);
+        // sets the connection the remote node opened to us and handles its requests
+        void setReceiveConnection (std::shared_ptr<ChordConnection> connection);
         
         // returns this node as struct ChordHeaderNode
         ChordHeaderNode chordNode () const;
@@ -74,9 +87,14 @@ namespace rgp {
         // tell's remote node that i'm his predecessor
         // this method is used by stablilization
         // returns node that the remote node returns
+        // successorList is filled with the successor list of the remote node
         // throws ChordConnectionException on error
         ChordHeaderNode getPredecessorFromRemoteNode
-        (std::shared_ptr<ChordNode> ownNode);
+        (std::shared_ptr<ChordNode> ownNode, std::vector<ChordHeaderNode> *successorList = nullptr);
+        
+        // tell's remote node (our old predecessor) that the node joined between us
+        // the remote node stabilizes right away instead of waiting for its next round (the answer is ignored)
+        void suggestSuccessorAsync (ChordHeaderNode node);
         
         // search for a key (or a node)
         // throws ChordConnectionException on error
@@ -89,54 +107,175 @@ namespace rgp {
         
         // sends the data to the remote node to add it there locally
         // returns true on success
-        bool addData (std::shared_ptr<uint8_t> data);
+        bool addData (ChordId key, std::shared_ptr<uint8_t> data);
+        
+        // asynchronous versions of searchForKey, requestDataForKey and addData
+        // they return immediately, the handler is called (by a transport worker)
+        // as soon as the response arrives or the request failed
+        void searchForKeyAsync (ChordId key, ChordLookupHandler handler);
+        // traced search (traceId 0: untraced) - hops is the position of the remote node on the path
+        // the handler gets the requests of the route (this one included)
+        // and the path of the search (the remote node first)
+        void searchForKeyAsync (ChordId key, uint32_t traceId, uint8_t hops, ChordTracedLookupHandler handler);
+        void requestDataForKeyAsync (ChordId key, ChordGetHandler handler);
+        void addDataAsync (ChordId key, std::shared_ptr<uint8_t> data, ChordPutHandler handler);
+        
+        // sends a copy of the data to the remote node (replication)
+        void addReplicaAsync (ChordId key, std::shared_ptr<uint8_t> data, ChordPutHandler handler);
+        
+        // transfers all items to the remote node (f.e. key range handoff)
+        // the items are send in batches, up to kTransferWindow batches are
+        // on the way at the same time; added is false if any item failed
+        void transferDataAsync (std::shared_ptr<std::vector<ChordDataItem>> items, ChordPutHandler handler);
+        // transfers copies of all items to the remote node (replication, batched like transferDataAsync)
+        void transferReplicasAsync (std::shared_ptr<std::vector<ChordDataItem>> items, ChordPutHandler handler);
+        
+        // receives the data of all keys with one request
+        void requestDataForKeysAsync (std::vector<ChordId> keys, ChordMultiGetHandler handler);
+        
+        // one step of an iterative search: asks the remote node for the node
+        // that is responsible for the key or for up to count nodes closer to it
+        void searchNextHopsAsync (ChordId key, uint8_t count, ChordNextHopsHandler handler);
+        
+        // fails all requests that wait longer than kRequestTimeoutSeconds
+        // for their response (called periodically by stabilize)
+        void failExpiredRequests ();
         
         // returns a describing string of the instance (node id, ip, ...)
         std::string description () const;
         
+        // traffic with the remote node (data without headers)
+        uint64_t messagesSent () const { return _messagesSent.load(std::memory_order_relaxed); }
+        uint64_t messagesReceived () const { return _messagesReceived.load(std::memory_order_relaxed); }
+        uint64_t bytesSent () const { return _bytesSent.load(std::memory_order_relaxed); }
+        uint64_t bytesReceived () const { return _bytesReceived.load(std::memory_order_relaxed); }
+        
     private:
         ChordId _nodeID { 0 };
         std::string _ipAddress { "" };
         uint16_t _port { 0 };
         // request from the other side are incomming here
-        int _receiveSocket { -1 };
-        // requests are send with this socket
-        int _sendSocket { -1 };
+        std::shared_ptr<ChordConnection> _receiveConnection { nullptr };
+        // requests are send with this connection
+        std::shared_ptr<ChordConnection> _sendConnection { nullptr };
         
-        // make send socket thread-safe
+        // make send connection thread-safe
         // (several threads will use this:
         // stabilize() thread
         // TUI thread (for search and add data)
         // receiveHandler of other nodes (for search from other nodes etc.)
-        std::mutex _sendSocket_mutex;
+        // the connection serializes the messages itself - the lock only protects the pointer
+        std::mutex _sendConnection_mutex;
+        
+        // id of the next request
+        std::atomic<uint32_t> _nextRequestId { 1 };
+        // request that waits for its response
+        typedef struct {
+            ChordResponseHandler handler;
+            // the request fails if there is no response till then
+            std::chrono::steady_clock::time_point deadline;
+        } ChordPendingRequest;
+        
+        // requests that wait for their response
+        std::map<uint32_t, ChordPendingRequest> _pendingRequests;
+        // protect pendingRequests
+        std::mutex _pendingRequests_mutex;
         
-        // thread to handle incomming requests
-        std::thread _requestHandlerThread {};
-        // determines if the requestHandlerThread should exit
-        std::atomic<bool> _stopRequestHandlerThread { false };
+        // make receive connection thread-safe
+        // (responses are send by several workers)
+        std::mutex _receiveConnection_mutex;
         
         // associated Chord
         std::weak_ptr<Chord> _chord;
         
-        // handle incomming data (heartbeat, search, ...)
-        void handleRequests ();
+        // traffic with the remote node
+        std::atomic<uint64_t> _messagesSent { 0 };
+        std::atomic<uint64_t> _messagesReceived { 0 };
+        std::atomic<uint64_t> _bytesSent { 0 };
+        std::atomic<uint64_t> _bytesReceived { 0 };
         
-        // sends response to remote node
+        // counts a message in our metrics and in the metrics of the chord
+        void messageSent (std::shared_ptr<Chord> chord, ChordMessageType type, uint32_t dataSize);
+        void messageReceived (std::shared_ptr<Chord> chord, ChordMessageType type, uint32_t dataSize);
+        
+        // stops handling requests and closes the receive connection
+        void closeReceiveConnection ();
+        
+        // a connection was closed by the remote node (called by the transport)
+        // ignored if it was already replaced by a newer connection
+        void sendConnectionClosed (std::shared_ptr<ChordConnection> connection);
+        void receiveConnectionClosed (std::shared_ptr<ChordConnection> connection);
+        
+        // sends response to remote node (over the connection of the request)
+        // traceId: the response of a traced request is traced as well (0: untraced)
         // throws ChordConnectionException on error
-        void sendResponse (ChordMessageType type, std::shared_ptr<uint8_t> data,
-                           ssize_t dataSize);
+        void sendResponse (std::shared_ptr<ChordConnection> connection, uint32_t requestId, ChordMessageType type,
+                           std::shared_ptr<uint8_t> data, ssize_t dataSize, uint32_t traceId = 0, uint8_t hops = 0);
+        // answers a malformed request without data (the sender fails right away
+        // instead of waiting for the request timeout)
+        void sendEmptyResponse (std::shared_ptr<ChordConnection> connection, uint32_t requestId, ChordMessageType type);
         
         // sends request to remote node
+        // the handler is called (by a transport worker) when the response arrives
+        // if there is no handler no response is expected
+        // traceId / hops: trace of the header (0: untraced)
+        // returns the id of the request
         // throws ChordConnectionException on error
-        void sendRequest (ChordMessageType type, std::shared_ptr<uint8_t> data,
-                          ssize_t dataSize);
+        uint32_t sendRequest (ChordMessageType type, std::shared_ptr<uint8_t> data,
+                          ssize_t dataSize, ChordResponseHandler handler, uint32_t traceId = 0, uint8_t hops = 0);
         
-        // receives response from remote node
-        // returns pointer to reveived data or nullptr if
-        // there was no received data
-        // throws ChordConnectionException on error
-        std::shared_ptr<uint8_t> recvResponse (std::shared_ptr<ChordMessageType> type,
-                                               std::shared_ptr<ssize_t> dataSize);
+        // sends request to remote node and waits for the response
+        // throws ChordConnectionException on error or timeout
+        ChordResponse request (ChordMessageType type, std::shared_ptr<uint8_t> data,
+                               ssize_t dataSize);
+        
+        // sends the data with the given message type (add data or add replica)
+        void sendDataAsync (ChordMessageType type, ChordId key, std::shared_ptr<uint8_t> data, ChordPutHandler handler);
+        
+        // sends the next batches of the transfer (as long as the window allows)
+        void continueTransfer (std::shared_ptr<ChordTransfer> transfer);
+        
+        // a batch contains the item count followed by key + data of every item
+        static std::shared_ptr<uint8_t> batchFromItems (const std::vector<ChordDataItem> &items,
+                                                        size_t first, size_t last, uint32_t *size);
+        // the items share the buffer of the batch
+        // returns false if the batch is malformed
+        static bool itemsFromBatch (std::shared_ptr<uint8_t> batch, uint32_t size,
+                                    std::vector<ChordDataItem> *items);
+        
+        // the data of add messages is preceded by its key
+        static std::shared_ptr<uint8_t> keyedData (ChordId key, std::shared_ptr<uint8_t> data, uint32_t *size);
+        // splits the data of add messages into key and data
+        // returns false if the message is malformed
+        static bool keyAndDataFromKeyedData (std::shared_ptr<uint8_t> keyedData, uint32_t size,
+                                             ChordId *key, std::shared_ptr<uint8_t> *data);
+        
+        // creates the results from the responses
+        // throws ChordConnectionException if the response is unexpected
+        // path: filled with the path of a traced search (nullptr: the response must not contain one)
+        // hops: filled with the search requests the remote node sent (0 if the response doesn't tell)
+        static ChordHeaderNode nodeFromSearchResponse (ChordResponse response, std::vector<ChordTraceHop> *path = nullptr,
+                                                       uint8_t *hops = nullptr);
+        static std::shared_ptr<uint8_t> dataFromDataResponse (ChordResponse response);
+        static bool resultFromAddResponse (ChordResponse response);
+        static bool itemsFromMultiResponse (ChordResponse response, std::vector<ChordDataItem> *items);
+        static bool nextHopsFromResponse (ChordResponse response, std::vector<ChordHeaderNode> *nodes);
+        
+        // executes the handler of the request message (heartbeat, search, ...)
+        // the response is send over the connection the request came from
+        // receivedAt: arrival of the request (for the request latency metrics)
+        void handleMessage (std::shared_ptr<ChordConnection> connection, ChordHeader header, std::shared_ptr<uint8_t> data,
+                            std::chrono::steady_clock::time_point receivedAt);
+        
+        // records the time the request took till its response was sent
+        void requestHandled (ChordMessageType type, std::chrono::steady_clock::time_point receivedAt);
+        
+        // passes a response to its waiting request
+        // called for every message received on the send connection
+        void handleResponse (ChordHeader header, std::shared_ptr<uint8_t> data);
+        
+        // all pending requests will fail with the given reason
+        void failPendingRequests (std::string reason);
     };
 }
 
@@ -0,0 +1,120 @@
+/*
+ ChordReactor.h
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGP__Chord__ChordReactor__
+#define __RGP__Chord__ChordReactor__
+
+#include <iostream>
+#include <cstdint>
+
+#include <map>
+#include <queue>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+
+namespace rgp {
+    
+    /**
+     @brief Event loop that owns all sockets of a Chord instance.
+     @details One thread waits (epoll) for readable sockets and hands them to
+     a fixed number of worker threads. A socket is disarmed while its
+     handler runs, so every socket is only handled by one worker at a time
+     and the number of threads doesn't grow with the number of peers.
+     */
+    class ChordReactor {
+        
+    public:
+        // called by a worker if the socket is readable
+        // return true to wait for the next data on this socket
+        typedef std::function<bool ()> ChordReadHandler;
+        
+        // number of worker threads if not specified
+        static const int kDefaultWorkerCount { 16 };
+        
+        ChordReactor (int workerCount = kDefaultWorkerCount);
+        ~ChordReactor ();
+        
+        // watch the socket and call handler (on a worker) if there is data
+        // replaces the handler if the socket is already watched
+        void addSocket (int socket, ChordReadHandler handler);
+        
+        // stops watching the socket (the socket will not be closed)
+        void removeSocket (int socket);
+        
+        // executes the task on one of the worker threads
+        void dispatch (std::function<void ()> task);
+        
+    private:
+        // epoll instance
+        int _epollSocket { -1 };
+        // used to wake up the event loop on shutdown
+        int _wakeupSocket { -1 };
+        
+        // handler of a watched socket
+        // the generation tells events of a closed and reused socket apart
+        struct ChordRegistration {
+            ChordReadHandler handler;
+            uint32_t generation;
+        };
+        
+        // all watched sockets and their handlers
+        std::map<int, ChordRegistration> _handlers;
+        // generation of the next registration (0 is the wakeup socket)
+        uint32_t _nextGeneration { 1 };
+        // protect handlers and nextGeneration
+        std::mutex _handlers_mutex;
+        
+        // tasks waiting for a worker
+        std::queue<std::function<void ()>> _tasks;
+        // protect tasks
+        std::mutex _tasks_mutex;
+        // signals workers that there are new tasks
+        std::condition_variable _tasks_condition;
+        
+        // thread that waits for socket events
+        std::thread _eventThread;
+        // threads that execute the handlers
+        std::vector<std::thread> _workerThreads;
+        // set this true to stop all threads
+        std::atomic<bool> _stop { false };
+        
+        // method of eventThread
+        void runEventLoop ();
+        // method of workerThreads
+        void runWorker ();
+        // executes the handler of the socket and arms the socket again
+        // does nothing if the socket was registered again meanwhile
+        void handleSocket (int socket, uint32_t generation);
+        // wait for the next event on the socket (handlers_mutex has to be locked)
+        void armSocket (int socket, uint32_t generation, bool add);
+    };
+}
+
+#endif /* defined(__RGP__Chord__ChordReactor__) */
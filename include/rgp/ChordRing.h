@@ -0,0 +1,126 @@
+/*
+ ChordRing.h
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGP__Chord__ChordRing__
+#define __RGP__Chord__ChordRing__
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace rgp {
+    
+    /**
+     @brief Arithmetic on the identifier ring.
+     @details IdType is the unsigned integer that holds an id, KeyLength the
+     number of used bits (m). All ring arithmetic is constexpr, so it is
+     folded by the compiler and costs the same for every width.
+     */
+    template <typename IdType, int KeyLength>
+    class ChordRing {
+        
+        static_assert(std::is_unsigned<IdType>::value, "ChordRing: id type must be unsigned");
+        static_assert(KeyLength > 0 && KeyLength <= static_cast<int>(sizeof(IdType) * 8),
+                      "ChordRing: key length doesn't fit into the id type");
+        
+    public:
+        // key lenght (exponent m of the formular)
+        static constexpr int kKeyLength { KeyLength };
+        
+        // highest possible id (2^m - 1)
+        static constexpr IdType highestId ()
+        {
+            return static_cast<IdType>(static_cast<IdType>(~static_cast<IdType>(0)) >> (sizeof(IdType) * 8 - KeyLength));
+        }
+        
+        // distance of finger i to its node (2^i)
+        static constexpr IdType fingerOffset (int finger)
+        {
+            return static_cast<IdType>(static_cast<IdType>(1) << finger);
+        }
+        
+        // first id that finger i of the node is responsible for (id + 2^i)
+        static constexpr IdType fingerStart (IdType id, int finger)
+        {
+            return static_cast<IdType>((id + fingerOffset(finger)) & highestId());
+        }
+        
+        // clockwise distance from one id to another
+        static constexpr IdType distance (IdType from, IdType to)
+        {
+            return static_cast<IdType>((to - from) & highestId());
+        }
+        
+        // checks if key is inside the ring interval [from, to]
+        static constexpr bool isInClosedRange (IdType key, IdType from, IdType to)
+        {
+            return from > to ? (key >= from || key <= to) : (key >= from && key <= to);
+        }
+        
+        // checks if key is inside the ring interval (from, to]
+        static constexpr bool isInRange (IdType key, IdType from, IdType to)
+        {
+            return from >= to ? (key > from || key <= to) : (key > from && key <= to);
+        }
+        
+        // checks if key is inside the ring interval (from, to)
+        static constexpr bool isBetween (IdType key, IdType from, IdType to)
+        {
+            return from >= to ? (key > from || key < to) : (key > from && key < to);
+        }
+        
+        // converts an id to network byte order (big endian)
+        static IdType toNetwork (IdType id)
+        {
+            uint8_t bytes[sizeof(IdType)];
+            for (size_t i = 0; i < sizeof(IdType); i++) {
+                bytes[i] = static_cast<uint8_t>(id >> (8 * (sizeof(IdType) - 1 - i)));
+            }
+            
+            IdType networkId;
+            memcpy(&networkId, bytes, sizeof(IdType));
+            return networkId;
+        }
+        
+        // converts an id from network byte order (big endian)
+        static IdType fromNetwork (IdType networkId)
+        {
+            uint8_t bytes[sizeof(IdType)];
+            memcpy(bytes, &networkId, sizeof(IdType));
+            
+            IdType id { 0 };
+            for (size_t i = 0; i < sizeof(IdType); i++) {
+                id = static_cast<IdType>((id << 8) | bytes[i]);
+            }
+            return id;
+        }
+    };
+    
+    template <typename IdType, int KeyLength>
+    constexpr int ChordRing<IdType, KeyLength>::kKeyLength;
+}
+
+#endif /* defined(__RGP__Chord__ChordRing__) */
@@ -0,0 +1,89 @@
+/*
+ ChordShardedDataStore.h
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGP__Chord__ChordShardedDataStore__
+#define __RGP__Chord__ChordShardedDataStore__
+
+#include <iostream>
+
+#include <vector>
+#include <memory>
+#include <pthread.h>
+
+#include <rgp/ChordTypes.h>
+#include <rgp/ChordDataStore.h>
+
+namespace rgp {
+    
+    /**
+     @brief Thread safe local data, split into shards by the highest key bits.
+     @details Every shard is a ChordDataStore with its own read-write lock.
+     Gets only take the read lock of one shard, so they run in parallel,
+     and a range operation locks one shard after the other - gets for keys
+     of other shards are never blocked by a key transfer.
+     */
+    class ChordShardedDataStore {
+        
+    public:
+        // number of shards = 2^kShardBits
+        static const int kShardBits { 6 };
+        static const int kShardCount { 1 << kShardBits };
+        
+        ChordShardedDataStore ();
+        ~ChordShardedDataStore ();
+        
+        ChordShardedDataStore (const ChordShardedDataStore &) = delete;
+        ChordShardedDataStore &operator= (const ChordShardedDataStore &) = delete;
+        
+        // see ChordDataStore
+        void put (ChordId key, std::shared_ptr<uint8_t> data);
+        std::shared_ptr<uint8_t> get (ChordId key);
+        bool remove (ChordId key);
+        
+        // removes all data inside the ring interval [from, to]
+        // every shard is updated atomically, but not the whole range
+        void removeRange (ChordId from, ChordId to, std::vector<ChordDataItem> *removed);
+        
+        // number of stored keys
+        size_t size ();
+        
+    private:
+        struct Shard {
+            ChordDataStore store;
+            pthread_rwlock_t lock;
+        };
+        
+        Shard _shards[kShardCount];
+        
+        // shard of the key
+        static int shardIndex (ChordId key);
+        
+        // removes the interval [from, to] (from <= to) from the shards it covers
+        void removeSlice (ChordId from, ChordId to, std::vector<ChordDataItem> *removed);
+    };
+}
+
+#endif /* defined(__RGP__Chord__ChordShardedDataStore__) */
@@ -0,0 +1,190 @@
+/*
+ ChordSimulator.h
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGP__Chord__ChordSimulator__
+#define __RGP__Chord__ChordSimulator__
+
+#include <iostream>
+
+#include <map>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <memory>
+
+#include <rgp/Chord.h>
+#include <rgp/ChordMemoryNetwork.h>
+
+namespace rgp {
+    
+    /**
+     @brief Runs a whole ring in one process (on a ChordMemoryNetwork).
+     @details Every node is a normal Chord instance with its own address,
+     only the transport is simulated. Used to measure convergence time and
+     hop counts of many nodes with simulated latency and failures.
+     The ring can also run on real TCP connections over the loopback
+     interface (f.e. for benchmarks of the socket transport).
+     */
+    class ChordSimulator {
+        
+    public:
+        // network the nodes communicate over
+        typedef enum : uint8_t {
+            // ChordMemoryNetwork - every node gets its own ip address
+            ChordSimulatorNetworkMemory = 0,
+            // TCP on 127.0.0.1 - every node gets its own port
+            ChordSimulatorNetworkLoopback = 1
+        } ChordSimulatorNetwork;
+        
+        // result of measureLookups
+        struct ChordLookupStatistics {
+            // number of lookups
+            int lookups { 0 };
+            // lookups that failed (error or timeout)
+            int failedLookups { 0 };
+            // lookups that returned a node that isn't responsible for the key
+            int wrongLookups { 0 };
+            // hops of the routes (from the searching node to the responsible node)
+            double averageHops { 0 };
+            int maxHops { 0 };
+            // duration of the successful lookups
+            double averageMilliseconds { 0 };
+        };
+        
+        // port of all simulated nodes (every node gets its own ip address)
+        static const uint16_t kPort { 4000 };
+        // port of the first node on the loopback network (the next nodes use the following ports)
+        static const uint16_t kLoopbackPort { 20000 };
+        // number of nodes that join at the same time
+        static const int kDefaultJoinBatchSize { 16 };
+        
+        ChordSimulator (int workerCount = ChordMemoryNetwork::kDefaultWorkerCount,
+                        ChordSimulatorNetwork network = ChordSimulatorNetworkMemory);
+        ~ChordSimulator ();
+        
+        // the simulated network (latency, failures and message counters)
+        // nullptr on the loopback network
+        std::shared_ptr<ChordMemoryNetwork> network () const { return _network; }
+        
+        // stabilize interval of the nodes that are added afterwards (see Chord::setStabilizeInterval)
+        void setStabilizeInterval (std::chrono::milliseconds minimum, std::chrono::milliseconds maximum);
+        
+        // lookup mode of the nodes that are added afterwards
+        void setLookupMode (ChordLookupMode mode, int parallelism = 1);
+        
+        // virtual nodes per host of the nodes that are added afterwards
+        // (like ChordHost the virtual nodes of a host share its data stores -
+        //  but every virtual node gets its own simulated address)
+        void setVirtualNodes (int weight);
+        
+        // replication factor of the nodes that are added afterwards (see Chord::setReplicationFactor)
+        void setReplicationFactor (int replicationFactor);
+        
+        // starts count new nodes - the first node creates the ring, the others
+        // join a random running node (batchSize of them at the same time)
+        void addNodes (int count, int batchSize = kDefaultJoinBatchSize);
+        
+        // all running (not failed) nodes ordered by their id
+        std::vector<std::shared_ptr<Chord>> nodes ();
+        
+        // fails the fraction of the running nodes (chosen randomly)
+        // their addresses can't be reached anymore - like crashed machines
+        // (on the loopback network the nodes are stopped and close their connections)
+        // returns the number of failed nodes
+        int failNodes (double fraction);
+        
+        // fraction of the running nodes that know their correct successor
+        double correctSuccessors ();
+        
+        // waits till every running node knows its correct successor
+        // returns false on timeout
+        bool waitForConvergence (std::chrono::milliseconds timeout);
+        
+        // runs count lookups of random keys from random nodes (one after another)
+        // and checks the results against the running nodes
+        ChordLookupStatistics measureLookups (int count, std::chrono::seconds timeout = std::chrono::seconds(10));
+        
+        // stores count random keys from random nodes (remembered for missingKeys)
+        // returns the number of keys that couldn't be stored
+        int storeKeys (int count, std::chrono::seconds timeout = std::chrono::seconds(10));
+        
+        // reads every stored key from a random node
+        // returns the number of keys that weren't found (f.e. lost during a join)
+        int missingKeys (std::chrono::seconds timeout = std::chrono::seconds(10));
+        
+    private:
+        std::shared_ptr<ChordMemoryNetwork> _network;
+        // transport of all nodes on the loopback network
+        std::shared_ptr<ChordTransport> _socketTransport;
+        
+        // running nodes by their id
+        std::map<ChordId, std::shared_ptr<Chord>> _nodes;
+        // protect nodes
+        std::mutex _nodes_mutex;
+        
+        // index of the next node's ip address
+        int _nextAddress { 0 };
+        
+        std::chrono::milliseconds _minStabilizeInterval;
+        std::chrono::milliseconds _maxStabilizeInterval;
+        ChordLookupMode _lookupMode { ChordLookupModeRecursive };
+        int _lookupParallelism { 1 };
+        
+        // nodes that store each key
+        int _replicationFactor { 1 };
+        
+        // virtual nodes per host
+        int _virtualNodes { 1 };
+        // stores of the current host and the number of its virtual nodes
+        std::shared_ptr<ChordShardedDataStore> _hostDataMap;
+        std::shared_ptr<ChordShardedDataStore> _hostReplicaMap;
+        int _hostNodeCount { 0 };
+        
+        // keys stored with storeKeys
+        std::vector<ChordId> _storedKeys;
+        
+        std::mt19937 _random;
+        
+        // address of the node with the given index
+        // (10.x.y.z:kPort or 127.0.0.1:kLoopbackPort+index)
+        void addressForIndex (int index, std::string *ipAddress, uint16_t *port) const;
+        
+        // creates and starts a node that joins the given node (nullptr: creates the ring)
+        // dataMap / replicaMap: stores of the node's host (nullptr: the node uses its own stores)
+        std::shared_ptr<Chord> startNode (ChordId nodeId, std::string ipAddress, uint16_t port,
+                                          std::shared_ptr<Chord> joinNode,
+                                          std::shared_ptr<ChordShardedDataStore> dataMap,
+                                          std::shared_ptr<ChordShardedDataStore> replicaMap);
+        
+        // running node that is responsible for the key
+        ChordId responsibleNodeId (ChordId key);
+        
+        // random key of the whole ring
+        ChordId randomKey ();
+    };
+}
+
+#endif /* defined(__RGP__Chord__ChordSimulator__) */
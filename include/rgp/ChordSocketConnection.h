@@ -0,0 +1,84 @@
+/*
+ ChordSocketConnection.h
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGP__Chord__ChordSocketConnection__
+#define __RGP__Chord__ChordSocketConnection__
+
+#include <iostream>
+
+#include <mutex>
+#include <memory>
+
+#include <rgp/ChordConnection.h>
+#include <rgp/ChordFrameReader.h>
+
+namespace rgp {
+    
+    // forward declaration
+    class ChordReactor;
+    
+    /**
+     @brief TCP connection of the ChordSocketTransport.
+     @details Messages are encoded with ChordWire and read by a
+     ChordFrameReader as soon as the reactor reports data on the socket.
+     */
+    class ChordSocketConnection : public ChordConnection, public std::enable_shared_from_this<ChordSocketConnection> {
+        
+    public:
+        // takes over the (connected) socket
+        ChordSocketConnection (int socket, std::shared_ptr<ChordReactor> reactor);
+        ~ChordSocketConnection ();
+        
+        void send (ChordHeader header, std::shared_ptr<uint8_t> data, uint32_t dataSize) override;
+        void receive (ChordMessageHandler handler, ChordClosedHandler closedHandler) override;
+        void close () override;
+        
+    private:
+        int _socket { -1 };
+        // the socket was shut down (it is closed by the destructor)
+        bool _closed { false };
+        // the lock is held while sending (messages must not be mixed) and closing
+        std::mutex _socket_mutex;
+        
+        // the reactor reports received data
+        std::weak_ptr<ChordReactor> _reactor;
+        // splits the received data into messages
+        ChordFrameReader _reader;
+        
+        ChordMessageHandler _handler;
+        ChordClosedHandler _closedHandler;
+        // the socket is watched by the reactor
+        bool _receiving { false };
+        // protect handlers
+        std::mutex _handler_mutex;
+        
+        // reads the available messages (called by reactor)
+        // returns false if the connection was closed
+        bool handleReadable ();
+    };
+}
+
+#endif /* defined(__RGP__Chord__ChordSocketConnection__) */
@@ -0,0 +1,79 @@
+/*
+ ChordSocketTransport.h
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGP__Chord__ChordSocketTransport__
+#define __RGP__Chord__ChordSocketTransport__
+
+#include <iostream>
+
+#include <map>
+#include <mutex>
+#include <memory>
+
+#include <rgp/ChordTransport.h>
+#include <rgp/ChordReactor.h>
+
+namespace rgp {
+    
+    /**
+     @brief Transport over TCP sockets.
+     @details All sockets (listening sockets and connections) are handled by
+     one ChordReactor, its workers also execute the dispatched tasks.
+     */
+    class ChordSocketTransport : public ChordTransport {
+        
+    public:
+        ChordSocketTransport (int workerCount = ChordReactor::kDefaultWorkerCount);
+        ~ChordSocketTransport ();
+        
+        // listens on the port on all interfaces (the ip address is not used)
+        bool listen (std::string ipAddress, uint16_t port, ChordAcceptHandler handler) override;
+        void stopListening (std::string ipAddress, uint16_t port) override;
+        
+        // the ip address may also be a host name
+        std::shared_ptr<ChordConnection> connect (std::string ipAddress, uint16_t port) override;
+        
+        void dispatch (std::function<void ()> task) override;
+        
+    private:
+        // handles all sockets
+        std::shared_ptr<ChordReactor> _reactor { nullptr };
+        
+        // listening socket of every port
+        std::map<uint16_t, int> _listeningSockets;
+        // protect listeningSockets
+        std::mutex _listeningSockets_mutex;
+        
+        // opens a socket that listens on the given port (all interfaces)
+        // returns -1 on error
+        static int listenOnPort (uint16_t port);
+        
+        // accepts an incomming connection (called by reactor)
+        bool acceptConnection (int listeningSocket, ChordAcceptHandler handler);
+    };
+}
+
+#endif /* defined(__RGP__Chord__ChordSocketTransport__) */
@@ -0,0 +1,91 @@
+/*
+ ChordTracer.h
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGP__Chord__ChordTracer__
+#define __RGP__Chord__ChordTracer__
+
+#include <iostream>
+
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+#include <rgp/ChordTypes.h>
+
+namespace rgp {
+    
+    /**
+     @brief Samples recursive searches and collects their paths.
+     @details A sampled search carries a trace id and a hop counter in its
+     header (ChordMessageFlagTraced). Every node it passes adds itself to
+     the search node response: its id, the wall clock when the search
+     arrived and the time till it answered. The node that started the
+     search gets the whole path and passes it to the handler.
+     Clocks of different nodes aren't synchronized - the durations are
+     measured by every node itself, so the time a node spent is its
+     duration minus the duration of the next hop (including the link
+     between them).
+     */
+    class ChordTracer {
+        
+    public:
+        // size of one hop inside a search node response
+        static const size_t kEncodedHopSize { sizeof(ChordId) + sizeof(uint8_t) + sizeof(uint64_t) + sizeof(uint32_t) };
+        
+        // trace every interval-th search (0: no tracing, 1: every search)
+        void setSamplingInterval (uint32_t interval) { _samplingInterval.store(interval, std::memory_order_relaxed); }
+        // called with every finished trace (default: logged with ChordLogLevelInfo)
+        void setHandler (ChordTraceHandler handler);
+        
+        // returns the id of a new trace or 0 if the search isn't sampled
+        uint32_t sample ();
+        // passes the finished trace to the handler
+        void traceFinished (const ChordTrace &trace);
+        
+        // entry of this node for the path (receivedAt: arrival of the search)
+        static ChordTraceHop hopForNode (ChordId nodeId, uint8_t hop, std::chrono::steady_clock::time_point receivedAt);
+        
+        // writes the path (path.size() * kEncodedHopSize bytes, network byte order)
+        static void encodePath (const std::vector<ChordTraceHop> &path, uint8_t *buffer);
+        // reads the path - returns false if the size doesn't fit
+        static bool decodePath (const uint8_t *buffer, size_t size, std::vector<ChordTraceHop> *path);
+        
+        // readable form of the trace (one line per hop)
+        static std::string description (const ChordTrace &trace);
+        
+    private:
+        std::atomic<uint32_t> _samplingInterval { 0 };
+        // number of searches since tracing was enabled
+        std::atomic<uint32_t> _searchCount { 0 };
+        
+        ChordTraceHandler _handler { nullptr };
+        // protect handler
+        std::mutex _handler_mutex;
+    };
+}
+
+#endif /* defined(__RGP__Chord__ChordTracer__) */
@@ -0,0 +1,70 @@
+/*
+ ChordTransport.h
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGP__Chord__ChordTransport__
+#define __RGP__Chord__ChordTransport__
+
+#include <iostream>
+
+#include <string>
+#include <memory>
+#include <functional>
+
+#include <rgp/ChordConnection.h>
+
+namespace rgp {
+    
+    /**
+     @brief Creates the connections between nodes and runs their handlers.
+     @details Chord and ChordNode don't use sockets directly, so the same
+     protocol code runs on TCP (ChordSocketTransport) and on the in-memory
+     network of the simulator (ChordMemoryTransport).
+     */
+    class ChordTransport {
+        
+    public:
+        // called for every new connection (before its identify message arrived)
+        typedef std::function<void (std::shared_ptr<ChordConnection> connection)> ChordAcceptHandler;
+        
+        virtual ~ChordTransport () {}
+        
+        // accepts connections to the given address
+        // returns false if the address can't be used
+        virtual bool listen (std::string ipAddress, uint16_t port, ChordAcceptHandler handler) = 0;
+        
+        // stops accepting connections to the given address
+        virtual void stopListening (std::string ipAddress, uint16_t port) = 0;
+        
+        // opens a connection to the given address (blocks till connected)
+        // returns nullptr if the connection failed
+        virtual std::shared_ptr<ChordConnection> connect (std::string ipAddress, uint16_t port) = 0;
+        
+        // executes the task on one of the transport's worker threads
+        virtual void dispatch (std::function<void ()> task) = 0;
+    };
+}
+
+#endif /* defined(__RGP__Chord__ChordTransport__) */
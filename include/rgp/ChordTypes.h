@@ -27,9 +27,47 @@
 #ifndef __RGP__Chord__ChordTypes__
 #define __RGP__Chord__ChordTypes__
 
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <exception>
+#include <functional>
+#include <utility>
+#include <chrono>
+
+#include <rgp/ChordRing.h>
+#include <rgp/ChordConfig.h>
+
+// width of the ids on the ring (generated by cmake - all nodes of a ring need the same)
+#ifndef RGPCHORD_ID_BITS
+#error "RGPCHORD_ID_BITS isn't defined - rgp/ChordConfig.h has to be generated by cmake"
+#endif
+
 namespace rgp {
     
+#if RGPCHORD_ID_BITS == 32
     typedef uint32_t ChordId;
+#elif RGPCHORD_ID_BITS == 64
+    typedef uint64_t ChordId;
+#else
+#error "RGPCHORD_ID_BITS must be 32 or 64"
+#endif
+    
+    // arithmetic on the ring of ChordIds
+    typedef ChordRing<ChordId, RGPCHORD_ID_BITS> ChordIdRing;
+    
+    // converts an id to network byte order
+    inline ChordId htonId (ChordId id) { return ChordIdRing::toNetwork(id); }
+    // converts an id from network byte order
+    inline ChordId ntohId (ChordId id) { return ChordIdRing::fromNetwork(id); }
+    
+    // size of the identify message's data (target id and id width)
+    static const uint32_t kIdentifyDataSize { sizeof(ChordId) + 1 };
+    
+    // a key with its (serialized) data
+    typedef std::pair<ChordId, std::shared_ptr<uint8_t>> ChordDataItem;
     
     typedef struct {
         ChordId from;
@@ -40,6 +78,8 @@ namespace rgp {
     typedef enum : uint8_t {
         
         // if someone connects he identifies himself with his first package
+        // data: id of the node he wants to reach, followed by the id width in bits (1 byte)
+        // (a node with another id width is rejected)
         ChordMessageTypeIdentify = 1,
         
         // checks if the node is still alive
@@ -50,6 +90,7 @@ namespace rgp {
         // search for a hash id
         ChordMessageTypeSearch,
         // answers search with another node (that is responsible for the key)
+        // followed by the path of a traced search or the number of search requests the node sent
         ChordMessageTypeSearchNodeResponse,
         
         // requests data
@@ -67,13 +108,45 @@ namespace rgp {
         ChordMessageTypeDataAddSuccess,
         
         // i'm your predecessor
+        // (a node that isn't the sender: it joined between you and your successor)
         ChordMessageTypeUpdatePredecessor,
         // tell me your predecessor
         ChordMessageTypeTellPredecessor,
         // my predecessor is ... (answer to update/tell predecessor)
-        ChordMessageTypePredecessor
+        ChordMessageTypePredecessor,
+        
+        // iterative search: tell me the responsible node for a key
+        // (answered with search node response) or the nodes closest preceding it
+        ChordMessageTypeSearchNextHops,
+        // answers iterative search with nodes that are closer to the key
+        ChordMessageTypeSearchNextHopsResponse,
+        
+        // add a copy of data my predecessors are responsible for
+        // (answered with data add success / failed)
+        ChordMessageTypeReplicaAdd,
+        
+        // a batch of a key range transfer: item count followed by key + data
+        // of every item (answered with data add success / failed)
+        ChordMessageTypeDataTransfer,
+        
+        // request data for several keys: key count followed by the keys
+        ChordMessageTypeDataMultiRequest,
+        // answers data multi request: the found items (same as data transfer)
+        ChordMessageTypeDataMultiAnswer,
+        
+        // copies of several items my predecessors are responsible for (same as data transfer)
+        // (answered with data add success / failed)
+        ChordMessageTypeReplicaTransfer
     } ChordMessageType;
     
+    // how a search is routed through the ring
+    typedef enum : uint8_t {
+        // every node forwards the search to the next node
+        ChordLookupModeRecursive = 1,
+        // the searching node asks every hop for the next one itself
+        ChordLookupModeIterative
+    } ChordLookupMode;
+    
     // feedback of connect()
     typedef enum : uint8_t {
         ChordConnectionStatusSuccessfullyConnected = 1,
@@ -92,17 +165,105 @@ namespace rgp {
         uint16_t port;
     } ChordHeaderNode;
     
+    // flags of a message (combined bitwise in ChordHeader::flags)
+    typedef enum : uint8_t {
+        // the data is compressed (reserved - not supported yet)
+        ChordMessageFlagCompressed = 1 << 0,
+        // the data contains several items (see ChordMessageTypeDataTransfer)
+        ChordMessageFlagBatched = 1 << 1,
+        // the header contains a trace id and a hop counter (sampled searches)
+        // the search node response carries the path of the search (see ChordTrace)
+        ChordMessageFlagTraced = 1 << 2
+    } ChordMessageFlag;
+    
     // every message begins with this header
     // this struct should always contain network byte order (for consistency)
+    // it is not send as it is - see ChordWire for the encoding on the wire
     typedef struct {
         // senders node info
         ChordHeaderNode node;
         // message type (ChordMessageType)
         ChordMessageType type;
+        // protocol version of the sender
+        uint8_t version;
+        // ChordMessageFlag values
+        uint8_t flags;
         // size of data that follows (0 if there is no data)
         uint32_t dataSize;
+        // id of the request (a response carries the id of its request)
+        // several requests can be send over one connection before
+        // the responses (in any order) are received
+        uint32_t requestId;
+        // id of the traced search (only if ChordMessageFlagTraced is set)
+        uint32_t traceId;
+        // number of nodes the traced search passed (the first node asked gets 1)
+        uint8_t hops;
     } ChordHeader;
     
+    // response of a remote node to a request
+    typedef struct {
+        // message type of the response
+        ChordMessageType type;
+        // received data (nullptr if there is no data)
+        std::shared_ptr<uint8_t> data;
+        // size of the received data
+        uint32_t dataSize;
+    } ChordResponse;
+    
+    // one node a traced search passed (host byte order)
+    typedef struct {
+        // node that forwarded or answered the search
+        ChordId nodeId;
+        // position on the path (the first node asked is hop 1)
+        uint8_t hop;
+        // wall clock of the node when the search arrived (microseconds since 1970)
+        uint64_t receivedAt;
+        // microseconds till the node answered (including the following hops)
+        uint32_t duration;
+    } ChordTraceHop;
+    
+    // a traced search as seen by the node that started it
+    typedef struct {
+        uint32_t traceId;
+        ChordId key;
+        // the node the search returned
+        ChordHeaderNode responsibleNode;
+        // the search failed (path contains the nodes that answered)
+        bool failed;
+        // all nodes the search passed (first hop first)
+        std::vector<ChordTraceHop> path;
+        // time till the search returned
+        std::chrono::steady_clock::duration duration;
+    } ChordTrace;
+    
+    // called as soon as the response of a request was received
+    // error is set (and the response is empty) if the request failed
+    typedef std::function<void (std::exception_ptr error, ChordResponse response)> ChordResponseHandler;
+    
+    // completion handlers of the asynchronous api
+    // error is set (and the result is empty) if the operation failed
+    // called with the node that is responsible for the searched key
+    typedef std::function<void (std::exception_ptr error, ChordHeaderNode node)> ChordLookupHandler;
+    // called with the responsible node (done is true) or with the nodes that
+    // are closest preceding the searched key (done is false)
+    typedef std::function<void (std::exception_ptr error, bool done, std::vector<ChordHeaderNode> nodes)> ChordNextHopsHandler;
+    // called with the found data (nullptr if there is no data for the key)
+    typedef std::function<void (std::exception_ptr error, std::shared_ptr<uint8_t> data)> ChordGetHandler;
+    // called with true if the data was added
+    typedef std::function<void (std::exception_ptr error, bool added)> ChordPutHandler;
+    // called with the found data of several keys (missing keys weren't found)
+    // error is set if a part of the keys couldn't be requested
+    typedef std::function<void (std::exception_ptr error, std::map<ChordId, std::shared_ptr<uint8_t>> data)> ChordMultiGetHandler;
+    // called with the responsible node and the number of requests the lookup needed
+    // (0 if the searching node is responsible or knew the responsible node itself)
+    typedef std::function<void (std::exception_ptr error, ChordHeaderNode node, int hops)> ChordRoutedLookupHandler;
+    // called with the responsible node, the number of search requests of the route
+    // and the path of a traced search (the path is empty if the search wasn't traced)
+    typedef std::function<void (std::exception_ptr error, ChordHeaderNode node, uint8_t hops,
+                                std::vector<ChordTraceHop> path)> ChordTracedLookupHandler;
+    // called with every finished traced search (see Chord::setTraceSampling)
+    typedef std::function<void (const ChordTrace &trace)> ChordTraceHandler;
+    
     // exceptions
     class ChordConnectionException {
         
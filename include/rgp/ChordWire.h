@@ -0,0 +1,101 @@
+/*
+ ChordWire.h
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#ifndef __RGP__Chord__ChordWire__
+#define __RGP__Chord__ChordWire__
+
+#include <iostream>
+
+#include <rgp/ChordTypes.h>
+
+namespace rgp {
+    
+    /**
+     @brief Encoding of ChordHeader on the wire.
+     @details The header is written field by field (no compiler padding):
+     magic, version, flags, type, ip and port with a fixed size, followed by
+     request id, data size and node id as varints (7 bits per byte, lowest
+     bits first). Most messages only need a few bytes for the varints.
+     A node accepts every version between kMinVersion and kVersion, so new
+     versions can be rolled out node by node.
+     Version 2 adds the trace id (varint) and the hop counter (one byte)
+     after the node id if ChordMessageFlagTraced is set. Untraced messages
+     are still sent as version 1, so only traced searches need updated
+     nodes.
+     Nodes inside the data of a message (predecessor, successor list, search
+     results) are written field by field as well: id, ip and port.
+     */
+    class ChordWire {
+        
+    public:
+        // first byte of every message
+        static const uint8_t kMagic { 0xC7 };
+        // protocol version that is send
+        static const uint8_t kVersion { 2 };
+        // oldest protocol version that is still understood
+        static const uint8_t kMinVersion { 1 };
+        // flags that are understood by this version
+        static const uint8_t kSupportedFlags { ChordMessageFlagBatched | ChordMessageFlagTraced };
+        // first version that knows ChordMessageFlagTraced
+        static const uint8_t kTraceVersion { 2 };
+        
+        // size of the fixed part (magic, version, flags, type, ip, port)
+        static const size_t kFixedHeaderSize { 10 };
+        // maximum size of a varint (32 bit value)
+        static const size_t kMaxVarintSize { 5 };
+        // maximum size of the node id varint (depends on the width of ChordId)
+        static const size_t kMaxIdVarintSize { (sizeof(ChordId) * 8 + 6) / 7 };
+        // maximum size of an encoded header (including trace id and hop counter)
+        static const size_t kMaxHeaderSize { kFixedHeaderSize + 3 * kMaxVarintSize + kMaxIdVarintSize + 1 };
+        // size of an encoded node (id, ip and port)
+        static const size_t kEncodedNodeSize { sizeof(ChordId) + sizeof(uint32_t) + sizeof(uint16_t) };
+        
+        // writes the header into the buffer (at least kMaxHeaderSize bytes)
+        // returns the size of the encoded header
+        static size_t encodeHeader (const ChordHeader &header, uint8_t *buffer);
+        
+        // reads a header from the buffer
+        // returns the size of the encoded header, 0 if more bytes are needed
+        // or -1 if the bytes are no valid header
+        static ssize_t decodeHeader (const uint8_t *buffer, size_t size, ChordHeader *header);
+        
+        // writes the node into the buffer (kEncodedNodeSize bytes)
+        static void encodeNode (const ChordHeaderNode &node, uint8_t *buffer);
+        
+        // reads a node from the buffer (kEncodedNodeSize bytes)
+        static ChordHeaderNode decodeNode (const uint8_t *buffer);
+        
+    private:
+        // writes value as varint - returns the number of bytes
+        static size_t encodeVarint (uint64_t value, uint8_t *buffer);
+        
+        // reads a varint of at most maxSize bytes - returns the number of
+        // bytes, 0 if more bytes are needed or -1 if the varint is too long
+        static ssize_t decodeVarint (const uint8_t *buffer, size_t size, size_t maxSize, uint64_t *value);
+    };
+}
+
+#endif /* defined(__RGP__Chord__ChordWire__) */
@@ -0,0 +1,229 @@
+/*
+ simulator.cpp
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <iostream>
+#include <sstream>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <rgp/Chord>
+#include <rgp/Log.h>
+
+using namespace rgp;
+
+// print usage information to the output (if usage was wrong)
+void printUsage (const char *programName)
+{
+    std::cout << "usage: " << programName << " [options]" << std::endl
+              << "  -nodes <count>         number of nodes (default 100)" << std::endl
+              << "  -latency <ms>          one way latency of every message (default 1)" << std::endl
+              << "  -jitter <ms>           random additional latency (default 0)" << std::endl
+              << "  -stabilize <ms>        stabilize interval of the nodes (default 500)" << std::endl
+              << "  -max-stabilize <ms>    stabilize interval of a stable ring (default 8000)" << std::endl
+              << "  -fail <fraction>       fraction of the nodes that fail after the first measurement (default 0)" << std::endl
+              << "  -join <count>          nodes that join after the first measurement (default 0)" << std::endl
+              << "  -virtual <weight>      virtual nodes per host - they share the host's stores (default 1)" << std::endl
+              << "  -keys <count>          keys stored before the join / failures - checked afterwards (default 0)" << std::endl
+              << "  -replicas <count>      nodes that store each key - a key is lost if all of them fail (default 1)" << std::endl
+              << "  -lookups <count>       lookups per measurement (default 1000)" << std::endl
+              << "  -iterative             route lookups iteratively (default recursive)" << std::endl
+              << "  -workers <count>       worker threads of the network (default "
+              << ChordMemoryNetwork::kDefaultWorkerCount << ")" << std::endl
+              << "  -timeout <s>           maximum time to wait for convergence (default 300)" << std::endl
+              << "  -trace <interval>      print the route of every n-th recursive lookup (default 0: off)" << std::endl
+              << "  -log-level <level>     0: errors, 1: warnings, 2: info, 3: verbose (default 1)" << std::endl;
+}
+
+// prints the result of a lookup measurement
+void printLookupStatistics (ChordSimulator::ChordLookupStatistics statistics)
+{
+    std::stringstream output;
+    
+    output << "lookups: " << statistics.lookups
+           << " failed: " << statistics.failedLookups
+           << " wrong: " << statistics.wrongLookups
+           << " average hops: " << statistics.averageHops
+           << " max hops: " << statistics.maxHops
+           << " average time: " << statistics.averageMilliseconds << " ms";
+    
+    Log::sharedLog()->print(output.str());
+}
+
+// waits for convergence and prints the needed time
+bool waitForConvergence (ChordSimulator &simulator, std::chrono::seconds timeout,
+                         std::chrono::steady_clock::time_point start)
+{
+    bool converged { simulator.waitForConvergence(timeout) };
+    std::chrono::duration<double> duration { std::chrono::steady_clock::now() - start };
+    
+    std::stringstream output;
+    if (converged) {
+        output << "converged after " << duration.count() << " s";
+    } else {
+        output << "not converged after " << duration.count() << " s (correct successors: "
+               << simulator.correctSuccessors() * 100 << " %)";
+    }
+    Log::sharedLog()->print(output.str());
+    
+    return converged;
+}
+
+int main (int argc, const char **argv)
+{
+    int nodes { 100 };
+    int latency { 1 };
+    int jitter { 0 };
+    int stabilize { 500 };
+    int maxStabilize { 8000 };
+    double fail { 0 };
+    int join { 0 };
+    int virtualNodes { 1 };
+    int keys { 0 };
+    int replicas { 1 };
+    int lookups { 1000 };
+    bool iterative { false };
+    int workers { ChordMemoryNetwork::kDefaultWorkerCount };
+    int timeout { 300 };
+    int trace { 0 };
+    
+    for (int k = 1; k < argc; k++) {
+        
+        bool hasValue { k + 1 < argc };
+        
+        if (strcmp(argv[k], "-iterative") == 0) {
+            iterative = true;
+        } else if (strcmp(argv[k], "-nodes") == 0 && hasValue) {
+            nodes = atoi(argv[++k]);
+        } else if (strcmp(argv[k], "-latency") == 0 && hasValue) {
+            latency = atoi(argv[++k]);
+        } else if (strcmp(argv[k], "-jitter") == 0 && hasValue) {
+            jitter = atoi(argv[++k]);
+        } else if (strcmp(argv[k], "-stabilize") == 0 && hasValue) {
+            stabilize = atoi(argv[++k]);
+        } else if (strcmp(argv[k], "-max-stabilize") == 0 && hasValue) {
+            maxStabilize = atoi(argv[++k]);
+        } else if (strcmp(argv[k], "-fail") == 0 && hasValue) {
+            fail = atof(argv[++k]);
+        } else if (strcmp(argv[k], "-join") == 0 && hasValue) {
+            join = atoi(argv[++k]);
+        } else if (strcmp(argv[k], "-virtual") == 0 && hasValue) {
+            virtualNodes = atoi(argv[++k]);
+        } else if (strcmp(argv[k], "-keys") == 0 && hasValue) {
+            keys = atoi(argv[++k]);
+        } else if (strcmp(argv[k], "-replicas") == 0 && hasValue) {
+            replicas = atoi(argv[++k]);
+        } else if (strcmp(argv[k], "-lookups") == 0 && hasValue) {
+            lookups = atoi(argv[++k]);
+        } else if (strcmp(argv[k], "-workers") == 0 && hasValue) {
+            workers = atoi(argv[++k]);
+        } else if (strcmp(argv[k], "-timeout") == 0 && hasValue) {
+            timeout = atoi(argv[++k]);
+        } else if (strcmp(argv[k], "-trace") == 0 && hasValue) {
+            trace = atoi(argv[++k]);
+        } else if (strcmp(argv[k], "-log-level") == 0 && hasValue) {
+            int level { atoi(argv[++k]) };
+            ChordLog::sharedLog()->setLevel(static_cast<ChordLogLevel>(std::max(0, std::min(level, static_cast<int>(ChordLogLevelVerbose)))));
+        } else {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    
+    if (nodes < 1 || fail < 0 || fail >= 1 || trace < 0 || join < 0 || virtualNodes < 1 || keys < 0 || replicas < 1) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    
+    ChordSimulator simulator(workers);
+    simulator.network()->setLatency(std::chrono::milliseconds(latency), std::chrono::milliseconds(jitter));
+    simulator.setStabilizeInterval(std::chrono::milliseconds(stabilize), std::chrono::milliseconds(maxStabilize));
+    if (iterative) {
+        simulator.setLookupMode(ChordLookupModeIterative);
+    }
+    simulator.setVirtualNodes(virtualNodes);
+    simulator.setReplicationFactor(replicas);
+    
+    // build the ring
+    Log::sharedLog()->print(std::string("starting ") += std::to_string(nodes) += " nodes ...");
+    
+    std::chrono::steady_clock::time_point start { std::chrono::steady_clock::now() };
+    simulator.addNodes(nodes);
+    
+    std::chrono::duration<double> joinDuration { std::chrono::steady_clock::now() - start };
+    Log::sharedLog()->print(std::string("all nodes joined after ") += std::to_string(joinDuration.count()) += " s");
+    
+    waitForConvergence(simulator, std::chrono::seconds(timeout), start);
+    
+    // trace the sampled lookups of every node
+    if (trace > 0) {
+        for (std::shared_ptr<Chord> node : simulator.nodes()) {
+            node->setTraceSampling(static_cast<uint32_t>(trace));
+            node->setTraceHandler([] (const ChordTrace &trace) {
+                Log::sharedLog()->print(ChordTracer::description(trace));
+            });
+        }
+    }
+    
+    printLookupStatistics(simulator.measureLookups(lookups));
+    
+    // the data has to move with the ranges
+    if (keys > 0) {
+        int failedKeys { simulator.storeKeys(keys) };
+        Log::sharedLog()->print(std::string("stored ") += std::to_string(keys - failedKeys) += " keys");
+    }
+    
+    // let some nodes join (the hosts of the virtual nodes hand over parts of their shared stores)
+    if (join > 0) {
+        start = std::chrono::steady_clock::now();
+        simulator.addNodes(join);
+        Log::sharedLog()->print(std::string("joined ") += std::to_string(join) += " nodes");
+        
+        waitForConvergence(simulator, std::chrono::seconds(timeout), start);
+        printLookupStatistics(simulator.measureLookups(lookups));
+        
+        if (keys > 0) {
+            Log::sharedLog()->print(std::string("missing keys after join: ") += std::to_string(simulator.missingKeys()));
+        }
+    }
+    
+    // let some nodes crash
+    if (fail > 0) {
+        start = std::chrono::steady_clock::now();
+        int failed { simulator.failNodes(fail) };
+        Log::sharedLog()->print(std::string("failed ") += std::to_string(failed) += " nodes");
+        
+        waitForConvergence(simulator, std::chrono::seconds(timeout), start);
+        printLookupStatistics(simulator.measureLookups(lookups));
+        
+        if (keys > 0) {
+            // with replicas a key is only lost if all nodes that store it failed
+            std::string missing { std::string("missing keys after failures (replication factor ") + std::to_string(replicas) + "): " };
+            Log::sharedLog()->print(missing += std::to_string(simulator.missingKeys()));
+        }
+    }
+    
+    return EXIT_SUCCESS;
+}
@@ -25,76 +25,204 @@
 */
 
 #include <rgp/Chord.h>
-#include <rgp/Log.h>
+#include <rgp/ChordWire.h>
+#include <rgp/ChordConnection.h>
+#include <rgp/ChordSocketTransport.h>
+#include <rgp/ChordLog.h>
 
 #include <unistd.h>
 #include <arpa/inet.h>
-#include <complex>
-#include <sys/time.h>
+#include <set>
+#include <sstream>
+#include <algorithm>
 
 using namespace rgp;
 
+const int Chord::kMinStabilizeInterval;
+const int Chord::kMaxStabilizeInterval;
+
+namespace rgp {
+    
+    // state of an iterative lookup (shared by all parallel requests)
+    struct ChordIterativeLookup {
+        ChordId key;
+        ChordRoutedLookupHandler handler;
+        // protect the lookup state
+        std::mutex mutex;
+        // known nodes preceding the key - closest to the key first
+        std::vector<ChordHeaderNode> candidates;
+        // nodes that were already asked
+        std::set<ChordId> queriedNodes;
+        // number of requests waiting for their response
+        int pendingRequests { 0 };
+        // number of all send requests
+        int requests { 0 };
+        // the handler was called
+        bool finished { false };
+    };
+    
+    // state of the lookups of a multi get / put
+    struct ChordKeyGrouping {
+        std::function<void (std::exception_ptr error, ChordKeysByNode groups)> handler;
+        // protect the grouping state
+        std::mutex mutex;
+        // number of lookups waiting for their result
+        size_t pendingLookups { 0 };
+        ChordKeysByNode groups;
+        // first error of a lookup
+        std::exception_ptr error;
+    };
+    
+    // state of the requests of a multi get / put (one per node)
+    struct ChordMultiRequest {
+        // protect the request state
+        std::mutex mutex;
+        // number of requests waiting for their response
+        size_t pendingRequests { 0 };
+        // first error of a request
+        std::exception_ptr error;
+        // multi put: all data was added
+        bool added { true };
+        // multi get: all found data
+        std::map<ChordId, std::shared_ptr<uint8_t>> data;
+        // keys / items that have to be retried without the location cache
+        std::vector<ChordId> retryKeys;
+        std::vector<ChordDataItem> retryItems;
+    };
+}
+
 #pragma mark - Constructor / Destructor
 
-Chord::Chord (std::string ipAddress, uint16_t port)
+Chord::Chord (std::string ipAddress, uint16_t port, std::string identity)
+: Chord(nodeIdForConfiguration(ipAddress, port, identity), ipAddress, port, "", 0,
+        std::make_shared<ChordSocketTransport>())
 {
-    // alloc own node
-    initOwnNode(ipAddress, port);
-    
-    // fill finger table with ownNode
-    // initialy there is only us in the dht - so we are responsible for all keys
-    for (int k=0; k <= kKeyLenght; k++) {
-//        int i = static_cast<int>(ownNode->getNodeID() + std::pow(2, k-1)) % static_cast<int>(std::pow(2, kKeyLenght));
-        _fingerTable.push_back(_ownNode);
-    }
+}
+
+Chord::Chord (std::string ipAddress, uint16_t port, std::string c_ipAddress, uint16_t c_port,
+              std::string identity)
+: Chord(nodeIdForConfiguration(ipAddress, port, identity), ipAddress, port, c_ipAddress, c_port,
+        std::make_shared<ChordSocketTransport>())
+{
+}
+
+Chord::Chord (ChordId nodeId, std::string ipAddress, uint16_t port, std::string c_ipAddress, uint16_t c_port,
+              std::shared_ptr<ChordTransport> transport, bool listen,
+              std::shared_ptr<ChordShardedDataStore> dataMap, std::shared_ptr<ChordShardedDataStore> replicaMap)
+: _nodeId(nodeId), _ipAddress(ipAddress), _port(port), _joinIpAddress(c_ipAddress), _joinPort(c_port), _listen(listen),
+  _dataMap(dataMap ? dataMap : std::make_shared<ChordShardedDataStore>()),
+  _replicaMap(replicaMap ? replicaMap : std::make_shared<ChordShardedDataStore>()),
+  _transport(transport)
+{
+    // nothing happens before start() - our nodes need a pointer to us
+}
+
+Chord::~Chord ()
+{
+    // the server asks us for the snapshot
+    _metricsServer.reset();
     
-    // we are responsible for all keys
-    _responsibilityRange = (ChordRange) { .from=0, .to=highestID() }; // whole ring
+    // (normally the owner stopped us already)
+    stop();
     
-    // listen for incomming connections
-    _connectThread = std::thread(&Chord::waitForIncommingConnections, this);
+    // stop accepting connections
+    if (_listening) {
+        _transport->stopListening(_ipAddress, _port);
+        _listening = false;
+    }
     
-    // start stabilize protocol
-    _stabilizeThread = std::thread(&Chord::stabilize, this);
+    // stops the transport (virtual nodes only release the host's transport)
+    _transport.reset();
 }
 
-Chord::Chord (std::string ipAddress, uint16_t port, std::string c_ipAddress, uint16_t c_port)
+#pragma mark - Public
+
+// creates (or joins) the ring and starts the protocols
+void Chord::start ()
 {
+    _weakSelf = shared_from_this();
+    
     // alloc own node
-    initOwnNode(ipAddress, port);
+    initOwnNode(_nodeId, _ipAddress, _port);
     
     // listen for incomming connections
-    _connectThread = std::thread(&Chord::waitForIncommingConnections, this);
+    // (virtual nodes: the host listens for them)
+    if (_listen) {
+        startListening();
+    }
     
-    // connect to dht overlay
-    joinDHT(c_ipAddress, c_port);
+    if (_joinIpAddress.empty()) {
+        // fill finger table with ownNode
+        // initialy there is only us in the dht - so we are responsible for all keys
+        _fingerTable.assign(kKeyLenght, _ownNode);
+        
+        // we are responsible for all keys
+        _neighbours_mutex.lock();
+        _responsibilityRange = (ChordRange) { .from=0, .to=highestID() }; // whole ring
+        _responsibilityRangeKnown = true;
+        _neighbours_mutex.unlock();
+        
+    } else {
+        // connect to dht overlay
+        joinDHT(_joinIpAddress, _joinPort);
+    }
     
     // start stabilize protocol
     _stabilizeThread = std::thread(&Chord::stabilize, this);
     
-// TODO: fill finger table
-//    for (int k=1; k < kKeyLenght; k++) {
-//        int nodeID = (int)(ownNode->getNodeID() + std::pow(2, k-1)) % highestID();
-//
-//    }
+    // start fix fingers protocol
+    _fixFingersThread = std::thread(&Chord::fixFingers, this);
 }
 
-Chord::~Chord ()
+// stops the protocols and waits for their threads
+void Chord::stop ()
 {
-    // close connectThread
-    _stopConnectThread = true;
+    _stop_mutex.lock();
     _stopStabilizeThread = true;
+    _stopFixFingersThread = true;
+    _stop_mutex.unlock();
     
-    try {
-        _connectThread.join();
-    } catch (...) {} // if thread not joinable
+    // wake up the sleeping protocols
+    _stop_condition.notify_all();
     
-    try {
-        _stabilizeThread.join();
-    } catch (...) {} // if thread not joinable
+    _stopThreads_mutex.lock();
+    for (std::thread *thread : { &_stabilizeThread, &_fixFingersThread }) {
+        
+        if (!thread->joinable()) {
+            continue;
+        }
+        
+        // the owner didn't stop us and a protocol released the last reference -
+        // the thread can't wait for itself
+        if (thread->get_id() == std::this_thread::get_id()) {
+            CHORD_LOGE("Chord::stop(): node destroyed by its own protocol thread - call stop() first");
+            thread->detach();
+        } else {
+            thread->join();
+        }
+    }
+    _stopThreads_mutex.unlock();
 }
 
-#pragma mark - Public
+// interval of the stabilize and fix fingers protocols
+void Chord::setStabilizeInterval (std::chrono::milliseconds minimum, std::chrono::milliseconds maximum)
+{
+    _stabilizeInterval.setRange(minimum, maximum);
+    _fixFingersInterval.setRange(minimum, maximum);
+}
+
+// a node joined or left - the protocols run with the minimum interval
+void Chord::membershipChanged ()
+{
+    _stabilizeInterval.reset();
+    _fixFingersInterval.reset();
+    
+    // the waiting protocols check the intervals while they hold the mutex
+    _stop_mutex.lock();
+    _stop_mutex.unlock();
+    
+    _stop_condition.notify_all();
+}
 
 // creates a chord header with the well known data and the given type
 // if there needs to be data appended - this need to be added later
@@ -105,597 +233,1880 @@ ChordHeader Chord::createChordHeader (ChordMessageType type)
     ChordHeader header { };
     
     // fill header with well known data
-    header.node.nodeId = htons(_ownNode->getNodeID());
+    header.node.nodeId = htonId(_ownNode->getNodeID());
     header.node.ip = htonl(inet_addr(_ownNode->getIPAddress().c_str()));
     header.node.port = htons(_ownNode->getPort());
     header.dataSize = 0;
+    header.version = ChordWire::kVersion;
     
     // set given type
     header.type = type;
     
+    // messages that carry several items
+    if (type == ChordMessageTypeDataTransfer || type == ChordMessageTypeDataMultiRequest ||
+        type == ChordMessageTypeDataMultiAnswer || type == ChordMessageTypeReplicaTransfer) {
+        header.flags |= ChordMessageFlagBatched;
+    }
+    
     // return the filled header
     return header;
 }
 
-// highest possible hash id
-ChordId Chord::highestID () const
+// check if i'm responsible for the given key
+bool Chord::keyIsInMyRange (ChordId key) const
+{
+    ChordRange range { responsibilityRange() };
+    
+    // a range with from == to covers the whole ring
+    if (range.from == range.to) {
+        return true;
+    }
+    
+    return ChordIdRing::isInClosedRange(key, range.from, range.to);
+}
+
+// checks if key is inside the ring interval (from, to]
+bool Chord::keyIsInRange (ChordId key, ChordId from, ChordId to)
 {
-    return static_cast<ChordId>(std::pow(2, kKeyLenght) -1);
+    return ChordIdRing::isInRange(key, from, to);
 }
 
-// check if i'm responsible for the given key
-bool Chord::keyIsInMyRange (ChordId key) const
+// checks if key is inside the ring interval (from, to)
+bool Chord::keyIsBetween (ChordId key, ChordId from, ChordId to)
+{
+    return ChordIdRing::isBetween(key, from, to);
+}
+
+ChordHeaderNode Chord::searchForKey (ChordId searchingNode, ChordId key)
 {
-    // special case
-    if (_responsibilityRange.from >= _responsibilityRange.to) {
+    std::shared_ptr<std::promise<ChordHeaderNode>> promise { std::make_shared<std::promise<ChordHeaderNode>>() };
+    std::future<ChordHeaderNode> future { promise->get_future() };
+    
+    searchForKeyAsync(searchingNode, key, [promise] (std::exception_ptr error, ChordHeaderNode node) {
+        if (error) {
+            promise->set_exception(error);
+        } else {
+            promise->set_value(node);
+        }
+    });
+    
+    try {
+        // every hop fails after kRequestTimeoutSeconds - but the hops may add up
+        if (future.wait_for(std::chrono::seconds(ChordNode::kRequestTimeoutSeconds)) == std::future_status::ready) {
+            return future.get();
+        }
+        CHORD_LOGE("Chord::searchForKey: timeout");
         
-        if (key >= _responsibilityRange.from || key <= _responsibilityRange.to) {
-            return true;
+    } catch (ChordConnectionException &exception) {
+        CHORD_LOGE("Chord::searchForKey: " << exception.what());
+    }
+    
+    // if we can't find a responsible node -> what to do now ?
+    // i return myself -> helps joining nodes, but won't help if search was for adding / receiving data
+    return _ownNode->chordNode();
+}
+
+void Chord::searchForKeyAsync (ChordId searchingNode, ChordId key, ChordLookupHandler handler)
+{
+    searchForKeyAsync(searchingNode, key, 0, 0, [handler] (std::exception_ptr error, ChordHeaderNode node, uint8_t,
+                                                         std::vector<ChordTraceHop>) {
+        handler(error, node);
+    });
+}
+
+// traced search - the path contains the nodes after us (traceId 0: untraced)
+void Chord::searchForKeyAsync (ChordId searchingNode, ChordId key, uint32_t traceId, uint8_t hops,
+                               ChordTracedLookupHandler handler)
+{
+    CHORD_LOGV("search for key: " << key);
+    
+    // return ownNode if i'm responsible
+    if (keyIsInMyRange(key)) {
+        
+        CHORD_LOGV("return responsible node: " << _ownNode->getNodeID());
+        _metrics->searchResolved();
+        handler(std::exception_ptr(), _ownNode->chordNode(), 0, std::vector<ChordTraceHop>());
+        return;
+    }
+    
+    // if i'm not responsible - and we don't know any other node
+    // i return myself -> helps joining nodes, but won't help if search was for adding / receiving data
+    std::shared_ptr<ChordNode> successor { currentSuccessor() };
+    if (!successor) {
+        _metrics->searchResolved();
+        handler(std::exception_ptr(), _ownNode->chordNode(), 0, std::vector<ChordTraceHop>());
+        return;
+    }
+    
+    // key is between me and my successor -> successor is responsible
+    if (keyIsInRange(key, _ownNode->getNodeID(), successor->getNodeID())) {
+        
+        CHORD_LOGV("successor is responsible: " << successor->getNodeID());
+        _metrics->searchResolved();
+        handler(std::exception_ptr(), successor->chordNode(), 0, std::vector<ChordTraceHop>());
+        return;
+    }
+    
+    // forward search to the closest finger preceding the key
+    std::shared_ptr<ChordNode> nextNode { closestPrecedingNode(key) };
+    
+    // don't send search back to where it came from
+    if (!nextNode || nextNode == _ownNode || nextNode->getNodeID() == searchingNode) {
+        nextNode = successor;
+    }
+    
+    // a route longer than the key length points to broken fingers
+    uint8_t nextHops = static_cast<uint8_t>(std::min(hops + 1, 255));
+    if (traceId != 0 && nextHops > kKeyLenght) {
+        CHORD_LOGW("trace " << traceId << ": search for key (" << key << ") passed " << static_cast<int>(nextHops) << " nodes");
+    }
+    
+    CHORD_LOGV("i'm not responsible - passthrough search: " << nextNode->getNodeID());
+    _metrics->searchForwarded();
+    nextNode->establishSendConnection();
+    nextNode->searchForKeyAsync(key, traceId, nextHops, [nextNode, successor, searchingNode, key, traceId, nextHops, handler]
+                                (std::exception_ptr error, ChordHeaderNode node, uint8_t routeHops,
+                                 std::vector<ChordTraceHop> path) {
+        
+        if (!error) {
+            CHORD_LOGV("search result for key (" << key << ") " << ntohId(node.nodeId));
+            handler(error, node, routeHops, path);
+            return;
         }
         
-    } else {
+        CHORD_LOGW("Chord::searchForKeyAsync: search with finger failed");
         
-        // check if key is inside my responsible range
-        if (key >= _responsibilityRange.from && key <= _responsibilityRange.to) {
-            return true;
+        // finger may be dead - retry with our successor
+        if (nextNode != successor && successor->getNodeID() != searchingNode) {
+            successor->searchForKeyAsync(key, traceId, nextHops, handler);
+            return;
+        }
+        
+        handler(error, node, routeHops, path);
+    });
+}
+
+// searches the node that is responsible for the key
+void Chord::lookupAsync (ChordId key, ChordLookupHandler handler)
+{
+    routedLookupAsync(key, [handler] (std::exception_ptr error, ChordHeaderNode node, int) {
+        handler(error, node);
+    });
+}
+
+// searches the responsible node - the handler also gets the hops of the lookup
+void Chord::routedLookupAsync (ChordId key, ChordRoutedLookupHandler handler)
+{
+    std::chrono::steady_clock::time_point startTime { std::chrono::steady_clock::now() };
+    
+    // remember the responsible node for the next get / put
+    ChordRoutedLookupHandler cachingHandler = [this, key, handler, startTime]
+                                              (std::exception_ptr error, ChordHeaderNode node, int hops) {
+        _metrics->lookupFinished(std::chrono::steady_clock::now() - startTime, static_cast<bool>(error));
+        
+        if (!error) {
+            _metrics->lookupRouted(hops);
+        }
+        
+        if (!error && ntohId(node.nodeId) != _ownNode->getNodeID()) {
+            _locationCache.insert(key, node);
         }
+        handler(error, node, hops);
+    };
+    
+    if (_lookupMode == ChordLookupModeIterative) {
+        iterativeLookupAsync(key, cachingHandler);
+        return;
     }
     
-    return false;
+    // only sampled recursive lookups are traced
+    uint32_t traceId { _tracer.sample() };
+    
+    searchForKeyAsync(_ownNode->getNodeID(), key, traceId, 0, [this, key, traceId, startTime, cachingHandler]
+                      (std::exception_ptr error, ChordHeaderNode node, uint8_t hops, std::vector<ChordTraceHop> path) {
+        
+        if (traceId != 0) {
+            ChordTrace trace { traceId, key, node, static_cast<bool>(error), path, std::chrono::steady_clock::now() - startTime };
+            _tracer.traceFinished(trace);
+        }
+        
+        cachingHandler(error, node, hops);
+    });
 }
 
-ChordHeaderNode Chord::searchForKey (ChordId searchingNode, ChordId key) const
+std::future<ChordHeaderNode> Chord::lookupAsync (ChordId key)
 {
-    RGPLOGV(std::string("search for key: ") += std::to_string(key));
-    ChordHeaderNode responsibleNode { 0 };
+    std::shared_ptr<std::promise<ChordHeaderNode>> promise { std::make_shared<std::promise<ChordHeaderNode>>() };
     
-    // return ownNode if i'm responsible
+    lookupAsync(key, [promise] (std::exception_ptr error, ChordHeaderNode node) {
+        if (error) {
+            promise->set_exception(error);
+        } else {
+            promise->set_value(node);
+        }
+    });
+    
+    return promise->get_future();
+}
+
+// configures how lookups of this node are routed
+void Chord::setLookupMode (ChordLookupMode mode, int parallelism)
+{
+    _lookupMode = mode;
+    _lookupParallelism = std::max(1, std::min(parallelism, 255));
+}
+
+// answers one step of an iterative search (only checks local state)
+bool Chord::nextHopsForKey (ChordId key, uint8_t count, std::vector<ChordHeaderNode> *nodes)
+{
+    // i'm responsible
     if (keyIsInMyRange(key)) {
+        nodes->push_back(_ownNode->chordNode());
+        return true;
+    }
+    
+    // we don't know any other node
+    std::shared_ptr<ChordNode> successor { currentSuccessor() };
+    if (!successor) {
+        nodes->push_back(_ownNode->chordNode());
+        return true;
+    }
+    
+    // key is between me and my successor -> successor is responsible
+    if (keyIsInRange(key, _ownNode->getNodeID(), successor->getNodeID())) {
+        nodes->push_back(successor->chordNode());
+        return true;
+    }
+    
+    // fingers preceding the key - closest to the key first
+    _fingerTable_mutex.lock();
+    std::shared_ptr<ChordNode> lastNode { nullptr };
+    for (auto iterator = _fingerTable.rbegin(); iterator != _fingerTable.rend() && nodes->size() < std::max<size_t>(count, 1); ++iterator) {
         
-        responsibleNode.nodeId = htons(_ownNode->getNodeID());
-        responsibleNode.ip = htonl(inet_addr(_ownNode->getIPAddress().c_str()));
-        responsibleNode.port = htons(_ownNode->getPort());
+        std::shared_ptr<ChordNode> finger { *iterator };
         
-        RGPLOGV(std::string("return responsible node: ") += std::to_string(_ownNode->getNodeID()));
-        return responsibleNode;
+        // several fingers point to the same node
+        if (!finger || finger == _ownNode || finger == lastNode) {
+            continue;
+        }
+        
+        if (keyIsBetween(finger->getNodeID(), _ownNode->getNodeID(), key)) {
+            nodes->push_back(finger->chordNode());
+            lastNode = finger;
+        }
     }
+    _fingerTable_mutex.unlock();
     
-    // if i'm not responsible - search using successor
-    // TODO: use fingertable
-    try {
-        bool searchDone = false;
+    // successor precedes the key as well
+    if (nodes->empty()) {
+        nodes->push_back(successor->chordNode());
+    }
+    
+    return false;
+}
+
+// iterative lookup: we ask every hop for the next one ourself
+// intermediate nodes only answer with their fingers and never wait for other nodes
+void Chord::iterativeLookupAsync (ChordId key, ChordRoutedLookupHandler handler)
+{
+    std::vector<ChordHeaderNode> nodes;
+    
+    // check our own fingers first
+    if (nextHopsForKey(key, static_cast<uint8_t>(_lookupParallelism), &nodes)) {
+        handler(std::exception_ptr(), nodes.front(), 0);
+        return;
+    }
+    
+    std::shared_ptr<ChordIterativeLookup> lookup { std::make_shared<ChordIterativeLookup>() };
+    lookup->key = key;
+    lookup->handler = handler;
+    lookup->candidates = nodes;
+    lookup->queriedNodes.insert(_ownNode->getNodeID());
+    
+    continueIterativeLookup(lookup);
+}
+
+// asks the closest known nodes (that weren't asked yet) for the next hops
+void Chord::continueIterativeLookup (std::shared_ptr<ChordIterativeLookup> lookup)
+{
+    // every request gets us closer to the key - stop if something is wrong
+    const int kMaxLookupRequests { 2 * kKeyLenght };
+    
+    std::vector<ChordHeaderNode> nextNodes;
+    int parallelism { _lookupParallelism };
+    
+    lookup->mutex.lock();
+    
+    if (lookup->finished) {
+        lookup->mutex.unlock();
+        return;
+    }
+    
+    // ask the closest nodes that weren't asked yet
+    for (ChordHeaderNode node : lookup->candidates) {
+        
+        if (lookup->pendingRequests + static_cast<int>(nextNodes.size()) >= parallelism) {
+            break;
+        }
         
-        // don't send search back to where it came from
-        if (_predecessor) {
+        if (lookup->queriedNodes.insert(ntohId(node.nodeId)).second) {
+            nextNodes.push_back(node);
+        }
+    }
+    
+    lookup->pendingRequests += nextNodes.size();
+    lookup->requests += nextNodes.size();
+    int requests { lookup->requests };
+    
+    // no node left to ask
+    bool failed = lookup->pendingRequests == 0 || lookup->requests > kMaxLookupRequests;
+    if (failed) {
+        lookup->finished = true;
+    }
+    
+    lookup->mutex.unlock();
+    
+    if (failed) {
+        // let the nodes forward the search instead (its hops add to our requests)
+        CHORD_LOGE("Chord::continueIterativeLookup(): iterative lookup failed for key: " << lookup->key);
+        ChordRoutedLookupHandler handler { lookup->handler };
+        searchForKeyAsync(_ownNode->getNodeID(), lookup->key, 0, 0, [handler, requests]
+                          (std::exception_ptr error, ChordHeaderNode node, uint8_t hops, std::vector<ChordTraceHop>) {
+            handler(error, node, requests + hops);
+        });
+        return;
+    }
+    
+    for (ChordHeaderNode node : nextNodes) {
+        
+        std::shared_ptr<ChordNode> nextNode { nodeForHeaderNode(node) };
+        nextNode->establishSendConnection();
+        
+        nextNode->searchNextHopsAsync(lookup->key, static_cast<uint8_t>(parallelism), [this, lookup]
+                                      (std::exception_ptr error, bool done, std::vector<ChordHeaderNode> nodes) {
             
-            if (_predecessor->getNodeID() != searchingNode) {
-                // check if searching node may don't know the existence of my predecessor (and possibly skipped the node)
-                if (searchingNode < key && _predecessor->getNodeID() > key) {
-                    
-                    // search with predecessor
-                    RGPLOGV(std::string("i'm not responsible - passthrough search (predecessor): ") += std::to_string(_predecessor->getNodeID()));
-                    _predecessor->establishSendConnection();
-                    responsibleNode = _predecessor->searchForKey(key);
-                    
-                    searchDone = true;
+            lookup->mutex.lock();
+            lookup->pendingRequests--;
+            
+            if (lookup->finished) {
+                lookup->mutex.unlock();
+                return;
+            }
+            
+            // we found the responsible node
+            if (!error && done) {
+                lookup->finished = true;
+                int requests { lookup->requests };
+                lookup->mutex.unlock();
+                
+                lookup->handler(std::exception_ptr(), nodes.front(), requests);
+                return;
+            }
+            
+            // remember the new nodes - closest to the key first
+            // (a dead node is just skipped)
+            if (!error) {
+                for (ChordHeaderNode node : nodes) {
+                    lookup->candidates.push_back(node);
                 }
+                
+                ChordId key { lookup->key };
+                std::sort(lookup->candidates.begin(), lookup->candidates.end(),
+                          [key] (const ChordHeaderNode &a, const ChordHeaderNode &b) {
+                              return ChordIdRing::distance(ntohId(a.nodeId), key) < ChordIdRing::distance(ntohId(b.nodeId), key);
+                          });
             }
+            
+            lookup->mutex.unlock();
+            
+            continueIterativeLookup(lookup);
+        });
+    }
+}
+
+// receives the data with the key from the responsible node
+void Chord::getAsync (ChordId key, ChordGetHandler handler)
+{
+    ChordHeaderNode cachedNode;
+    
+    if (keyIsInMyRange(key) || !_locationCache.find(key, &cachedNode)) {
+        lookupAndGetAsync(key, handler);
+        return;
+    }
+    
+    // ask the cached responsible node directly
+    std::shared_ptr<ChordNode> responsibleNode { nodeForHeaderNode(cachedNode) };
+    responsibleNode->establishSendConnection();
+    responsibleNode->requestDataForKeyAsync(key, [this, key, cachedNode, handler] (std::exception_ptr error, std::shared_ptr<uint8_t> data) {
+        
+        if (!error && data) {
+            handler(error, data);
+            return;
+        }
+        
+        // the cached node may be dead or not responsible anymore
+        if (error) {
+            _locationCache.removeNode(ntohId(cachedNode.nodeId));
         }
         
-        // only if not searched with predecessor already
-        if (!searchDone) {
+        lookupAsync(key, [this, key, cachedNode, error, handler] (std::exception_ptr lookupError, ChordHeaderNode node) {
             
-            // don't send search back to where it came from
-            if (_successor) {
-                if (_successor->getNodeID() != searchingNode) {
-                    RGPLOGV(std::string("i'm not responsible - passthrough search (successor): ") += std::to_string(_successor->getNodeID()));
-                    responsibleNode = _successor->searchForKey(key);
-                } else {
-                    
-                    // if we can't find a responsible node -> what to do now ?
-                    // i return myself -> helps joining nodes, but won't help if search was for adding / receiving data
-                    responsibleNode.nodeId = htons(_ownNode->getNodeID());
-                    responsibleNode.ip = htonl(inet_addr(_ownNode->getIPAddress().c_str()));
-                    responsibleNode.port = htons(_ownNode->getPort());
-                }
-            } else {
+            if (lookupError) {
+                handler(lookupError, nullptr);
+                return;
+            }
+            
+            // the cached node was right - there is no data with that key
+            if (!error && node.nodeId == cachedNode.nodeId) {
+                handler(std::exception_ptr(), nullptr);
+                return;
+            }
+            
+            _locationCache.removeNode(ntohId(cachedNode.nodeId));
+            getFromNodeAsync(node, key, handler);
+        });
+    });
+}
+
+// searches the responsible node and receives the data from it
+void Chord::lookupAndGetAsync (ChordId key, ChordGetHandler handler)
+{
+    lookupAsync(key, [this, key, handler] (std::exception_ptr error, ChordHeaderNode node) {
+        
+        if (error) {
+            handler(error, nullptr);
+            return;
+        }
+        
+        getFromNodeAsync(node, key, handler);
+    });
+}
+
+// receives the data from the given (responsible) node
+void Chord::getFromNodeAsync (ChordHeaderNode node, ChordId key, ChordGetHandler handler)
+{
+    // we are responsible
+    if (ntohId(node.nodeId) == _ownNode->getNodeID()) {
+        handler(std::exception_ptr(), getDataWithKey(key));
+        return;
+    }
+    
+    std::shared_ptr<ChordNode> responsibleNode { nodeForHeaderNode(node) };
+    responsibleNode->establishSendConnection();
+    responsibleNode->requestDataForKeyAsync(key, handler);
+}
+
+std::future<std::shared_ptr<uint8_t>> Chord::getAsync (ChordId key)
+{
+    std::shared_ptr<std::promise<std::shared_ptr<uint8_t>>> promise { std::make_shared<std::promise<std::shared_ptr<uint8_t>>>() };
+    
+    getAsync(key, [promise] (std::exception_ptr error, std::shared_ptr<uint8_t> data) {
+        if (error) {
+            promise->set_exception(error);
+        } else {
+            promise->set_value(data);
+        }
+    });
+    
+    return promise->get_future();
+}
+
+// adds the data to the responsible node (content key)
+void Chord::putAsync (std::shared_ptr<uint8_t> data, ChordPutHandler handler)
+{
+    putAsync(ChordHash::keyForData(data), data, handler);
+}
+
+std::future<bool> Chord::putAsync (std::shared_ptr<uint8_t> data)
+{
+    return putAsync(ChordHash::keyForData(data), data);
+}
+
+// adds the data with an application key to the responsible node
+void Chord::putAsync (ChordId key, std::shared_ptr<uint8_t> data, ChordPutHandler handler)
+{
+    ChordHeaderNode cachedNode;
+    
+    if (keyIsInMyRange(key) || !_locationCache.find(key, &cachedNode)) {
+        lookupAndPutAsync(key, data, handler);
+        return;
+    }
+    
+    // send to the cached responsible node directly
+    std::shared_ptr<ChordNode> responsibleNode { nodeForHeaderNode(cachedNode) };
+    responsibleNode->establishSendConnection();
+    responsibleNode->addDataAsync(key, data, [this, key, data, cachedNode, handler] (std::exception_ptr error, bool added) {
+        
+        if (!error && added) {
+            handler(error, added);
+            return;
+        }
+        
+        // the cached node is dead or refused the data (not responsible anymore)
+        _locationCache.removeNode(ntohId(cachedNode.nodeId));
+        lookupAndPutAsync(key, data, handler);
+    });
+}
+
+// searches the responsible node and adds the data there
+void Chord::lookupAndPutAsync (ChordId key, std::shared_ptr<uint8_t> data, ChordPutHandler handler)
+{
+    lookupAsync(key, [this, key, data, handler] (std::exception_ptr error, ChordHeaderNode node) {
+        
+        if (error) {
+            handler(error, false);
+            return;
+        }
+        
+        // we are responsible
+        if (ntohId(node.nodeId) == _ownNode->getNodeID()) {
+            handler(std::exception_ptr(), addDataToHashMap(key, data));
+            return;
+        }
+        
+        std::shared_ptr<ChordNode> responsibleNode { nodeForHeaderNode(node) };
+        responsibleNode->establishSendConnection();
+        responsibleNode->addDataAsync(key, data, handler);
+    });
+}
+
+std::future<bool> Chord::putAsync (ChordId key, std::shared_ptr<uint8_t> data)
+{
+    std::shared_ptr<std::promise<bool>> promise { std::make_shared<std::promise<bool>>() };
+    
+    putAsync(key, data, [promise] (std::exception_ptr error, bool added) {
+        if (error) {
+            promise->set_exception(error);
+        } else {
+            promise->set_value(added);
+        }
+    });
+    
+    return promise->get_future();
+}
+
+// receives the data of several keys (one request per responsible node)
+void Chord::multiGetAsync (std::vector<ChordId> keys, ChordMultiGetHandler handler)
+{
+    multiGetAsync(keys, true, handler);
+}
+
+std::future<std::map<ChordId, std::shared_ptr<uint8_t>>> Chord::multiGetAsync (std::vector<ChordId> keys)
+{
+    std::shared_ptr<std::promise<std::map<ChordId, std::shared_ptr<uint8_t>>>> promise {
+        std::make_shared<std::promise<std::map<ChordId, std::shared_ptr<uint8_t>>>>() };
+    
+    multiGetAsync(keys, [promise] (std::exception_ptr error, std::map<ChordId, std::shared_ptr<uint8_t>> data) {
+        if (error) {
+            promise->set_exception(error);
+        } else {
+            promise->set_value(data);
+        }
+    });
+    
+    return promise->get_future();
+}
+
+// adds several data items (one batched transfer per responsible node)
+void Chord::multiPutAsync (std::vector<ChordDataItem> items, ChordPutHandler handler)
+{
+    multiPutAsync(items, true, handler);
+}
+
+std::future<bool> Chord::multiPutAsync (std::vector<ChordDataItem> items)
+{
+    std::shared_ptr<std::promise<bool>> promise { std::make_shared<std::promise<bool>>() };
+    
+    multiPutAsync(items, [promise] (std::exception_ptr error, bool added) {
+        if (error) {
+            promise->set_exception(error);
+        } else {
+            promise->set_value(added);
+        }
+    });
+    
+    return promise->get_future();
+}
+
+// update predecessor if needed
+// returns new predecessor
+ChordHeaderNode Chord::updatePredecessor (ChordHeaderNode node)
+{
+    // two workers mustn't decide on the same old predecessor
+    _updatePredecessor_mutex.lock();
+    
+    std::shared_ptr<ChordNode> oldPredecessor { currentPredecessor() };
+    
+    // if there is currently no predecessor
+    // just accept
+    if (!oldPredecessor) {
+        
+        setPredecessor(node);
+    } else
+        
+        // check special case
+        if (oldPredecessor->getNodeID() > _ownNode->getNodeID()) {
+            // new predecessor between 0 and my node id
+            if (ntohId(node.nodeId) < _ownNode->getNodeID()) {
+                
+                setPredecessor(node);
+            } else
+                
+                // new predecessor between my old predecessor and me
+                if (ntohId(node.nodeId) > oldPredecessor->getNodeID()) {
+                    setPredecessor(node);
+                }
+        } else
+            
+            // accept if new predecessor fits
+            if (ntohId(node.nodeId) > oldPredecessor->getNodeID() && ntohId(node.nodeId) < _ownNode->getNodeID()) {
+                
+                setPredecessor(node);
+            }
+    
+    std::shared_ptr<ChordNode> predecessor { currentPredecessor() };
+    
+    _updatePredecessor_mutex.unlock();
+    
+    // the old predecessor would find the new node with its next (maybe backed off) stabilize round
+    if (oldPredecessor && oldPredecessor != predecessor && oldPredecessor->getNodeID() != ntohId(node.nodeId)) {
+        oldPredecessor->establishSendConnection();
+        oldPredecessor->suggestSuccessorAsync(node);
+    }
+    
+    // stabilize may have dropped a dead predecessor meanwhile
+    return predecessor ? predecessor->chordNode() : node;
+}
+
+// our successor told us about a node that joined between us
+void Chord::successorSuggested (ChordHeaderNode node)
+{
+    std::shared_ptr<ChordNode> successor { currentSuccessor() };
+    
+    if (successor && keyIsBetween(ntohId(node.nodeId), _ownNode->getNodeID(), successor->getNodeID())) {
+        membershipChanged();
+    }
+}
+
+// searches all data from chord for given node id
+// returns nullptr if not found
+std::shared_ptr<ChordNode> Chord::findNodeWithId (ChordId nodeId)
+{
+    // check if node is ownNode
+    if (_ownNode->getNodeID() == nodeId) {
+        return _ownNode;
+    }
+    
+    // check if node is successor
+    std::shared_ptr<ChordNode> successor { currentSuccessor() };
+    if (successor) {
+        if (successor->getNodeID() == nodeId) {
+            return successor;
+        }
+    }
+    
+    // check if node is predecessor
+    std::shared_ptr<ChordNode> predecessor { currentPredecessor() };
+    if (predecessor) {
+        if (predecessor->getNodeID() == nodeId) {
+            return predecessor;
+        }
+    }
+    
+    // check if node is in fingertable
+    _fingerTable_mutex.lock();
+    for (std::shared_ptr<ChordNode> node : _fingerTable) {
+        if (node && node->getNodeID() == nodeId) {
+            
+            _fingerTable_mutex.unlock();
+            return node;
+        }
+    }
+    _fingerTable_mutex.unlock();
+    
+    // check if node is in connected node list
+    _connectedNodes_mutex.lock();
+    for (std::shared_ptr<ChordNode> node : _connectedNodes) {
+        if (node->getNodeID() == nodeId) {
+            
+            _connectedNodes_mutex.unlock();
+            return node;
+        }
+    }
+    _connectedNodes_mutex.unlock();
+    
+    return nullptr;
+}
+
+// adds data from remote node to local data map - if we are responsible
+// returns true on success
+// returns false if we aren't responsible
+bool Chord::addDataToHashMap (ChordId key, std::shared_ptr<uint8_t> data)
+{
+    CHORD_LOGV("Chord::addDataToHashMap(): " << key);
+    
+    if (keyIsInMyRange(key)) {
+        // add data to dataMap
+        _dataMap->put(key, data); // hint: if there was already a value it will be replaced
+        _replicaMap->remove(key);
+        
+        // keep copies on our successors
+        replicateData(key, data);
+        
+        return true;
+    }
+    
+    return false;
+}
+
+// adds all items we are responsible for - the replicas are send as one batch
+// returns false if we aren't responsible for any of them
+bool Chord::addDataItemsToHashMap (const std::vector<ChordDataItem> &items)
+{
+    std::shared_ptr<std::vector<ChordDataItem>> addedItems { std::make_shared<std::vector<ChordDataItem>>() };
+    
+    for (const ChordDataItem &item : items) {
+        if (keyIsInMyRange(item.first)) {
+            _dataMap->put(item.first, item.second);
+            _replicaMap->remove(item.first);
+            addedItems->push_back(item);
+        }
+    }
+    
+    // keep copies on our successors
+    replicateItems(addedItems);
+    
+    return addedItems->size() == items.size();
+}
+
+// adds a copy of data one of our predecessors is responsible for
+void Chord::addReplicaToHashMap (ChordId key, std::shared_ptr<uint8_t> data)
+{
+    CHORD_LOGV("Chord::addReplicaToHashMap(): " << key);
+    
+    _replicaMap->put(key, data); // hint: if there was already a value it will be replaced
+}
+
+// searches local data for data id and returns the data
+// returns nullptr if there is no data with that key
+std::shared_ptr<uint8_t> Chord::getDataWithKey (ChordId dataId)
+{
+    // find id in data map
+    std::shared_ptr<uint8_t> data { _dataMap->get(dataId) };
+    
+    // the responsible node may have died - answer with our copy
+    if (!data) {
+        data = _replicaMap->get(dataId);
+    }
+    
+    // the replica may have been promoted between both gets
+    if (!data) {
+        data = _dataMap->get(dataId);
+    }
+    
+    // nullptr if not found
+    return data;
+}
+
+
+// number of nodes that store each data
+void Chord::setReplicationFactor (int replicationFactor)
+{
+    // we only know kSuccessorListLength successors
+    _replicationFactor = std::max(1, std::min(replicationFactor, kSuccessorListLength + 1));
+}
+
+// takes over a new connection after its identify message was received
+void Chord::adoptConnection (std::shared_ptr<ChordConnection> connection, ChordHeader identifyHeader,
+                             std::shared_ptr<uint8_t> identifyData)
+{
+    // print received header for debug
+    struct in_addr ip { 0 };
+    ip.s_addr = ntohl(identifyHeader.node.ip);
+    
+    ChordId nodeId { 0 };
+    std::string ipAddress { "" };
+    uint16_t port { 0 };
+    
+    switch (identifyHeader.type) {
+        case ChordMessageTypeIdentify:
+        {
+            CHORD_LOGV("received Identify message");
+            
+            // a node with another id width can't share our ring
+            if (!identifyData || ntohl(identifyHeader.dataSize) != kIdentifyDataSize ||
+                identifyData.get()[sizeof(ChordId)] != ChordIdRing::kKeyLength) {
+                CHORD_LOGE("Chord::adoptConnection(): node with another id width - close connection");
+                connection->close();
+                break;
+            }
+            
+            // set values from header
+            nodeId = ntohId(identifyHeader.node.nodeId);
+            ipAddress = inet_ntoa(ip);
+            port = ntohs(identifyHeader.node.port);
+            
+            // check if there is already a node with this id
+            std::shared_ptr<ChordNode> node = findNodeWithId(nodeId);
+            
+            // don't found node with given id
+            if (node == nullptr) {
+                CHORD_LOGV("Chord::adoptConnection(): node don't exists - creating");
+                
+                // create new chord node and append to existing list
+                std::shared_ptr<ChordNode> newChordNode;
+                newChordNode = std::make_shared<ChordNode>(nodeId, ipAddress, port, _weakSelf);
+                newChordNode->setReceiveConnection(connection);
+                
+                _connectedNodes_mutex.lock();
+                _connectedNodes.push_back(newChordNode);
+                _connectedNodes_mutex.unlock();
+                
+            } else {
+                CHORD_LOGV("Chord::adoptConnection(): already exists - setting receive connection");
+                // start receiving messages
+                node->setReceiveConnection(connection);
+            }
+            
+            break;
+        }
+            
+        default:
+        {
+            CHORD_LOGV("Chord::adoptConnection(): node don't identified - close connection");
+            connection->close();
+            break;
+        }
+    }
+}
+
+// all metrics of this node as text
+std::string Chord::metricsSnapshot ()
+{
+    std::string labels { std::string("node=\"") += std::to_string(_nodeId) += "\"" };
+    
+    std::stringstream text;
+    text << _metrics->snapshot(labels);
+    
+    // virtual nodes of one host share the stores
+    text << "chord_data_items{" << labels << "} " << _dataMap->size() << std::endl;
+    text << "chord_replica_items{" << labels << "} " << _replicaMap->size() << std::endl;
+    
+    _connectedNodes_mutex.lock();
+    std::list<std::shared_ptr<ChordNode>> connectedNodes { _connectedNodes };
+    _connectedNodes_mutex.unlock();
+    
+    text << "chord_connected_nodes{" << labels << "} " << connectedNodes.size() << std::endl;
+    text << "chord_stabilize_interval_ms{" << labels << "} " << _stabilizeInterval.interval().count() << std::endl;
+    text << "chord_fix_fingers_interval_ms{" << labels << "} " << _fixFingersInterval.interval().count() << std::endl;
+    
+    for (std::shared_ptr<ChordNode> node : connectedNodes) {
+        std::string peerLabels { ((std::string("{") += labels) += ",peer=\"") += std::to_string(node->getNodeID()) += "\"} " };
+        
+        text << "chord_peer_messages_sent_total" << peerLabels << node->messagesSent() << std::endl;
+        text << "chord_peer_messages_received_total" << peerLabels << node->messagesReceived() << std::endl;
+        text << "chord_peer_bytes_sent_total" << peerLabels << node->bytesSent() << std::endl;
+        text << "chord_peer_bytes_received_total" << peerLabels << node->bytesReceived() << std::endl;
+    }
+    
+    return text.str();
+}
+
+// serves metricsSnapshot() on the unix domain socket
+bool Chord::startMetricsServer (std::string socketPath)
+{
+    // the server is stopped by our destructor before we are gone
+    std::unique_ptr<ChordMetricsServer> server { new ChordMetricsServer(socketPath, [this] () {
+        return metricsSnapshot();
+    }) };
+    
+    if (!server->start()) {
+        return false;
+    }
+    
+    _metricsServer = std::move(server);
+    return true;
+}
+
+#pragma mark - Private
+
+// chooses the node id from the configuration
+ChordId Chord::nodeIdForConfiguration (std::string ipAddress, uint16_t port, std::string identity)
+{
+    // the id only depends on the configuration - no random numbers
+    // (so nodes can be started at the same time and keep their id on restart)
+    return identity.empty() ? ChordHash::keyForNode(ipAddress, port) : ChordHash::keyForString(identity);
+}
+
+// creates our own node with the given id
+void Chord::initOwnNode (ChordId nodeId, std::string ipAddress, uint16_t port)
+{
+    CHORD_LOGV("We are Node with ID: " << nodeId);
+    _ownNode = std::make_shared<ChordNode>(nodeId, ipAddress, port, _weakSelf);
+}
+
+// waits (transport) for incomming connections on our address
+void Chord::startListening ()
+{
+    std::weak_ptr<Chord> weakChord { _weakSelf };
+    
+    _listening = _transport->listen(_ipAddress, _port, [weakChord] (std::shared_ptr<ChordConnection> connection) {
+        std::shared_ptr<Chord> chord { weakChord.lock() };
+        
+        if (!chord) {
+            connection->close();
+            return;
+        }
+        
+        chord->acceptConnection(connection);
+    });
+}
+
+// waits for the identify message of an incomming connection (called by transport)
+// the connection will be handled as soon as the remote node identifies itself
+void Chord::acceptConnection (std::shared_ptr<ChordConnection> connection)
+{
+    CHORD_LOGV("Chord::acceptConnection(): client connected ...");
+    
+    std::weak_ptr<Chord> weakChord { _weakSelf };
+    // the connection holds the handler - don't create a cycle
+    std::weak_ptr<ChordConnection> weakConnection { connection };
+    
+    // the first message has to be the identify message
+    // the node's handler takes over the connection for the following messages
+    connection->receive([weakChord, weakConnection] (ChordHeader header, std::shared_ptr<uint8_t> data) {
+        std::shared_ptr<Chord> chord { weakChord.lock() };
+        std::shared_ptr<ChordConnection> connection { weakConnection.lock() };
+        
+        if (!connection) {
+            return;
+        }
+        
+        if (!chord) {
+            connection->close();
+            return;
+        }
+        
+        chord->adoptConnection(connection, header, data);
+        
+    }, [] () {
+        CHORD_LOGV("Chord::acceptConnection(): connection closed before identify");
+    });
+}
+
+// join existing DHT using given ip and port
+void Chord::joinDHT (std::string c_ipAddress, uint16_t c_port)
+{
+    // we can use NodeID = 0
+    // 1. we don't know the id
+    // 2. we will delete this node after using to join the dht
+    
+    std::shared_ptr<ChordNode> joinNode;
+    joinNode = std::make_shared<ChordNode>(0, c_ipAddress, c_port, _weakSelf);
+    ChordConnectionStatus joinStatus = joinNode->establishSendConnection();
+    
+    // check if connection could be established
+    if (joinStatus == ChordConnectionStatusConnectingFailed) {
+        CHORD_LOGE("failed to join dht while connecting to: " << c_ipAddress << " on port: " << c_port);
+        exit(EXIT_FAILURE); // we cannot join --> terminate app
+    }
+    
+    ChordHeaderNode successorNode;
+    try {
+        successorNode = joinNode->searchForKey(_ownNode->getNodeID()); // search our id
+    } catch (ChordConnectionException &exception) {
+        CHORD_LOGE("failed to join dht while searching for key: " << _ownNode->getNodeID() << " with error: " << exception.what());
+        exit(EXIT_FAILURE); // we cannot join --> terminate app
+    }
+    struct in_addr successorIP;
+    successorIP.s_addr = ntohl(successorNode.ip);
+    
+    // the node responsible for our id has the same id -> it would be overwritten
+    if (ntohId(successorNode.nodeId) == _ownNode->getNodeID()) {
+        CHORD_LOGE("failed to join dht: node id " << _ownNode->getNodeID()
+                   << " is already used by " << inet_ntoa(successorIP) << ":" << ntohs(successorNode.port));
+        exit(EXIT_FAILURE); // we cannot join --> terminate app (choose another identity or salt)
+    }
+    
+    std::shared_ptr<ChordNode> successor { std::make_shared<ChordNode>(ntohId(successorNode.nodeId), inet_ntoa(successorIP), ntohs(successorNode.port), _weakSelf) };
+    
+    _connectedNodes_mutex.lock();
+    _connectedNodes.push_back(successor);
+    _connectedNodes_mutex.unlock();
+    
+    CHORD_LOGV("received successor node: " << successor->description());
+    
+    // we shouldn't be responsible for all that, but we may receive keys from our successor,
+    // so don't throw them back to successor
+    _neighbours_mutex.lock();
+    _successor = successor;
+    _responsibilityRange = (ChordRange){ .from=static_cast<ChordId>(ntohId(successorNode.nodeId) +1), .to=_ownNode->getNodeID()};
+    _neighbours_mutex.unlock();
+    
+    // connect
+    successor->establishSendConnection();
+    
+    // fill finger table with successor
+    // the fix fingers protocol will replace them with the correct nodes
+    _fingerTable_mutex.lock();
+    _fingerTable.assign(kKeyLenght, successor);
+    _fingerTable_mutex.unlock();
+}
+
+// sets the given node as predecessor
+inline void Chord::setPredecessor (ChordHeaderNode node)
+{
+    // search for ChordNode and apply to predecessor
+    std::shared_ptr<ChordNode> predecessor { findNodeWithId(ntohId(node.nodeId)) };
+    
+    // if not found - create node
+    if (!predecessor) {
+        
+        // we don't have this node yet -> create new
+        struct in_addr predecessorIP { ntohl(node.ip) };
+        predecessor = std::make_shared<ChordNode>(ntohId(node.nodeId), inet_ntoa(predecessorIP), ntohs(node.port), _weakSelf);
+        
+        _connectedNodes_mutex.lock();
+        _connectedNodes.push_back(predecessor);
+        _connectedNodes_mutex.unlock();
+    }
+    
+    // the range we were responsible for until now
+    // (the store may be shared with other virtual nodes - only touch our own slice)
+    ChordId ownId { _ownNode->getNodeID() };
+    ChordId newPredecessorId { ntohId(node.nodeId) };
+    
+    // lookups of the workers see the new predecessor and range together
+    _neighbours_mutex.lock();
+    
+    _predecessor = predecessor;
+    
+    ChordId oldPredecessorId { static_cast<ChordId>(_responsibilityRange.from - 1) };
+    bool rangeWasKnown { _responsibilityRangeKnown };
+    
+    // the whole ring begins behind our own id
+    if (_responsibilityRange.from == _responsibilityRange.to ||
+        (_responsibilityRange.from == 0 && _responsibilityRange.to == highestID())) {
+        oldPredecessorId = ownId;
+    }
+    
+    // update responsibility
+    _responsibilityRange.from = newPredecessorId +1;
+    _responsibilityRange.to = ownId;
+    _responsibilityRangeKnown = true;
+    
+    _neighbours_mutex.unlock();
+    
+    // a node joined in front of us (or our predecessor was replaced)
+    membershipChanged();
+    
+    // until our first predecessor was known the range was only a guess (see joinDHT)
+    // the data we got meanwhile came from our successor and belongs to us
+    if (!rangeWasKnown || newPredecessorId == oldPredecessorId) {
+        return;
+    }
+    
+    // our range grew (f.e. our old predecessor died) - (newPredecessor, oldPredecessor]
+    if (!ChordIdRing::isBetween(newPredecessorId, oldPredecessorId, ownId)) {
+        promoteReplicas(static_cast<ChordId>(newPredecessorId + 1), oldPredecessorId);
+        return;
+    }
+    
+    // transfer keys
+    std::shared_ptr<std::vector<ChordDataItem>> dataToTransfer { std::make_shared<std::vector<ChordDataItem>>() };
+    
+    // remove the slice the new predecessor took over from local map - (oldPredecessor, newPredecessor]
+    // we are the successor of the new owner - so we keep a copy
+    _dataMap->removeRange(static_cast<ChordId>(oldPredecessorId + 1), newPredecessorId, dataToTransfer.get());
+    
+    if (_replicationFactor > 1) {
+        for (auto item : *dataToTransfer) {
+            _replicaMap->put(item.first, item.second);
+        }
+    }
+    
+    if (dataToTransfer->empty()) {
+        return;
+    }
+    
+    // stream the data to predecessor (batched, acknowledged in bulk)
+    CHORD_LOGV("Chord::setPredecessor(): transfer data to predecessor: " << dataToTransfer->size());
+    
+    predecessor->establishSendConnection();
+    predecessor->transferDataAsync(dataToTransfer, [predecessor] (std::exception_ptr error, bool added) {
+        if (error || !added) {
+            CHORD_LOGE("Chord::setPredecessor(): couldn't transfer all data to: " << predecessor->description());
+        }
+    });
+}
+
+// copy of our successor (nullptr if unknown)
+std::shared_ptr<ChordNode> Chord::currentSuccessor () const
+{
+    _neighbours_mutex.lock();
+    std::shared_ptr<ChordNode> successor { _successor };
+    _neighbours_mutex.unlock();
+    
+    return successor;
+}
+
+// copy of our predecessor (nullptr if unknown)
+std::shared_ptr<ChordNode> Chord::currentPredecessor () const
+{
+    _neighbours_mutex.lock();
+    std::shared_ptr<ChordNode> predecessor { _predecessor };
+    _neighbours_mutex.unlock();
+    
+    return predecessor;
+}
+
+// copy of the range that i'm responsible for
+ChordRange Chord::responsibilityRange () const
+{
+    _neighbours_mutex.lock();
+    ChordRange range { _responsibilityRange };
+    _neighbours_mutex.unlock();
+    
+    return range;
+}
+
+// replaces the successor
+void Chord::setSuccessor (std::shared_ptr<ChordNode> node)
+{
+    _neighbours_mutex.lock();
+    _successor = node;
+    _neighbours_mutex.unlock();
+}
+
+// multi get - keys of cached nodes that failed are retried without cache
+void Chord::multiGetAsync (std::vector<ChordId> keys, bool useCache, ChordMultiGetHandler handler)
+{
+    groupKeysByNode(keys, useCache, [this, useCache, handler] (std::exception_ptr error, ChordKeysByNode groups) {
+        
+        std::shared_ptr<ChordMultiRequest> request { std::make_shared<ChordMultiRequest>() };
+        request->error = error;
+        request->pendingRequests = groups.size();
+        
+        if (groups.empty()) {
+            handler(request->error, request->data);
+            return;
+        }
+        
+        for (auto group : groups) {
+            
+            std::vector<ChordId> groupKeys { group.second.second };
+            
+            // the node may not be responsible anymore (cache) -> retry missing keys
+            bool retryMissingKeys { useCache && group.first != _ownNode->getNodeID() };
+            
+            // collects the data of every node
+            auto completion = [this, request, retryMissingKeys, groupKeys, handler] (std::exception_ptr error, std::map<ChordId, std::shared_ptr<uint8_t>> data) {
+                
+                request->mutex.lock();
+                request->data.insert(data.begin(), data.end());
+                
+                if (retryMissingKeys) {
+                    for (ChordId key : groupKeys) {
+                        if (data.find(key) == data.end()) {
+                            request->retryKeys.push_back(key);
+                        }
+                    }
+                } else if (error && !request->error) {
+                    request->error = error;
+                }
+                
+                bool done { --request->pendingRequests == 0 };
+                request->mutex.unlock();
+                
+                if (!done) {
+                    return;
+                }
+                
+                if (request->retryKeys.empty()) {
+                    handler(request->error, request->data);
+                    return;
+                }
+                
+                multiGetAsync(request->retryKeys, false, [request, handler] (std::exception_ptr error, std::map<ChordId, std::shared_ptr<uint8_t>> data) {
+                    request->data.insert(data.begin(), data.end());
+                    handler(request->error ? request->error : error, request->data);
+                });
+            };
+            
+            // we are responsible
+            if (group.first == _ownNode->getNodeID()) {
                 
-                // if we can't find a responsible node -> what to do now ?
-                // i return myself -> helps joining nodes, but won't help if search was for adding / receiving data
-                responsibleNode.nodeId = htons(_ownNode->getNodeID());
-                responsibleNode.ip = htonl(inet_addr(_ownNode->getIPAddress().c_str()));
-                responsibleNode.port = htons(_ownNode->getPort());
+                std::map<ChordId, std::shared_ptr<uint8_t>> data;
+                for (ChordId key : groupKeys) {
+                    std::shared_ptr<uint8_t> foundData { getDataWithKey(key) };
+                    if (foundData) {
+                        data[key] = foundData;
+                    }
+                }
+                completion(std::exception_ptr(), data);
+                continue;
             }
+            
+            std::shared_ptr<ChordNode> responsibleNode { nodeForHeaderNode(group.second.first) };
+            responsibleNode->establishSendConnection();
+            responsibleNode->requestDataForKeysAsync(groupKeys, [this, group, completion] (std::exception_ptr error, std::map<ChordId, std::shared_ptr<uint8_t>> data) {
+                if (error) {
+                    _locationCache.removeNode(group.first);
+                }
+                completion(error, data);
+            });
         }
-        
-    } catch (ChordConnectionException &exception) {
-        Log::sharedLog()->error(std::string("Chord::searchForKey: ") += exception.what());
-        // TODO: what to do if we can't receive the responsible node ?
-        // if we can't find a responsible node return self -> what to do now ?
-        responsibleNode.nodeId = htons(_ownNode->getNodeID());
-        responsibleNode.ip = htonl(inet_addr(_ownNode->getIPAddress().c_str()));
-        responsibleNode.port = htons(_ownNode->getPort());
-    }
-    
-    RGPLOGV((std::string("search result for key (") += std::to_string(key) += ") ") += std::to_string(ntohs(responsibleNode.nodeId)));
-    
-    return responsibleNode;
+    });
 }
 
-// update predecessor if needed
-// returns new predecessor
-ChordHeaderNode Chord::updatePredecessor (ChordHeaderNode node)
+// multi put - items of cached nodes that failed are retried without cache
+void Chord::multiPutAsync (std::vector<ChordDataItem> items, bool useCache, ChordPutHandler handler)
 {
-    // if there is currently no predecessor
-    // just accept
-    if (!_predecessor) {
+    std::shared_ptr<std::map<ChordId, std::shared_ptr<uint8_t>>> dataForKey {
+        std::make_shared<std::map<ChordId, std::shared_ptr<uint8_t>>>(items.begin(), items.end()) };
+    
+    std::vector<ChordId> keys;
+    for (auto item : *dataForKey) {
+        keys.push_back(item.first);
+    }
+    
+    groupKeysByNode(keys, useCache, [this, useCache, dataForKey, handler] (std::exception_ptr error, ChordKeysByNode groups) {
         
-        setPredecessor(node);
-    } else
+        std::shared_ptr<ChordMultiRequest> request { std::make_shared<ChordMultiRequest>() };
+        request->error = error;
+        request->added = !error;
+        request->pendingRequests = groups.size();
         
-        // check special case
-        if (_predecessor->getNodeID() > _ownNode->getNodeID()) {
-            // new predecessor between 0 and my node id
-            if (ntohs(node.nodeId) < _ownNode->getNodeID()) {
+        if (groups.empty()) {
+            handler(request->error, request->added);
+            return;
+        }
+        
+        for (auto group : groups) {
+            
+            std::shared_ptr<std::vector<ChordDataItem>> groupItems { std::make_shared<std::vector<ChordDataItem>>() };
+            for (ChordId key : group.second.second) {
+                groupItems->push_back(ChordDataItem(key, (*dataForKey)[key]));
+            }
+            
+            // the node may not be responsible anymore (cache) -> retry the items
+            bool retryFailedItems { useCache && group.first != _ownNode->getNodeID() };
+            
+            auto completion = [this, request, retryFailedItems, groupItems, handler] (std::exception_ptr error, bool added) {
                 
-                setPredecessor(node);
-            } else
+                request->mutex.lock();
                 
-                // new predecessor between my old predecessor and me
-                if (ntohs(node.nodeId) > _predecessor->getNodeID()) {
-                    setPredecessor(node);
+                if (retryFailedItems && (error || !added)) {
+                    request->retryItems.insert(request->retryItems.end(), groupItems->begin(), groupItems->end());
+                } else {
+                    request->added = request->added && added && !error;
+                    if (error && !request->error) {
+                        request->error = error;
+                    }
                 }
-        } else
+                
+                bool done { --request->pendingRequests == 0 };
+                request->mutex.unlock();
+                
+                if (!done) {
+                    return;
+                }
+                
+                if (request->retryItems.empty()) {
+                    handler(request->error, request->added);
+                    return;
+                }
+                
+                multiPutAsync(request->retryItems, false, [request, handler] (std::exception_ptr error, bool added) {
+                    handler(request->error ? request->error : error, request->added && added);
+                });
+            };
             
-            // accept if new predecessor fits
-            if (ntohs(node.nodeId) > _predecessor->getNodeID() && ntohs(node.nodeId) < _ownNode->getNodeID()) {
+            // we are responsible
+            if (group.first == _ownNode->getNodeID()) {
                 
-                setPredecessor(node);
+                completion(std::exception_ptr(), addDataItemsToHashMap(*groupItems));
+                continue;
             }
-    
-    return _predecessor->chordNode();
+            
+            std::shared_ptr<ChordNode> responsibleNode { nodeForHeaderNode(group.second.first) };
+            responsibleNode->establishSendConnection();
+            responsibleNode->transferDataAsync(groupItems, [this, group, completion] (std::exception_ptr error, bool added) {
+                if (error || !added) {
+                    _locationCache.removeNode(group.first);
+                }
+                completion(error, added);
+            });
+        }
+    });
 }
 
-// searches all data from chord for given node id
-// returns nullptr if not found
-std::shared_ptr<ChordNode> Chord::findNodeWithId (ChordId nodeId)
+// looks up the responsible nodes of all keys (in parallel)
+void Chord::groupKeysByNode (std::vector<ChordId> keys, bool useCache,
+                             std::function<void (std::exception_ptr error, ChordKeysByNode groups)> handler)
 {
-    // check if node is ownNode
-    if (_ownNode->getNodeID() == nodeId) {
-        return _ownNode;
-    }
+    std::shared_ptr<ChordKeyGrouping> grouping { std::make_shared<ChordKeyGrouping>() };
+    grouping->handler = handler;
     
-    // check if node is successor
-    if (_successor) {
-        if (_successor->getNodeID() == nodeId) {
-            return _successor;
+    // keys we are responsible for (or of cached ranges) don't need a lookup
+    std::set<ChordId> uniqueKeys { keys.begin(), keys.end() };
+    std::set<ChordId> remoteKeys;
+    for (ChordId key : uniqueKeys) {
+        
+        ChordHeaderNode cachedNode;
+        
+        if (keyIsInMyRange(key)) {
+            auto &group = grouping->groups[_ownNode->getNodeID()];
+            group.first = _ownNode->chordNode();
+            group.second.push_back(key);
+        } else if (useCache && _locationCache.find(key, &cachedNode)) {
+            auto &group = grouping->groups[ntohId(cachedNode.nodeId)];
+            group.first = cachedNode;
+            group.second.push_back(key);
+        } else {
+            remoteKeys.insert(key);
         }
     }
     
-    // check if node is predecessor
-    if (_predecessor) {
-        if (_predecessor->getNodeID() == nodeId) {
-            return _predecessor;
-        }
+    if (remoteKeys.empty()) {
+        handler(std::exception_ptr(), grouping->groups);
+        return;
     }
     
-    // TODO: check if node is in fingertable
+    grouping->pendingLookups = remoteKeys.size();
     
-    // check if node is in connected node list
-    _connectedNodes_mutex.lock();
-    for (std::shared_ptr<ChordNode> node : _connectedNodes) {
-        if (node->getNodeID() == nodeId) {
+    for (ChordId key : remoteKeys) {
+        lookupAsync(key, [grouping, key] (std::exception_ptr error, ChordHeaderNode node) {
             
-            _connectedNodes_mutex.unlock();
-            return node;
-        }
+            grouping->mutex.lock();
+            if (error) {
+                if (!grouping->error) {
+                    grouping->error = error;
+                }
+            } else {
+                auto &group = grouping->groups[ntohId(node.nodeId)];
+                group.first = node;
+                group.second.push_back(key);
+            }
+            bool done { --grouping->pendingLookups == 0 };
+            grouping->mutex.unlock();
+            
+            if (done) {
+                grouping->handler(grouping->error, grouping->groups);
+            }
+        });
     }
-    _connectedNodes_mutex.unlock();
-    
-    return nullptr;
 }
 
-// adds data from remote node to local data map - if we are responsible
-// returns true on success
-// returns false if we aren't responsible
-bool Chord::addDataToHashMap (std::shared_ptr<uint8_t> data)
+// sends copies of the data to the next replicationFactor-1 successors
+void Chord::replicateData (ChordId key, std::shared_ptr<uint8_t> data)
 {
-    // create hash
-    int dataHash = std::hash<std::shared_ptr<uint8_t>>()(data) % highestID();
+    int replicas { _replicationFactor - 1 };
+    if (replicas < 1) {
+        return;
+    }
     
-    RGPLOGV((std::string("Chord::addDataToHashMap(): ") += std::to_string(dataHash)));
+    _successorList_mutex.lock();
+    std::vector<std::shared_ptr<ChordNode>> successorList { _successorList };
+    _successorList_mutex.unlock();
     
-    if (keyIsInMyRange(dataHash)) {
-        // add data to dataMap
-        _dataMap_mutex.lock();
-        _dataMap[dataHash] = data; // hint: if there was already a value it will be replaced
-        _dataMap_mutex.unlock();
+    for (int k = 0; k < replicas && k < static_cast<int>(successorList.size()); k++) {
         
-        return true;
+        std::shared_ptr<ChordNode> node { successorList[k] };
+        
+        // a small ring may contain ourself
+        if (node == _ownNode) {
+            continue;
+        }
+        
+        // don't wait for the replicas
+        node->establishSendConnection();
+        node->addReplicaAsync(key, data, [node] (std::exception_ptr error, bool added) {
+            if (error || !added) {
+                CHORD_LOGE("Chord::replicateData(): couldn't add replica to: " << node->description());
+            }
+        });
     }
-    
-    return false;
 }
 
-// searches local data for data id and returns the data
-// returns nullptr if there is no data with that key
-std::shared_ptr<uint8_t> Chord::getDataWithKey (ChordId dataId)
+// sends copies of all items to the next replicationFactor-1 successors
+void Chord::replicateItems (std::shared_ptr<std::vector<ChordDataItem>> items)
 {
-    _dataMap_mutex.lock();
+    int replicas { _replicationFactor - 1 };
+    if (replicas < 1 || items->empty()) {
+        return;
+    }
     
-    // find id in hash map
-    auto iterator = _dataMap.find(dataId);
+    _successorList_mutex.lock();
+    std::vector<std::shared_ptr<ChordNode>> successorList { _successorList };
+    _successorList_mutex.unlock();
     
-    // check if in hash map
-    if (iterator != _dataMap.end()) {
+    for (int k = 0; k < replicas && k < static_cast<int>(successorList.size()); k++) {
         
-        _dataMap_mutex.unlock();
+        std::shared_ptr<ChordNode> node { successorList[k] };
         
-        // returns the data
-        return iterator->second;
+        // a small ring may contain ourself
+        if (node == _ownNode) {
+            continue;
+        }
+        
+        // don't wait for the replicas
+        node->establishSendConnection();
+        node->transferReplicasAsync(items, [node] (std::exception_ptr error, bool added) {
+            if (error || !added) {
+                CHORD_LOGE("Chord::replicateItems(): couldn't add replicas to: " << node->description());
+            }
+        });
     }
+}
+
+// we became responsible for replicas -> make them our own data
+void Chord::promoteReplicas (ChordId from, ChordId to)
+{
+    std::shared_ptr<std::vector<ChordDataItem>> promotedData { std::make_shared<std::vector<ChordDataItem>>() };
     
-    _dataMap_mutex.unlock();
+    // only the slice we took over - the other replicas may belong to other virtual nodes
+    _replicaMap->removeRange(from, to, promotedData.get());
+    for (auto item : *promotedData) {
+        _dataMap->put(item.first, item.second);
+    }
     
-    // not found
-    return nullptr;
+    // the promoted data needs new replicas (one batch)
+    CHORD_LOGV("Chord::promoteReplicas(): promoted replicas: " << promotedData->size());
+    replicateItems(promotedData);
 }
 
+// returns the known node for the given header node
+// or creates (and remembers) a new one
+std::shared_ptr<ChordNode> Chord::nodeForHeaderNode (ChordHeaderNode node)
+{
+    // check if we have a connection already
+    std::shared_ptr<ChordNode> chordNode { findNodeWithId(ntohId(node.nodeId)) };
+    
+    if (!chordNode) {
+        // we don't have this node yet -> create new
+        struct in_addr nodeIP;
+        nodeIP.s_addr = ntohl(node.ip);
+        chordNode = std::make_shared<ChordNode>(ntohId(node.nodeId), inet_ntoa(nodeIP), ntohs(node.port), _weakSelf);
+        
+        _connectedNodes_mutex.lock();
+        _connectedNodes.push_back(chordNode);
+        _connectedNodes_mutex.unlock();
+        
+        // the node may have joined inside a cached range
+        _locationCache.nodeJoined(chordNode->getNodeID());
+    }
+    
+    return chordNode;
+}
 
-#pragma mark - Private
-
-void Chord::initOwnNode (std::string ipAddress, uint16_t port)
+// first id that finger i is responsible for (own node id + 2^i)
+ChordId Chord::fingerStart (int finger) const
 {
-    struct timeval tv;
-    gettimeofday(&tv, NULL);
-    // choose node id for ourself
-    std::srand(static_cast<unsigned int>(tv.tv_usec)); //use current time as seed for random generator
-    ChordId nodeId { static_cast<ChordId>(std::rand() % highestID()) };
-    RGPLOGV(std::string("We are Node with ID: ") += std::to_string(nodeId));
-    _ownNode = std::make_shared<ChordNode>(nodeId, ipAddress, port, shared_from_this());
+    return ChordIdRing::fingerStart(_ownNode->getNodeID(), finger);
 }
 
-void Chord::waitForIncommingConnections ()
+// returns the node of the finger table that most closely precedes key
+// returns nullptr if no finger precedes the key
+std::shared_ptr<ChordNode> Chord::closestPrecedingNode (ChordId key)
 {
-    int listening_port = _ownNode->getPort();
-    
-    // sockets
-    struct sockaddr_in server_sockaddr;
-	int client_socket; // data socket
-	int opt { 1 }; // socket options
+    std::shared_ptr<ChordNode> closestNode { nullptr };
     
-    // init struct
-    memset(&server_sockaddr, 0, sizeof(server_sockaddr)); // fill struct with zeros
-	server_sockaddr.sin_family = AF_INET;
-	server_sockaddr.sin_addr.s_addr = INADDR_ANY;
-	server_sockaddr.sin_port = htons(listening_port);
-    
-    // init server socket
-    int server_socket = socket(AF_INET, SOCK_STREAM, 0);
-    setsockopt(server_socket, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(int));
-    bind(server_socket, (struct sockaddr *)&server_sockaddr, sizeof(server_sockaddr));
-    listen(server_socket, 20);
-    
-    // handle incomming connects
-    while (!_stopConnectThread) {
-        struct sockaddr_in data;
-		unsigned int size = sizeof(struct sockaddr_in);
-        
-        RGPLOGV("Chord::waitForIncommingConnections(): waiting for incomming connection");
-        
-        // wait for incomming connection
-        client_socket = accept(server_socket, (struct sockaddr *)&data, &size);
+    // start with the farthest finger
+    _fingerTable_mutex.lock();
+    for (auto iterator = _fingerTable.rbegin(); iterator != _fingerTable.rend(); ++iterator) {
         
-        RGPLOGV("Chord::waitForIncommingConnections(): client connected ...");
+        std::shared_ptr<ChordNode> finger { *iterator };
         
-        if (client_socket > 0) { // < 0 ==> Error
-            
-            ssize_t readBytes { 0 };
-            ChordHeader requestHeader { };
-            
-            // wait for incomming data
-            if ((readBytes = recv(client_socket, &requestHeader, sizeof(ChordHeader), 0)) <= 0) {
-                if (readBytes == 0) {
-                    RGPLOGV("Chord::waitForIncommingConnections(): Remote Node closed connection");
-                    continue;
-                }
-                Log::sharedLog()->errorWithErrno("Chord::waitForIncommingConnections():recv() ", errno);
-                continue;
-            }
-            
-            // error check
-            if (readBytes != sizeof(ChordHeader)) {
-                Log::sharedLog()->error("Chord::waitForIncommingConnections(): don't received enough data ... something bad happened");
-                continue;
-            }
-            
-            // print received header for debug
-            struct in_addr ip { 0 };
-            ip.s_addr = ntohl(requestHeader.node.ip);
-            
-            ChordId nodeId { 0 };
-            std::string ipAddress { "" };
-            uint16_t port { 0 };
-            
-            switch (requestHeader.type) {
-                case ChordMessageTypeIdentify:
-                {
-                    RGPLOGV("received Identify message");
-                    
-                    // set values from header
-                    nodeId = ntohs(requestHeader.node.nodeId);
-                    ipAddress = inet_ntoa(ip);
-                    port = ntohs(requestHeader.node.port);
-                    
-                    // check if there is already a node with this id
-                    std::shared_ptr<ChordNode> node = findNodeWithId(nodeId);
-                    
-                    // don't found node with given id
-                    if (node == nullptr) {
-                        RGPLOGV("Chord::waitForIncommingConnections(): node don't exists - creating");
-                        
-                        // create new chord node and append to existing list
-                        std::shared_ptr<ChordNode> newChordNode;
-                        newChordNode = std::make_shared<ChordNode>(nodeId, ipAddress, port, shared_from_this());
-                        newChordNode->setReceiveSocket(client_socket);
-                        
-                        _connectedNodes_mutex.lock();
-                        _connectedNodes.push_back(newChordNode);
-                        _connectedNodes_mutex.unlock();
-                        
-                    } else {
-                        RGPLOGV("Chord::waitForIncommingConnections(): already exists - setting receive socket");
-                        // start receiving messages
-                        node->setReceiveSocket(client_socket);
-                    }
-                    
-                    break;
-                }
-                    
-                default:
-                {
-                    RGPLOGV("Chord::waitForIncommingConnections(): node don't identified - close connection");
-                    close(client_socket);
-                    client_socket = 0;
-                    break;
-                }
-            }
+        if (finger && finger != _ownNode &&
+            keyIsBetween(finger->getNodeID(), _ownNode->getNodeID(), key)) {
             
-        } else {
-            Log::sharedLog()->errorWithErrno("Chord::waitForIncommingConnections():recv():error using client socket: ", errno);
+            closestNode = finger;
+            break;
         }
     }
+    _fingerTable_mutex.unlock();
+    
+    return closestNode;
 }
 
-// join existing DHT using given ip and port
-void Chord::joinDHT (std::string c_ipAddress, uint16_t c_port)
+// checks if the given node is referenced by the finger table
+bool Chord::isFinger (std::shared_ptr<ChordNode> node)
 {
-    // we can use NodeID = 0
-    // 1. we don't know the id
-    // 2. we will delete this node after using to join the dht
-    
-    std::shared_ptr<ChordNode> joinNode;
-    joinNode = std::make_shared<ChordNode>(0, c_ipAddress, c_port, shared_from_this());
-    ChordConnectionStatus joinStatus = joinNode->establishSendConnection();
+    bool found { false };
     
-    // check if connection could be established
-    if (joinStatus == ChordConnectionStatusConnectingFailed) {
-        Log::sharedLog()->error((std::string("failed to join dht while connecting to: ") += c_ipAddress
-                                 += " on port: ") += std::to_string(c_port));
-        exit(EXIT_FAILURE); // we cannot join --> terminate app
+    _fingerTable_mutex.lock();
+    for (std::shared_ptr<ChordNode> finger : _fingerTable) {
+        if (finger == node) {
+            found = true;
+            break;
+        }
     }
+    _fingerTable_mutex.unlock();
     
-    ChordHeaderNode successorNode;
-    try {
-        successorNode = joinNode->searchForKey(_ownNode->getNodeID()); // search our id
-    } catch (ChordConnectionException &exception) {
-        Log::sharedLog()->error(((std::string("failed to join dht while searching for key: ") += std::to_string(_ownNode->getNodeID()))
-                                 += " with error: ") += exception.what());
-        exit(EXIT_FAILURE); // we cannot join --> terminate app
+    return found;
+}
+
+// rebuilds the successor list from our successor and its successor list
+// returns true if the list changed
+bool Chord::updateSuccessorList (std::vector<ChordHeaderNode> successorsOfSuccessor)
+{
+    std::shared_ptr<ChordNode> successor { currentSuccessor() };
+    if (!successor) {
+        return false;
     }
-    struct in_addr successorIP;
-    successorIP.s_addr = ntohl(successorNode.ip);
-    _successor = std::make_shared<ChordNode>(ntohl(successorNode.nodeId), inet_ntoa(successorIP), ntohs(successorNode.port), shared_from_this());
-    
-    _connectedNodes_mutex.lock();
-    _connectedNodes.push_back(_successor);
-    _connectedNodes_mutex.unlock();
     
-    RGPLOGV(std::string("received successor node: ") += _successor->description());
+    std::vector<std::shared_ptr<ChordNode>> successorList;
+    successorList.push_back(successor);
     
-    // we shouldn't be responsible for all that, but we may receive keys from our successor,
-    // so don't throw them back to successor
-    _responsibilityRange = (ChordRange){ .from=static_cast<ChordId>(ntohs(successorNode.nodeId) +1), .to=_ownNode->getNodeID()};
+    for (ChordHeaderNode node : successorsOfSuccessor) {
+        
+        if (static_cast<int>(successorList.size()) >= kSuccessorListLength) {
+            break;
+        }
+        
+        // the list of a small ring contains ourself
+        ChordId nodeId { ntohId(node.nodeId) };
+        if (nodeId == _ownNode->getNodeID() || nodeId == successor->getNodeID()) {
+            break;
+        }
+        
+        successorList.push_back(nodeForHeaderNode(node));
+    }
     
-    // connect
-    _successor->establishSendConnection();
+    _successorList_mutex.lock();
+    bool changed { successorList.size() != _successorList.size() ||
+                   !std::equal(successorList.begin(), successorList.end(), _successorList.begin(),
+                               [] (const std::shared_ptr<ChordNode> &a, const std::shared_ptr<ChordNode> &b) {
+                                   return a->getNodeID() == b->getNodeID();
+                               }) };
+    _successorList.swap(successorList);
+    _successorList_mutex.unlock();
     
-    // fill finger table
+    return changed;
 }
 
-// sets the given node as predecessor
-inline void Chord::setPredecessor (ChordHeaderNode node)
+// replaces the dead successor with the next living node of the successor list
+bool Chord::promoteNextSuccessor ()
 {
-    // search for ChordNode and apply to predecessor
-    _predecessor = findNodeWithId(ntohs(node.nodeId));
+    std::shared_ptr<ChordNode> deadSuccessor { currentSuccessor() };
     
-    // if not found - create node
-    if (!_predecessor) {
+    _successorList_mutex.lock();
+    std::vector<std::shared_ptr<ChordNode>> successorList { _successorList };
+    _successorList_mutex.unlock();
+    
+    for (size_t k = 0; k < successorList.size(); k++) {
         
-        std::shared_ptr<ChordNode> newPred;
-        newPred = findNodeWithId(ntohs(node.nodeId)); // check if we have a connection already
+        std::shared_ptr<ChordNode> node { successorList[k] };
+        if (node == deadSuccessor) {
+            continue;
+        }
         
-        if (newPred == nullptr) {
-            // we don't have this node yet -> create new
-            struct in_addr predecessorIP { ntohl(node.ip) };
-            _predecessor = std::make_shared<ChordNode>(ntohl(node.nodeId), inet_ntoa(predecessorIP), ntohs(node.port), shared_from_this());
+        if (node->establishSendConnection() != ChordConnectionStatusConnectingFailed) {
             
-            _connectedNodes_mutex.lock();
-            _connectedNodes.push_back(_predecessor);
-            _connectedNodes_mutex.unlock();
-        } else {
-            _predecessor = newPred;
+            CHORD_LOGV("Chord::promoteNextSuccessor(): new successor: " << node->description());
+            setSuccessor(node);
+            
+            // forget the dead nodes in front of the new successor
+            _successorList_mutex.lock();
+            _successorList.assign(successorList.begin() + k, successorList.end());
+            _successorList_mutex.unlock();
+            
+            // finger 0 is always our successor
+            _fingerTable_mutex.lock();
+            _fingerTable[0] = node;
+            _fingerTable_mutex.unlock();
+            
+            return true;
         }
     }
     
-    // update responsibility
-    _responsibilityRange.from = ntohs(node.nodeId) +1;
-    _responsibilityRange.to = _ownNode->getNodeID();
-    
-    // transfer keys
-    std::list<std::shared_ptr<uint8_t>> dataToTransfer; // list with all data to transfer
+    return false;
+}
+
+// our successor followed by its successors
+std::vector<ChordHeaderNode> Chord::successorList ()
+{
+    std::vector<ChordHeaderNode> successors;
     
-    // collect all data to transfer
-    _dataMap_mutex.lock();
-    for (auto iterator : _dataMap) {
-        
-        int dataHash = std::hash<std::shared_ptr<uint8_t>>()(iterator.second) % highestID();
-        
-        if (!keyIsInMyRange(dataHash)) {
-            dataToTransfer.push_back(iterator.second);
-        }
+    _successorList_mutex.lock();
+    for (std::shared_ptr<ChordNode> node : _successorList) {
+        successors.push_back(node->chordNode());
     }
+    _successorList_mutex.unlock();
     
-    // remove all the data from local map
-    for (auto data : dataToTransfer) {
-        int dataHash = std::hash<std::shared_ptr<uint8_t>>()(data) % highestID();
-        _dataMap.erase(dataHash);
+    // stabilize didn't fill the list yet
+    std::shared_ptr<ChordNode> successor { currentSuccessor() };
+    if (successors.empty() && successor) {
+        successors.push_back(successor->chordNode());
     }
-    _dataMap_mutex.unlock();
     
-    // send the data to predecessor
-    for (auto data : dataToTransfer) {
-        
-        RGPLOGV("Chord::setPredecessor(): transfer data to predecessor");
-        _predecessor->establishSendConnection();
-        _predecessor->addData(data);
-    }
+    return successors;
 }
 
 #pragma mark -
 
+// the first rounds run with the minimum interval (joining) - every round
+// without a membership change doubles the interval till the maximum
 void Chord::stabilize ()
 {
-    const int kStandardDelaySeconds { 10 };
-    std::chrono::seconds delay_time(1); // first stablize will connect to dht - so do it quick
+    // a new successor is asked for its predecessor right away
+    // (nodes that joined at the same time got successors far behind them)
+    bool nextRoundNow { false };
     
-    while (!_stopStabilizeThread) {
+    while ((nextRoundNow && !_stopStabilizeThread) || waitForNextRound(_stabilizeInterval, _stopStabilizeThread)) {
+        
+        nextRoundNow = false;
+        
+        std::chrono::steady_clock::time_point roundStart { std::chrono::steady_clock::now() };
         
-        std::this_thread::sleep_for(delay_time);
-        delay_time = std::chrono::seconds (kStandardDelaySeconds); // reset back to standard
-        RGPLOGV("stabilize ...");
+        CHORD_LOGV("stabilize ...");
         
-        if (!_successor) {
-            if (_predecessor) {
+        // only this thread changes the successor (the workers read it)
+        std::shared_ptr<ChordNode> successor { currentSuccessor() };
+        
+        if (!successor) {
+            std::shared_ptr<ChordNode> predecessor { currentPredecessor() };
+            if (predecessor) {
                 
                 // stabilize will fix successor now
-                // very inefficient, but we don't have a finger table
-                _successor = _predecessor;
-                _successor->establishSendConnection();
+                // very inefficient - only used if all nodes of the successor list died
+                successor = predecessor;
+                setSuccessor(successor);
+                successor->establishSendConnection();
+                membershipChanged();
             }
         }
         
-        if (_successor) {
+        if (successor) {
             try {
-                ChordHeaderNode pred = _successor->getPredecessorFromRemoteNode(_ownNode);
+                std::vector<ChordHeaderNode> successorsOfSuccessor;
+                ChordHeaderNode pred = successor->getPredecessorFromRemoteNode(_ownNode, &successorsOfSuccessor);
+                
+                // our successor list is the successor followed by its list
+                // (a changed list: nodes joined or left behind our successor)
+                if (updateSuccessorList(successorsOfSuccessor)) {
+                    membershipChanged();
+                }
                 
-                RGPLOGV(((std::string("stabilize (") += std::to_string(_ownNode->getNodeID())
-                          += ")... my successors(") += std::to_string(_successor->getNodeID()) += ") predecessor: ")
-                        += std::to_string(ntohs(pred.nodeId)));
+                CHORD_LOGV("stabilize (" << _ownNode->getNodeID() << ")... my successors("
+                           << successor->getNodeID() << ") predecessor: " << ntohId(pred.nodeId));
                 
                 // check if we are predecessor
-                if (ntohs(pred.nodeId) != _ownNode->getNodeID()) {
+                if (ntohId(pred.nodeId) != _ownNode->getNodeID()) {
+                    
+                    // a node joined between us and our successor
+                    _locationCache.nodeJoined(ntohId(pred.nodeId));
+                    membershipChanged();
                     
                     // close send connection to successor - we don't need the connection anymore (if node isn't in finger table)
-                    _successor->closeSendConnection();
+                    if (!isFinger(successor)) {
+                        successor->closeSendConnection();
+                    }
                     
                     // check if we have already a connection to the new successor
-                    std::shared_ptr<ChordNode> newSucc { findNodeWithId(ntohs(pred.nodeId)) };
+                    std::shared_ptr<ChordNode> newSucc { findNodeWithId(ntohId(pred.nodeId)) };
                     
                     if (newSucc) {
-                        RGPLOGV("stabilize newSucc ...");
-                        _successor = newSucc;
-                        _successor->establishSendConnection();
+                        CHORD_LOGV("stabilize newSucc ...");
+                        setSuccessor(newSucc);
+                        newSucc->establishSendConnection();
+                        nextRoundNow = true;
                     } else {
-                        RGPLOGV("stabilize create new node ...");
+                        CHORD_LOGV("stabilize create new node ...");
                         
                         // create node for successor
                         struct in_addr predIP;
                         predIP.s_addr = ntohl(pred.ip);
-                        _successor = std::make_shared<ChordNode>(ntohs(pred.nodeId), inet_ntoa(predIP), ntohs(pred.port), shared_from_this());
+                        successor = std::make_shared<ChordNode>(ntohId(pred.nodeId), inet_ntoa(predIP), ntohs(pred.port), _weakSelf);
                         
                         // add successor to list of connected nodes
                         _connectedNodes_mutex.lock();
-                        _connectedNodes.push_back(_successor);
+                        _connectedNodes.push_back(successor);
                         _connectedNodes_mutex.unlock();
                         
-                        _successor->establishSendConnection();
-                        delay_time = std::chrono::seconds (1); // don't wait so long with next poll
+                        setSuccessor(successor);
+                        successor->establishSendConnection();
+                        _metrics->stabilizeRoundFinished(std::chrono::steady_clock::now() - roundStart);
+                        nextRoundNow = true;
                         continue;
                     }
                 }
                 
             } catch (ChordConnectionException &exception) {
-                Log::sharedLog()->error("Chord::stabilize(): error communicating with successor");
+                CHORD_LOGE("Chord::stabilize(): error communicating with successor");
                 
                 // try to connect again
-                ChordConnectionStatus succStatus = _successor->establishSendConnection();
+                ChordConnectionStatus succStatus = successor->establishSendConnection();
                 
-                // successor is dead -> set successor to nullptr
+                // successor is dead -> use the next living successor
                 if (succStatus == ChordConnectionStatusConnectingFailed) {
-                    Log::sharedLog()->error("Chord::stabilize(): error can't establish connection to successor " \
-                                            "--> setting successor to nullptr");
-                    _successor.reset();
+                    
+                    _locationCache.removeNode(successor->getNodeID());
+                    membershipChanged();
+                    
+                    if (promoteNextSuccessor()) {
+                        nextRoundNow = true; // stabilize with the new successor right now
+                        _metrics->stabilizeRoundFinished(std::chrono::steady_clock::now() - roundStart);
+                        continue;
+                    }
+                    
+                    CHORD_LOGE("Chord::stabilize(): error can't establish connection to successor "
+                               "--> setting successor to nullptr");
+                    setSuccessor(nullptr);
                 }
             }
         }
         
         // check that predecessor is alive
-        if (_predecessor) {
-            if (!_predecessor->isAlive()) {
+        std::shared_ptr<ChordNode> predecessor { currentPredecessor() };
+        if (predecessor) {
+            if (!predecessor->isAlive()) {
                 
-                RGPLOGV("Chord::stabilize(): my predecessor died...");
+                CHORD_LOGV("Chord::stabilize(): my predecessor died...");
+                
+                _locationCache.removeNode(predecessor->getNodeID());
+                membershipChanged();
                 
                 // predecessor died -> remove from connected list
                 _connectedNodes_mutex.lock();
-                _connectedNodes.remove(_predecessor);
+                _connectedNodes.remove(predecessor);
                 _connectedNodes_mutex.unlock();
                 
                 // no predecessor -> set predecessor to nullptr
-                _predecessor.reset();
+                // (unless a worker accepted a new one meanwhile)
+                _neighbours_mutex.lock();
+                if (_predecessor == predecessor) {
+                    _predecessor.reset();
+                }
+                _neighbours_mutex.unlock();
             }
         }
         
         /// memory management
         // cleanup connectedThreads list
+        // the heartbeats wait for the network - the workers must be able to
+        // look up nodes meanwhile (f.e. to deliver the heartbeat responses)
         _connectedNodes_mutex.lock();
+        std::list<std::shared_ptr<ChordNode>> connectedNodes { _connectedNodes };
+        _connectedNodes_mutex.unlock();
+        
+        successor = currentSuccessor();
+        predecessor = currentPredecessor();
+        
         std::list<std::shared_ptr<ChordNode>> nodesToDelete;
-        for (std::shared_ptr<ChordNode> node : _connectedNodes) {
-            if (node != _successor && node != _predecessor) { // don't delete successor or predecessor
+        for (std::shared_ptr<ChordNode> node : connectedNodes) {
+            
+            if (node != successor && node != predecessor) { // don't delete successor or predecessor
                 if (!node->isAlive()) {
                     // if dead remove node
                     nodesToDelete.push_back(node);
-                    // we cannot remove it directly -> altering the list while iterating -> segv
                 }
             }
         }
         
         // delete all nodes now
+        _connectedNodes_mutex.lock();
         for(std::shared_ptr<ChordNode> node : nodesToDelete) {
             _connectedNodes.remove(node);
+            _locationCache.removeNode(node->getNodeID());
         }
         _connectedNodes_mutex.unlock();
+        
+        _metrics->stabilizeRoundFinished(std::chrono::steady_clock::now() - roundStart);
     }
 }
 
-// TODO: implement fix_fingers
+// fix fingers protocol
+// periodically refreshes the finger table: finger i is set to the
+// currently valid successor of (own node id + 2^i)
+// backs off while the refreshed fingers don't change
 void Chord::fixFingers ()
 {
-    /*
-     Jeder Knoten Kn führt periodisch eine fix_fingers() Funktion aus:
-     -  Diese iteriert über die Einträge der Fingertable
-     (oder per Zufall einen auswählen)
-     -  Und sucht für jeden Eintrag i den aktuell
-     gültigen Nachfolger von n + 2i-1
-     */
+    // number of fingers refreshed per round
+    // (with kKeyLenght fingers the whole table is refreshed every 4 rounds)
+    const int kFingersPerRound { kKeyLenght / 4 };
+    
+    while (waitForNextRound(_fixFingersInterval, _stopFixFingersThread)) {
+        
+        std::shared_ptr<ChordNode> successor { currentSuccessor() };
+        
+        // finger 0 is always our successor
+        _fingerTable_mutex.lock();
+        _fingerTable[0] = successor ? successor : _ownNode;
+        _fingerTable_mutex.unlock();
+        
+        for (int k = 0; k < kFingersPerRound && !_stopFixFingersThread; k++) {
+            
+            // finger 0 is maintained by stabilize
+            _nextFingerToFix = (_nextFingerToFix % (kKeyLenght - 1)) + 1;
+            int finger = _nextFingerToFix;
+            ChordId start = fingerStart(finger);
+            
+            // if the start is still covered by the previous finger we don't
+            // need to search (most of the lower fingers point to our successor)
+            _fingerTable_mutex.lock();
+            std::shared_ptr<ChordNode> previousFinger { _fingerTable[finger - 1] };
+            _fingerTable_mutex.unlock();
+            
+            std::shared_ptr<ChordNode> fingerNode { nullptr };
+            
+            if (previousFinger && previousFinger != _ownNode &&
+                keyIsInRange(start, _ownNode->getNodeID(), previousFinger->getNodeID())) {
+                
+                fingerNode = previousFinger;
+                
+            } else {
+                ChordHeaderNode node = searchForKey(_ownNode->getNodeID(), start);
+                fingerNode = nodeForHeaderNode(node);
+            }
+            
+            _fingerTable_mutex.lock();
+            bool changed { !_fingerTable[finger] || _fingerTable[finger]->getNodeID() != fingerNode->getNodeID() };
+            _fingerTable[finger] = fingerNode;
+            _fingerTable_mutex.unlock();
+            
+            // the remaining fingers may have changed too
+            if (changed) {
+                _fixFingersInterval.reset();
+            }
+        }
+    }
+}
+
+// waits till the next round of the protocol, a membership change or till the node is destroyed
+// returns false if the protocol has to stop
+bool Chord::waitForNextRound (ChordAdaptiveInterval &interval, const std::atomic<bool> &stop)
+{
+    // requests without response won't wait forever - even if the protocol backed off
+    const std::chrono::seconds kExpiredRequestsInterval { ChordNode::kRequestTimeoutSeconds };
+    
+    std::chrono::steady_clock::time_point nextRound { std::chrono::steady_clock::now() + interval.nextDelay() };
+    
+    std::unique_lock<std::mutex> lock(_stop_mutex);
+    while (!_stop_condition.wait_until(lock, std::min(nextRound, std::chrono::steady_clock::now() + kExpiredRequestsInterval),
+                                       [&stop, &interval] () { return stop.load() || interval.wasReset(); })) {
+        
+        lock.unlock();
+        failExpiredRequests();
+        lock.lock();
+        
+        if (std::chrono::steady_clock::now() >= nextRound) {
+            break;
+        }
+    }
+    
+    return !stop;
+}
+
+// fails the requests of all connected nodes that wait too long
+void Chord::failExpiredRequests ()
+{
+    _connectedNodes_mutex.lock();
+    std::list<std::shared_ptr<ChordNode>> connectedNodes { _connectedNodes };
+    _connectedNodes_mutex.unlock();
+    
+    for (std::shared_ptr<ChordNode> node : connectedNodes) {
+        node->failExpiredRequests();
+    }
 }
@@ -0,0 +1,90 @@
+/*
+ ChordAdaptiveInterval.cpp
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/ChordAdaptiveInterval.h>
+
+#include <algorithm>
+#include <random>
+
+using namespace rgp;
+
+const int ChordAdaptiveInterval::kJitterPercent;
+
+#pragma mark - Constructor / Destructor
+
+ChordAdaptiveInterval::ChordAdaptiveInterval (std::chrono::milliseconds minimum, std::chrono::milliseconds maximum)
+{
+    setRange(minimum, maximum);
+}
+
+#pragma mark - Public
+
+// range of the interval (the current interval starts at the minimum)
+void ChordAdaptiveInterval::setRange (std::chrono::milliseconds minimum, std::chrono::milliseconds maximum)
+{
+    _interval_mutex.lock();
+    _minimum = std::max<int64_t>(1, minimum.count());
+    _maximum = std::max<int64_t>(_minimum, maximum.count());
+    _current = _minimum;
+    _interval_mutex.unlock();
+}
+
+// the next rounds run with the minimum interval again
+void ChordAdaptiveInterval::reset ()
+{
+    // together with the interval - nextDelay must not lose the reset
+    _interval_mutex.lock();
+    _current = _minimum;
+    _reset = true;
+    _interval_mutex.unlock();
+}
+
+// jittered delay till the next round - the following round waits twice as long
+std::chrono::milliseconds ChordAdaptiveInterval::nextDelay ()
+{
+    // the reset is consumed with the interval it set
+    _interval_mutex.lock();
+    _reset = false;
+    int64_t interval { _current };
+    _current = std::min(_current * 2, _maximum);
+    _interval_mutex.unlock();
+    
+    // the protocol threads of all nodes use their own generator
+    static thread_local std::mt19937 generator { std::random_device()() };
+    std::uniform_int_distribution<int64_t> jitter { -interval * kJitterPercent / 100, interval * kJitterPercent / 100 };
+    
+    return std::chrono::milliseconds(std::max<int64_t>(1, interval + jitter(generator)));
+}
+
+// current interval (without jitter)
+std::chrono::milliseconds ChordAdaptiveInterval::interval ()
+{
+    _interval_mutex.lock();
+    int64_t interval { _current };
+    _interval_mutex.unlock();
+    
+    return std::chrono::milliseconds(interval);
+}
@@ -0,0 +1,111 @@
+/*
+ ChordBufferPool.cpp
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/ChordBufferPool.h>
+
+using namespace rgp;
+
+const size_t ChordBufferPool::kMaxPooledBuffers;
+const uint32_t ChordBufferPool::kMaxPooledSize;
+
+namespace {
+    // smallest pooled buffer
+    const uint32_t kMinBufferSize { 256 };
+}
+
+#pragma mark - Destructor
+
+ChordBufferPool::~ChordBufferPool ()
+{
+    for (auto buffer : _freeBuffers) {
+        delete [] buffer.second;
+    }
+}
+
+#pragma mark - Public
+
+// returns a buffer with at least size bytes
+std::shared_ptr<uint8_t> ChordBufferPool::acquire (uint32_t size)
+{
+    // not worth keeping
+    if (size > kMaxPooledSize) {
+        return std::shared_ptr<uint8_t>(new uint8_t[size], std::default_delete<uint8_t[]>());
+    }
+    
+    uint8_t *buffer { nullptr };
+    uint32_t capacity { 0 };
+    
+    // smallest free buffer that is big enough
+    _freeBuffers_mutex.lock();
+    auto bestBuffer = _freeBuffers.end();
+    for (auto iterator = _freeBuffers.begin(); iterator != _freeBuffers.end(); ++iterator) {
+        if (iterator->first >= size && (bestBuffer == _freeBuffers.end() || iterator->first < bestBuffer->first)) {
+            bestBuffer = iterator;
+        }
+    }
+    if (bestBuffer != _freeBuffers.end()) {
+        capacity = bestBuffer->first;
+        buffer = bestBuffer->second;
+        _freeBuffers.erase(bestBuffer);
+    }
+    _freeBuffers_mutex.unlock();
+    
+    if (!buffer) {
+        // round up to the next power of two - the buffer fits more messages
+        capacity = kMinBufferSize;
+        while (capacity < size) {
+            capacity *= 2;
+        }
+        buffer = new uint8_t[capacity];
+    }
+    
+    // the buffer may outlive the pool
+    std::weak_ptr<ChordBufferPool> weakPool { shared_from_this() };
+    
+    return std::shared_ptr<uint8_t>(buffer, [weakPool, capacity] (uint8_t *buffer) {
+        std::shared_ptr<ChordBufferPool> pool { weakPool.lock() };
+        if (pool) {
+            pool->release(buffer, capacity);
+        } else {
+            delete [] buffer;
+        }
+    });
+}
+
+#pragma mark - Private
+
+// takes the buffer back (or frees it if the pool is full)
+void ChordBufferPool::release (uint8_t *buffer, uint32_t capacity)
+{
+    _freeBuffers_mutex.lock();
+    if (_freeBuffers.size() < kMaxPooledBuffers) {
+        _freeBuffers.push_back(std::make_pair(capacity, buffer));
+        buffer = nullptr;
+    }
+    _freeBuffers_mutex.unlock();
+    
+    delete [] buffer;
+}
@@ -0,0 +1,66 @@
+/*
+ ChordCounter.cpp
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/ChordCounter.h>
+
+using namespace rgp;
+
+const size_t ChordCounter::kSlotCount;
+const size_t ChordCounter::kCacheLineSize;
+
+#pragma mark - Constructor / Destructor
+
+ChordCounter::ChordCounter ()
+{
+    for (Slot &slot : _slots) {
+        slot.value = 0;
+    }
+}
+
+#pragma mark - Public
+
+// sum of all slots
+uint64_t ChordCounter::value () const
+{
+    uint64_t sum { 0 };
+    
+    for (const Slot &slot : _slots) {
+        sum += slot.value.load(std::memory_order_relaxed);
+    }
+    
+    return sum;
+}
+
+#pragma mark - Private
+
+// slot of the calling thread (the threads get the slots one after another)
+size_t ChordCounter::slotIndex ()
+{
+    static std::atomic<size_t> nextSlot { 0 };
+    static thread_local size_t slot { nextSlot++ % kSlotCount };
+    
+    return slot;
+}
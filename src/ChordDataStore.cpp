@@ -0,0 +1,251 @@
+/*
+ ChordDataStore.cpp
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/ChordDataStore.h>
+
+#include <arpa/inet.h>
+#include <cstring>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+using namespace rgp;
+
+namespace {
+    // the arena is compacted only if it wastes at least this many bytes
+    const size_t kMinArenaGarbage { 64 * 1024 };
+}
+
+const uint32_t ChordDataStore::kInlineSize;
+const size_t ChordDataStore::kMergeThreshold;
+
+#pragma mark - Public
+
+// adds (or replaces) the data with the key
+void ChordDataStore::put (ChordId key, std::shared_ptr<uint8_t> data)
+{
+    if (!data) {
+        return;
+    }
+    
+    // get data size from binary
+    uint32_t dataSize { 0 };
+    memcpy(&dataSize, data.get(), sizeof(dataSize));
+    dataSize = ntohl(dataSize);
+    
+    // replace existing value
+    Entry *entry { findEntry(_entries, key) };
+    if (!entry) {
+        entry = findEntry(_recentEntries, key);
+    }
+    
+    if (entry) {
+        releaseValue(*entry);
+        storeValue(entry, data.get(), dataSize);
+        compactArenaIfNeeded();
+        return;
+    }
+    
+    // new key - insert into the (small) recent entries
+    Entry newEntry;
+    newEntry.key = key;
+    storeValue(&newEntry, data.get(), dataSize);
+    
+    _recentEntries.insert(std::upper_bound(_recentEntries.begin(), _recentEntries.end(), newEntry), newEntry);
+    
+    if (_recentEntries.size() >= kMergeThreshold) {
+        mergeRecentEntries();
+    }
+}
+
+// returns a copy of the data with the key or nullptr
+std::shared_ptr<uint8_t> ChordDataStore::get (ChordId key) const
+{
+    const Entry *entry { findEntry(_entries, key) };
+    if (!entry) {
+        entry = findEntry(_recentEntries, key);
+    }
+    
+    if (!entry) {
+        return nullptr;
+    }
+    
+    return copyValue(*entry);
+}
+
+// removes the data with the key
+bool ChordDataStore::remove (ChordId key)
+{
+    for (std::vector<Entry> *entries : { &_entries, &_recentEntries }) {
+        
+        Entry *entry { findEntry(*entries, key) };
+        if (entry) {
+            releaseValue(*entry);
+            entries->erase(entries->begin() + (entry - entries->data()));
+            compactArenaIfNeeded();
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+// removes all data inside the ring interval [from, to]
+void ChordDataStore::removeRange (ChordId from, ChordId to, std::vector<ChordDataItem> *removed)
+{
+    for (std::vector<Entry> *entries : { &_entries, &_recentEntries }) {
+        
+        if (from <= to) {
+            removeSlice(*entries, from, to, removed);
+        } else {
+            // interval wraps around zero
+            removeSlice(*entries, from, std::numeric_limits<ChordId>::max(), removed);
+            removeSlice(*entries, 0, to, removed);
+        }
+    }
+    
+    compactArenaIfNeeded();
+}
+
+#pragma mark - Private
+
+// returns the entry with the key or nullptr
+ChordDataStore::Entry *ChordDataStore::findEntry (std::vector<Entry> &entries, ChordId key)
+{
+    return const_cast<Entry *>(findEntry(static_cast<const std::vector<Entry> &>(entries), key));
+}
+
+const ChordDataStore::Entry *ChordDataStore::findEntry (const std::vector<Entry> &entries, ChordId key)
+{
+    Entry searchEntry;
+    searchEntry.key = key;
+    
+    auto iterator = std::lower_bound(entries.begin(), entries.end(), searchEntry);
+    if (iterator != entries.end() && iterator->key == key) {
+        return &(*iterator);
+    }
+    
+    return nullptr;
+}
+
+// stores the value inside the entry or the arena
+void ChordDataStore::storeValue (Entry *entry, const uint8_t *data, uint32_t size)
+{
+    entry->size = size;
+    
+    if (size <= kInlineSize) {
+        memcpy(entry->value.bytes, data, size);
+        return;
+    }
+    
+    entry->value.offset = _arena.size();
+    _arena.insert(_arena.end(), data, data + size);
+}
+
+// marks the arena bytes of the value as unused
+void ChordDataStore::releaseValue (const Entry &entry)
+{
+    if (entry.size > kInlineSize) {
+        _arenaGarbage += entry.size;
+    }
+}
+
+// returns a copy of the value
+std::shared_ptr<uint8_t> ChordDataStore::copyValue (const Entry &entry) const
+{
+    std::shared_ptr<uint8_t> data { new uint8_t[entry.size], std::default_delete<uint8_t[]>() };
+    
+    if (entry.size <= kInlineSize) {
+        memcpy(data.get(), entry.value.bytes, entry.size);
+    } else {
+        memcpy(data.get(), _arena.data() + entry.value.offset, entry.size);
+    }
+    
+    return data;
+}
+
+// removes the slice [from, to] of the sorted entries
+void ChordDataStore::removeSlice (std::vector<Entry> &entries, ChordId from, ChordId to,
+                                  std::vector<ChordDataItem> *removed)
+{
+    Entry fromEntry;
+    fromEntry.key = from;
+    Entry toEntry;
+    toEntry.key = to;
+    
+    auto first = std::lower_bound(entries.begin(), entries.end(), fromEntry);
+    auto last = std::upper_bound(first, entries.end(), toEntry);
+    
+    for (auto iterator = first; iterator != last; ++iterator) {
+        if (removed) {
+            removed->push_back(ChordDataItem(iterator->key, copyValue(*iterator)));
+        }
+        releaseValue(*iterator);
+    }
+    
+    entries.erase(first, last);
+}
+
+// merges the recent entries into the main array
+void ChordDataStore::mergeRecentEntries ()
+{
+    std::vector<Entry> entries;
+    entries.reserve(_entries.size() + _recentEntries.size());
+    
+    // the keys are disjunct - a put replaces existing entries
+    std::merge(_entries.begin(), _entries.end(), _recentEntries.begin(), _recentEntries.end(),
+               std::back_inserter(entries));
+    
+    _entries.swap(entries);
+    _recentEntries.clear();
+}
+
+// drops the unused bytes of the arena if they are the majority
+void ChordDataStore::compactArenaIfNeeded ()
+{
+    if (_arenaGarbage < kMinArenaGarbage || _arenaGarbage < _arena.size() / 2) {
+        return;
+    }
+    
+    std::vector<uint8_t> arena;
+    arena.reserve(_arena.size() - _arenaGarbage);
+    
+    for (std::vector<Entry> *entries : { &_entries, &_recentEntries }) {
+        for (Entry &entry : *entries) {
+            
+            if (entry.size <= kInlineSize) {
+                continue;
+            }
+            
+            const uint8_t *value { _arena.data() + entry.value.offset };
+            entry.value.offset = arena.size();
+            arena.insert(arena.end(), value, value + entry.size);
+        }
+    }
+    
+    _arena.swap(arena);
+    _arenaGarbage = 0;
+}
@@ -0,0 +1,175 @@
+/*
+ ChordFrameReader.cpp
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/ChordFrameReader.h>
+#include <rgp/ChordLog.h>
+#include <rgp/Log.h>
+
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+using namespace rgp;
+
+const size_t ChordFrameReader::kReadBufferSize;
+const uint32_t ChordFrameReader::kMaxDataSize;
+
+#pragma mark - Constructor
+
+ChordFrameReader::ChordFrameReader ()
+: _readBuffer(kReadBufferSize), _bufferPool(std::make_shared<ChordBufferPool>())
+{
+}
+
+#pragma mark - Public
+
+// reads all available data and calls the handler for every complete message
+bool ChordFrameReader::readFrames (int socket, ChordFrameHandler handler)
+{
+    while (true) {
+        
+        // refill the read buffer
+        // (the data of large messages is read directly - see below)
+        bool readDirectly { _headerComplete && _dataSize - _dataBytes >= kReadBufferSize };
+        
+        if (_readPosition == _readEnd && !readDirectly) {
+            
+            ssize_t readBytes { readAvailable(socket, _readBuffer.data(), _readBuffer.size()) };
+            if (readBytes < 0) {
+                return false;
+            }
+            if (readBytes == 0) {
+                return true; // wait for more data
+            }
+            
+            _readPosition = 0;
+            _readEnd = readBytes;
+        }
+        
+        // header
+        if (!_headerComplete) {
+            
+            // collect the bytes that may belong to the header
+            size_t bytes { std::min(ChordWire::kMaxHeaderSize - _headerBytes, _readEnd - _readPosition) };
+            memcpy(_headerBuffer + _headerBytes, _readBuffer.data() + _readPosition, bytes);
+            
+            ssize_t headerSize { ChordWire::decodeHeader(_headerBuffer, _headerBytes + bytes, &_header) };
+            if (headerSize < 0) {
+                CHORD_LOGE("ChordFrameReader::readFrames(): received invalid header");
+                return false;
+            }
+            
+            if (headerSize == 0) {
+                // header is incomplete - wait for more
+                _headerBytes += bytes;
+                _readPosition += bytes;
+                continue;
+            }
+            
+            // bytes after the header stay in the read buffer
+            _readPosition += headerSize - _headerBytes;
+            _headerBytes = 0;
+            _headerComplete = true;
+            
+            _dataSize = ntohl(_header.dataSize);
+            _dataBytes = 0;
+            
+            if (_dataSize > kMaxDataSize) {
+                CHORD_LOGE("ChordFrameReader::readFrames(): message too big: " << _dataSize);
+                return false;
+            }
+            
+            _data = _dataSize > 0 ? _bufferPool->acquire(_dataSize) : nullptr;
+        }
+        
+        // data
+        if (_dataBytes < _dataSize) {
+            
+            if (_readPosition < _readEnd) {
+                // data that is already in the read buffer
+                size_t bytes { std::min(static_cast<size_t>(_dataSize - _dataBytes), _readEnd - _readPosition) };
+                memcpy(_data.get() + _dataBytes, _readBuffer.data() + _readPosition, bytes);
+                _dataBytes += bytes;
+                _readPosition += bytes;
+                
+            } else if (_dataSize - _dataBytes >= kReadBufferSize) {
+                // large data - no detour through the read buffer
+                ssize_t readBytes { readAvailable(socket, _data.get() + _dataBytes, _dataSize - _dataBytes) };
+                if (readBytes < 0) {
+                    return false;
+                }
+                if (readBytes == 0) {
+                    return true; // wait for more data
+                }
+                _dataBytes += readBytes;
+            }
+            
+            if (_dataBytes < _dataSize) {
+                continue;
+            }
+        }
+        
+        // message is complete
+        std::shared_ptr<uint8_t> data { _data };
+        _data.reset();
+        _headerComplete = false;
+        
+        handler(_header, data);
+    }
+}
+
+#pragma mark - Private
+
+// reads available data into the given memory
+ssize_t ChordFrameReader::readAvailable (int socket, uint8_t *buffer, size_t size)
+{
+    while (true) {
+        
+        ssize_t readBytes { recv(socket, buffer, size, MSG_DONTWAIT) };
+        
+        if (readBytes > 0) {
+            return readBytes;
+        }
+        
+        // connection closed
+        if (readBytes == 0) {
+            return -1;
+        }
+        
+        if (errno == EINTR) {
+            continue;
+        }
+        
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return 0;
+        }
+        
+        Log::sharedLog()->errorWithErrno("ChordFrameReader::readAvailable():recv() ", errno);
+        return -1;
+    }
+}
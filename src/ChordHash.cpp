@@ -0,0 +1,103 @@
+/*
+ ChordHash.cpp
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/ChordHash.h>
+#include <rgp/Chord.h>
+
+#include <arpa/inet.h>
+#include <cstring>
+
+using namespace rgp;
+
+namespace {
+    // FNV-1a parameters
+    const uint64_t kFnvOffsetBasis { 0xcbf29ce484222325ULL };
+    const uint64_t kFnvPrime { 0x100000001b3ULL };
+}
+
+// 64 bit hash of the given bytes
+uint64_t ChordHash::hash64 (const void *bytes, size_t length)
+{
+    const uint8_t *pos { static_cast<const uint8_t *>(bytes) };
+    
+    uint64_t hash { kFnvOffsetBasis };
+    for (size_t i = 0; i < length; i++) {
+        hash ^= pos[i];
+        hash *= kFnvPrime;
+    }
+    
+    // final mix - spreads similar inputs over the whole ring
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    
+    return hash;
+}
+
+// key for the given bytes
+ChordId ChordHash::keyForBytes (const void *bytes, size_t length)
+{
+    uint64_t hash { hash64(bytes, length) };
+    
+    // fold to the key length of the ring
+    hash ^= hash >> 32;
+    return static_cast<ChordId>(hash & (~0ULL >> (64 - Chord::kKeyLenght)));
+}
+
+// key for an application key (f.e. a file name)
+ChordId ChordHash::keyForString (const std::string &string)
+{
+    return keyForBytes(string.data(), string.size());
+}
+
+// node id for the given address
+ChordId ChordHash::keyForNode (const std::string &ipAddress, uint16_t port, const std::string &salt)
+{
+    std::string address { (ipAddress + ":") += std::to_string(port) };
+    
+    if (!salt.empty()) {
+        (address += "#") += salt;
+    }
+    
+    return keyForString(address);
+}
+
+// key for serialized data (see ChordData)
+ChordId ChordHash::keyForData (std::shared_ptr<uint8_t> data)
+{
+    if (!data) {
+        return 0;
+    }
+    
+    // get data size from binary
+    uint32_t dataSize { 0 };
+    memcpy(&dataSize, data.get(), sizeof(dataSize));
+    dataSize = ntohl(dataSize);
+    
+    return keyForBytes(data.get(), dataSize);
+}
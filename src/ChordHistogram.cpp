@@ -0,0 +1,146 @@
+/*
+ ChordHistogram.cpp
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/ChordHistogram.h>
+
+#include <algorithm>
+
+using namespace rgp;
+
+const int ChordHistogram::kSubBucketBits;
+const int ChordHistogram::kSubBucketCount;
+const int ChordHistogram::kMaxValueBits;
+const int ChordHistogram::kBucketCount;
+
+#pragma mark - Constructor / Destructor
+
+ChordHistogram::ChordHistogram ()
+{
+    for (std::atomic<uint64_t> &bucket : _buckets) {
+        bucket = 0;
+    }
+    _count = 0;
+    _sum = 0;
+    _max = 0;
+}
+
+#pragma mark - Public
+
+// counts the value
+void ChordHistogram::record (uint64_t value)
+{
+    _buckets[bucketForValue(value)].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+    _sum.fetch_add(value, std::memory_order_relaxed);
+    
+    // the maximum only grows
+    uint64_t max { _max.load(std::memory_order_relaxed) };
+    while (value > max && !_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {}
+}
+
+// average of the recorded values
+double ChordHistogram::mean () const
+{
+    uint64_t count { _count.load(std::memory_order_relaxed) };
+    
+    if (count == 0) {
+        return 0;
+    }
+    
+    return static_cast<double>(_sum.load(std::memory_order_relaxed)) / count;
+}
+
+// value that the given fraction of the recorded values don't exceed
+uint64_t ChordHistogram::valueAtPercentile (double fraction) const
+{
+    // the buckets may change while we read - use their own sum
+    uint64_t total { 0 };
+    for (const std::atomic<uint64_t> &bucket : _buckets) {
+        total += bucket.load(std::memory_order_relaxed);
+    }
+    
+    if (total == 0) {
+        return 0;
+    }
+    
+    fraction = std::max(0.0, std::min(fraction, 1.0));
+    uint64_t rank { std::max<uint64_t>(1, static_cast<uint64_t>(fraction * total + 0.5)) };
+    uint64_t seen { 0 };
+    
+    for (int bucket = 0; bucket < kBucketCount; bucket++) {
+        seen += _buckets[bucket].load(std::memory_order_relaxed);
+        
+        if (seen >= rank) {
+            // the bucket's upper bound may be above every recorded value
+            return std::min(highestValueOfBucket(bucket), max());
+        }
+    }
+    
+    return max();
+}
+
+#pragma mark - Private
+
+// bucket that counts the value
+// values below kSubBucketCount get their own bucket, every following power
+// of two is split into kSubBucketCount buckets (by the bits after the highest one)
+int ChordHistogram::bucketForValue (uint64_t value)
+{
+    if (value < static_cast<uint64_t>(kSubBucketCount)) {
+        return static_cast<int>(value);
+    }
+    
+    // position of the highest bit
+    int exponent { 0 };
+    for (int shift = 32; shift > 0; shift /= 2) {
+        if (value >> (exponent + shift)) {
+            exponent += shift;
+        }
+    }
+    
+    // too large - count as the largest value
+    if (exponent >= kMaxValueBits) {
+        return kBucketCount - 1;
+    }
+    
+    int subBucket { static_cast<int>((value >> (exponent - kSubBucketBits)) & (kSubBucketCount - 1)) };
+    
+    return (exponent - kSubBucketBits + 1) * kSubBucketCount + subBucket;
+}
+
+// largest value of the bucket
+uint64_t ChordHistogram::highestValueOfBucket (int bucket)
+{
+    if (bucket < kSubBucketCount) {
+        return static_cast<uint64_t>(bucket);
+    }
+    
+    int exponent { bucket / kSubBucketCount + kSubBucketBits - 1 };
+    uint64_t subBucket { static_cast<uint64_t>(bucket % kSubBucketCount) };
+    uint64_t width { uint64_t(1) << (exponent - kSubBucketBits) };
+    
+    return ((kSubBucketCount + subBucket) << (exponent - kSubBucketBits)) + width - 1;
+}
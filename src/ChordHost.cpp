@@ -0,0 +1,211 @@
+/*
+ ChordHost.cpp
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/ChordHost.h>
+#include <rgp/ChordSocketTransport.h>
+#include <rgp/ChordNode.h>
+#include <rgp/ChordHash.h>
+#include <rgp/ChordLog.h>
+
+#include <set>
+#include <algorithm>
+#include <cstring>
+#include <arpa/inet.h>
+
+using namespace rgp;
+
+const int ChordHost::kMaxWeight;
+
+#pragma mark - Constructor / Destructor
+
+ChordHost::ChordHost (std::string ipAddress, uint16_t port, int weight, std::string salt)
+: _ipAddress(ipAddress), _port(port), _salt(salt)
+{
+    start();
+    createVirtualNodes(weight, "", 0);
+}
+
+ChordHost::ChordHost (std::string ipAddress, uint16_t port, int weight, std::string c_ipAddress, uint16_t c_port,
+                      std::string salt)
+: _ipAddress(ipAddress), _port(port), _salt(salt)
+{
+    start();
+    createVirtualNodes(weight, c_ipAddress, c_port);
+}
+
+ChordHost::~ChordHost ()
+{
+    // stop accepting connections
+    if (_listening) {
+        _transport->stopListening(_ipAddress, _port);
+        _listening = false;
+    }
+    
+    // stops the protocols of the virtual nodes
+    _virtualNodes_mutex.lock();
+    std::vector<std::shared_ptr<Chord>> virtualNodes;
+    virtualNodes.swap(_virtualNodes);
+    _virtualNodes_mutex.unlock();
+    for (std::shared_ptr<Chord> virtualNode : virtualNodes) {
+        virtualNode->stop();
+    }
+    virtualNodes.clear();
+    
+    // stops the transport
+    _transport.reset();
+}
+
+#pragma mark - Public
+
+// all virtual nodes of this host
+std::vector<std::shared_ptr<Chord>> ChordHost::virtualNodes ()
+{
+    _virtualNodes_mutex.lock();
+    std::vector<std::shared_ptr<Chord>> virtualNodes { _virtualNodes };
+    _virtualNodes_mutex.unlock();
+    
+    return virtualNodes;
+}
+
+// returns the virtual node with the given id
+std::shared_ptr<Chord> ChordHost::virtualNodeWithId (ChordId nodeId)
+{
+    std::shared_ptr<Chord> virtualNode { nullptr };
+    
+    _virtualNodes_mutex.lock();
+    for (std::shared_ptr<Chord> chord : _virtualNodes) {
+        if (chord->ownNode()->getNodeID() == nodeId) {
+            virtualNode = chord;
+            break;
+        }
+    }
+    _virtualNodes_mutex.unlock();
+    
+    return virtualNode;
+}
+
+#pragma mark - Private
+
+// starts listening and opens the shared stores
+void ChordHost::start ()
+{
+    _dataMap = std::make_shared<ChordShardedDataStore>();
+    _replicaMap = std::make_shared<ChordShardedDataStore>();
+    
+    // all connections of all virtual nodes are handled by one transport
+    _transport = std::make_shared<ChordSocketTransport>();
+    
+    // handle incomming connects
+    _listening = _transport->listen(_ipAddress, _port, std::bind(&ChordHost::acceptConnection, this,
+                                                                 std::placeholders::_1));
+}
+
+// creates weight virtual nodes with distinct ids
+void ChordHost::createVirtualNodes (int weight, std::string c_ipAddress, uint16_t c_port)
+{
+    weight = std::max(1, std::min(weight, kMaxWeight));
+    
+    // the ids only depend on address, salt and index (same ids on every start)
+    // two indexes with the same hash just take the next index
+    std::set<ChordId> nodeIds;
+    
+    for (int index = 0; nodeIds.size() < static_cast<size_t>(weight); index++) {
+        std::string salt { (std::string(_salt) += "#") += std::to_string(index) };
+        nodeIds.insert(ChordHash::keyForNode(_ipAddress, _port, salt));
+    }
+    
+    for (ChordId nodeId : nodeIds) {
+        
+        // the first node creates (or joins) the ring
+        // the others join through our first virtual node (a connection to ourself)
+        std::string joinIpAddress { _virtualNodes.empty() ? c_ipAddress : _ipAddress };
+        uint16_t joinPort { _virtualNodes.empty() ? c_port : _port };
+        
+        // the host listens for all virtual nodes
+        std::shared_ptr<Chord> virtualNode;
+        virtualNode = std::make_shared<Chord>(nodeId, _ipAddress, _port, joinIpAddress, joinPort,
+                                              _transport, false, _dataMap, _replicaMap);
+        virtualNode->start();
+        
+        _virtualNodes_mutex.lock();
+        _virtualNodes.push_back(virtualNode);
+        _virtualNodes_mutex.unlock();
+    }
+}
+
+// waits for the identify message of an incomming connection (called by transport)
+// the connection will be handled as soon as the remote node identifies itself
+void ChordHost::acceptConnection (std::shared_ptr<ChordConnection> connection)
+{
+    // the connection holds the handler - don't create a cycle
+    std::weak_ptr<ChordConnection> weakConnection { connection };
+    
+    connection->receive([this, weakConnection] (ChordHeader header, std::shared_ptr<uint8_t> data) {
+        std::shared_ptr<ChordConnection> connection { weakConnection.lock() };
+        
+        if (connection) {
+            identifyConnection(connection, header, data);
+        }
+        
+    }, [] () {
+        CHORD_LOGV("ChordHost::acceptConnection(): connection closed before identify");
+    });
+}
+
+// passes the connection to the virtual node it is meant for
+void ChordHost::identifyConnection (std::shared_ptr<ChordConnection> connection, ChordHeader header,
+                                    std::shared_ptr<uint8_t> data)
+{
+    // the identify message names the virtual node (0: unknown target)
+    ChordId targetId { 0 };
+    
+    if (header.type == ChordMessageTypeIdentify && ntohl(header.dataSize) == kIdentifyDataSize && data) {
+        ChordId networkId;
+        memcpy(&networkId, data.get(), sizeof(ChordId));
+        targetId = ntohId(networkId);
+    }
+    
+    // a node that doesn't know our ids yet (f.e. while joining) gets the first one
+    std::shared_ptr<Chord> virtualNode { virtualNodeWithId(targetId) };
+    
+    if (!virtualNode) {
+        _virtualNodes_mutex.lock();
+        if (!_virtualNodes.empty()) {
+            virtualNode = _virtualNodes.front();
+        }
+        _virtualNodes_mutex.unlock();
+    }
+    
+    if (!virtualNode) {
+        CHORD_LOGV("ChordHost::identifyConnection(): no virtual node yet - close connection");
+        connection->close();
+        return;
+    }
+    
+    // the node's handler takes over the connection
+    // (it also rejects nodes with another id width)
+    virtualNode->adoptConnection(connection, header, data);
+}
@@ -0,0 +1,164 @@
+/*
+ ChordLocationCache.cpp
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/ChordLocationCache.h>
+
+#include <arpa/inet.h>
+
+using namespace rgp;
+
+const size_t ChordLocationCache::kDefaultCapacity;
+
+#pragma mark - Constructor
+
+ChordLocationCache::ChordLocationCache (size_t capacity)
+: _capacity(capacity)
+{
+}
+
+#pragma mark - Public
+
+// returns true and the cached responsible node if the key is known
+bool ChordLocationCache::find (ChordId key, ChordHeaderNode *node)
+{
+    _mutex.lock();
+    
+    auto iterator = entryForKey(key);
+    
+    // key has to be inside [from, node id] (distance on the ring)
+    if (iterator == _entries.end() ||
+        static_cast<ChordId>(iterator->first - key) > static_cast<ChordId>(iterator->first - iterator->second.from)) {
+        _mutex.unlock();
+        return false;
+    }
+    
+    *node = iterator->second.node;
+    
+    // mark as recently used
+    _lru.splice(_lru.begin(), _lru, iterator->second.lruPosition);
+    
+    _mutex.unlock();
+    
+    return true;
+}
+
+// a lookup for the key returned the node
+void ChordLocationCache::insert (ChordId key, ChordHeaderNode node)
+{
+    ChordId nodeId { ntohId(node.nodeId) };
+    
+    _mutex.lock();
+    
+    auto iterator = _entries.find(nodeId);
+    
+    if (iterator != _entries.end()) {
+        
+        Entry &entry = iterator->second;
+        
+        // the node may have a new address
+        entry.node = node;
+        
+        // extend the range if the key is farther away from the node
+        if (static_cast<ChordId>(nodeId - key) > static_cast<ChordId>(nodeId - entry.from)) {
+            entry.from = key;
+        }
+        
+        _lru.splice(_lru.begin(), _lru, entry.lruPosition);
+        
+    } else {
+        
+        _lru.push_front(nodeId);
+        
+        Entry entry;
+        entry.from = key;
+        entry.node = node;
+        entry.lruPosition = _lru.begin();
+        _entries[nodeId] = entry;
+        
+        // drop the least recently used range
+        if (_entries.size() > _capacity) {
+            _entries.erase(_lru.back());
+            _lru.pop_back();
+        }
+    }
+    
+    _mutex.unlock();
+}
+
+// the node died or isn't responsible for its cached range anymore
+void ChordLocationCache::removeNode (ChordId nodeId)
+{
+    _mutex.lock();
+    
+    auto iterator = _entries.find(nodeId);
+    if (iterator != _entries.end()) {
+        _lru.erase(iterator->second.lruPosition);
+        _entries.erase(iterator);
+    }
+    
+    _mutex.unlock();
+}
+
+// a new node joined - the range that contains its id is wrong now
+void ChordLocationCache::nodeJoined (ChordId nodeId)
+{
+    _mutex.lock();
+    
+    auto iterator = entryForKey(nodeId);
+    
+    // the new node is inside [from, node id) -> it took a part of the range
+    if (iterator != _entries.end() && iterator->first != nodeId &&
+        static_cast<ChordId>(iterator->first - nodeId) <= static_cast<ChordId>(iterator->first - iterator->second.from)) {
+        _lru.erase(iterator->second.lruPosition);
+        _entries.erase(iterator);
+    }
+    
+    _mutex.unlock();
+}
+
+// drops all ranges
+void ChordLocationCache::clear ()
+{
+    _mutex.lock();
+    _entries.clear();
+    _lru.clear();
+    _mutex.unlock();
+}
+
+#pragma mark - Private
+
+// returns the entry whose range may contain the key
+std::map<ChordId, ChordLocationCache::Entry>::iterator ChordLocationCache::entryForKey (ChordId key)
+{
+    auto iterator = _entries.lower_bound(key);
+    
+    // wrap around zero
+    if (iterator == _entries.end()) {
+        iterator = _entries.begin();
+    }
+    
+    return iterator;
+}
@@ -0,0 +1,141 @@
+/*
+ ChordLog.cpp
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/ChordLog.h>
+#include <rgp/Log.h>
+
+#include <cstdlib>
+
+using namespace rgp;
+
+const size_t ChordLog::kRingCapacity;
+
+#pragma mark - Constructor / Destructor
+
+ChordLog::ChordLog ()
+: _ring(kRingCapacity)
+{
+    // create the output first - it has to outlive us
+    Log::sharedLog();
+    
+    _writerThread = std::thread(&ChordLog::runWriter, this);
+    _writerThread.detach();
+}
+
+ChordLog::~ChordLog ()
+{
+    // never called (see sharedLog)
+}
+
+#pragma mark - Public
+
+// the log of the process
+ChordLog * ChordLog::sharedLog ()
+{
+    // never destroyed - threads of the library may log till the process ends
+    static ChordLog *log = [] () {
+        ChordLog *log { new ChordLog() };
+        std::atexit([] () { ChordLog::sharedLog()->flush(); });
+        return log;
+    }();
+    
+    return log;
+}
+
+// queues the message
+void ChordLog::write (ChordLogLevel level, std::string message)
+{
+    _ring_mutex.lock();
+    
+    if (_ringCount == _ring.size()) {
+        _ring_mutex.unlock();
+        _droppedMessages.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    
+    ChordLogEntry &entry = _ring[(_ringHead + _ringCount) % _ring.size()];
+    entry.level = level;
+    entry.message.swap(message);
+    _ringCount++;
+    
+    _ring_mutex.unlock();
+    
+    _ring_condition.notify_one();
+}
+
+// waits till all queued messages are written
+void ChordLog::flush ()
+{
+    std::unique_lock<std::mutex> lock(_ring_mutex);
+    _flush_condition.wait(lock, [this] () { return _ringCount == 0 && !_writing; });
+}
+
+#pragma mark - Private
+
+// method of writerThread
+void ChordLog::runWriter ()
+{
+    std::vector<ChordLogEntry> entries;
+    // dropped messages that were already reported
+    uint64_t reportedDrops { 0 };
+    
+    while (true) {
+        
+        std::unique_lock<std::mutex> lock(_ring_mutex);
+        _writing = false;
+        _flush_condition.notify_all();
+        _ring_condition.wait(lock, [this] () { return _ringCount > 0; });
+        
+        // take all queued messages - the writers don't wait for the output
+        while (_ringCount > 0) {
+            ChordLogEntry entry;
+            entry.level = _ring[_ringHead].level;
+            entry.message.swap(_ring[_ringHead].message);
+            entries.push_back(entry);
+            
+            _ringHead = (_ringHead + 1) % _ring.size();
+            _ringCount--;
+        }
+        _writing = true;
+        lock.unlock();
+        
+        for (ChordLogEntry &entry : entries) {
+            if (entry.level <= ChordLogLevelWarning) {
+                Log::sharedLog()->error(entry.message);
+            } else {
+                Log::sharedLog()->print(entry.message);
+            }
+        }
+        entries.clear();
+        
+        // report lost messages once they are written
+        uint64_t dropped { _droppedMessages.load(std::memory_order_relaxed) };
+        if (dropped > reportedDrops) {
+            Log::sharedLog()->error(std::string("ChordLog: dropped messages (log is too slow): ") += std::to_string(dropped - reportedDrops));
+            reportedDrops = dropped;
+        }
+    }
+}
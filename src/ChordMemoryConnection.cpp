@@ -0,0 +1,239 @@
+/*
+ ChordMemoryConnection.cpp
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/ChordMemoryConnection.h>
+#include <rgp/ChordMemoryNetwork.h>
+
+#include <cstring>
+#include <algorithm>
+#include <arpa/inet.h>
+
+using namespace rgp;
+
+#pragma mark - Constructor / Destructor
+
+ChordMemoryConnection::ChordMemoryConnection (std::shared_ptr<ChordMemoryNetwork> network, std::string localAddress,
+                                              std::string remoteAddress)
+: _network(network), _localAddress(localAddress), _remoteAddress(remoteAddress)
+{
+}
+
+#pragma mark - Public
+
+// sends a copy of the message to the remote end
+void ChordMemoryConnection::send (ChordHeader header, std::shared_ptr<uint8_t> data, uint32_t dataSize)
+{
+    std::shared_ptr<ChordMemoryNetwork> network { _network.lock() };
+    
+    ChordMemoryMessage message { header, nullptr, false };
+    message.header.dataSize = htonl(dataSize);
+    
+    // the sender may reuse its buffer (like with a socket)
+    if (dataSize > 0 && data) {
+        message.data = std::shared_ptr<uint8_t> { new uint8_t[dataSize], std::default_delete<uint8_t[]>() };
+        memcpy(message.data.get(), data.get(), dataSize);
+    }
+    
+    _mutex.lock();
+    
+    if (_closed || !network) {
+        _mutex.unlock();
+        throw ChordConnectionException { "not connected" };
+    }
+    
+    std::shared_ptr<ChordMemoryConnection> peer { _peer.lock() };
+    if (!peer) {
+        _mutex.unlock();
+        throw ChordConnectionException { "Remote Node closed connection" };
+    }
+    
+    // messages don't overtake each other (even with jitter)
+    _lastArrival = std::max(network->arrivalTime(), _lastArrival);
+    network->schedule(_lastArrival, std::bind(&ChordMemoryConnection::deliver, peer, message));
+    
+    _mutex.unlock();
+}
+
+// passes the received messages to the handler
+void ChordMemoryConnection::receive (ChordMessageHandler handler, ChordClosedHandler closedHandler)
+{
+    std::shared_ptr<ChordMemoryNetwork> network { _network.lock() };
+    
+    _mutex.lock();
+    if (!_closed) {
+        _handler = handler;
+        _closedHandler = closedHandler;
+        _receiving = true;
+        startDraining(network);
+    }
+    _mutex.unlock();
+}
+
+// closes the connection - the remote end is closed after the last send message arrived
+void ChordMemoryConnection::close ()
+{
+    std::shared_ptr<ChordMemoryNetwork> network { _network.lock() };
+    
+    _mutex.lock();
+    
+    if (!closeLocked()) {
+        _mutex.unlock();
+        return;
+    }
+    
+    std::shared_ptr<ChordMemoryConnection> peer { _peer.lock() };
+    if (network && peer) {
+        ChordMemoryMessage message { ChordHeader(), nullptr, true };
+        _lastArrival = std::max(network->arrivalTime(), _lastArrival);
+        network->schedule(_lastArrival, std::bind(&ChordMemoryConnection::deliver, peer, message));
+    }
+    
+    _mutex.unlock();
+    
+    if (network) {
+        network->removeConnection(shared_from_this());
+    }
+}
+
+// the connection broke (an address failed)
+void ChordMemoryConnection::breakConnection (bool local)
+{
+    std::shared_ptr<ChordMemoryNetwork> network { _network.lock() };
+    
+    _mutex.lock();
+    
+    if (local) {
+        // the node is gone - nobody handles the messages anymore
+        bool closed { closeLocked() };
+        _mutex.unlock();
+        
+        if (closed && network) {
+            network->removeConnection(shared_from_this());
+        }
+        return;
+    }
+    
+    // the remote node is gone - the messages that already arrived are still
+    // handled, followed by the end of the connection
+    // (messages that are still on their way get lost)
+    if (!_closed) {
+        _inbox.push_back(ChordMemoryMessage { ChordHeader(), nullptr, true });
+        startDraining(network);
+    }
+    
+    _mutex.unlock();
+}
+
+#pragma mark - Private
+
+// a message of the remote end arrived
+void ChordMemoryConnection::deliver (ChordMemoryMessage message)
+{
+    std::shared_ptr<ChordMemoryNetwork> network { _network.lock() };
+    
+    _mutex.lock();
+    
+    // a closed end (or one that already knows that its peer is gone) drops the message
+    if (!_closed && (_inbox.empty() || !_inbox.back().closed)) {
+        _inbox.push_back(message);
+        startDraining(network);
+    }
+    
+    _mutex.unlock();
+}
+
+// starts a worker for the inbox if needed
+void ChordMemoryConnection::startDraining (std::shared_ptr<ChordMemoryNetwork> network)
+{
+    if (_draining || !_receiving || _inbox.empty() || !network) {
+        return;
+    }
+    
+    _draining = true;
+    network->dispatch(std::bind(&ChordMemoryConnection::drain, shared_from_this()));
+}
+
+// passes the messages of the inbox to the handler - one message at a time
+void ChordMemoryConnection::drain ()
+{
+    std::shared_ptr<ChordMemoryNetwork> network { _network.lock() };
+    
+    while (true) {
+        
+        _mutex.lock();
+        
+        if (_closed || _inbox.empty()) {
+            _draining = false;
+            _mutex.unlock();
+            return;
+        }
+        
+        ChordMemoryMessage message { _inbox.front() };
+        _inbox.pop_front();
+        
+        // end of the connection
+        if (message.closed) {
+            ChordClosedHandler closedHandler { _closedHandler };
+            closeLocked();
+            _draining = false;
+            _mutex.unlock();
+            
+            if (network) {
+                network->removeConnection(shared_from_this());
+            }
+            if (closedHandler) {
+                closedHandler();
+            }
+            return;
+        }
+        
+        // the handler may replace itself
+        ChordMessageHandler handler { _handler };
+        _mutex.unlock();
+        
+        if (network) {
+            network->countDelivered(static_cast<ChordMessageType>(message.header.type));
+        }
+        if (handler) {
+            handler(message.header, message.data);
+        }
+    }
+}
+
+// closes this end
+bool ChordMemoryConnection::closeLocked ()
+{
+    if (_closed) {
+        return false;
+    }
+    
+    _closed = true;
+    _inbox.clear();
+    _handler = nullptr;
+    _closedHandler = nullptr;
+    
+    return true;
+}
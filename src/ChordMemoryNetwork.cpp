@@ -0,0 +1,323 @@
+/*
+ ChordMemoryNetwork.cpp
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/ChordMemoryNetwork.h>
+#include <rgp/ChordMemoryConnection.h>
+#include <rgp/ChordLog.h>
+
+using namespace rgp;
+
+const int ChordMemoryNetwork::kDefaultWorkerCount;
+
+#pragma mark - Constructor / Destructor
+
+ChordMemoryNetwork::ChordMemoryNetwork (int workerCount)
+: _random(std::random_device()())
+{
+    resetCounters();
+    
+    // start workers
+    if (workerCount < 1) {
+        workerCount = 1;
+    }
+    for (int k = 0; k < workerCount; k++) {
+        _workerThreads.push_back(std::thread(&ChordMemoryNetwork::runWorker, this));
+    }
+    
+    // start scheduler
+    _schedulerThread = std::thread(&ChordMemoryNetwork::runScheduler, this);
+}
+
+ChordMemoryNetwork::~ChordMemoryNetwork ()
+{
+    _stop = true;
+    
+    // wake up scheduler
+    _scheduledTasks_mutex.lock();
+    _scheduledTasks_condition.notify_all();
+    _scheduledTasks_mutex.unlock();
+    
+    try {
+        _schedulerThread.join();
+    } catch (...) {} // if thread not joinable
+    
+    // wake up workers
+    _tasks_mutex.lock();
+    _tasks_condition.notify_all();
+    _tasks_mutex.unlock();
+    
+    for (std::thread &worker : _workerThreads) {
+        try {
+            worker.join();
+        } catch (...) {} // if thread not joinable
+    }
+    
+    // release the connections outside of the lock
+    _network_mutex.lock();
+    std::set<std::shared_ptr<ChordMemoryConnection>> connections;
+    connections.swap(_connections);
+    _listeners.clear();
+    _network_mutex.unlock();
+}
+
+#pragma mark - Public
+
+// one way delay of every message
+void ChordMemoryNetwork::setLatency (std::chrono::microseconds latency, std::chrono::microseconds jitter)
+{
+    _latency = std::max<int64_t>(0, latency.count());
+    _jitter = std::max<int64_t>(0, jitter.count());
+}
+
+// fails (or revives) an address
+void ChordMemoryNetwork::setFailed (std::string ipAddress, uint16_t port, bool failed)
+{
+    std::string address { addressKey(ipAddress, port) };
+    std::vector<std::shared_ptr<ChordMemoryConnection>> brokenConnections;
+    
+    _network_mutex.lock();
+    if (!failed) {
+        _failedAddresses.erase(address);
+    } else {
+        _failedAddresses.insert(address);
+        
+        for (std::shared_ptr<ChordMemoryConnection> connection : _connections) {
+            if (connection->localAddress() == address || connection->remoteAddress() == address) {
+                brokenConnections.push_back(connection);
+            }
+        }
+    }
+    _network_mutex.unlock();
+    
+    // the connections remove themselves from the network
+    for (std::shared_ptr<ChordMemoryConnection> connection : brokenConnections) {
+        connection->breakConnection(connection->localAddress() == address);
+    }
+}
+
+bool ChordMemoryNetwork::isFailed (std::string ipAddress, uint16_t port)
+{
+    _network_mutex.lock();
+    bool failed { _failedAddresses.count(addressKey(ipAddress, port)) > 0 };
+    _network_mutex.unlock();
+    
+    return failed;
+}
+
+// number of messages of the given type that were received by a node
+uint64_t ChordMemoryNetwork::deliveredMessages (ChordMessageType type) const
+{
+    return _deliveredMessages[static_cast<uint8_t>(type)];
+}
+
+// number of all received messages
+uint64_t ChordMemoryNetwork::deliveredMessages () const
+{
+    uint64_t count { 0 };
+    for (const std::atomic<uint64_t> &counter : _deliveredMessages) {
+        count += counter;
+    }
+    
+    return count;
+}
+
+// sets all message counters to 0
+void ChordMemoryNetwork::resetCounters ()
+{
+    for (std::atomic<uint64_t> &counter : _deliveredMessages) {
+        counter = 0;
+    }
+}
+
+// accepts connections to the given address
+bool ChordMemoryNetwork::listen (std::string ipAddress, uint16_t port, ChordTransport::ChordAcceptHandler handler)
+{
+    std::string address { addressKey(ipAddress, port) };
+    
+    _network_mutex.lock();
+    bool used { _listeners.count(address) > 0 };
+    if (!used) {
+        _listeners[address] = handler;
+    }
+    _network_mutex.unlock();
+    
+    if (used) {
+        CHORD_LOGE("ChordMemoryNetwork::listen(): address already in use: " << address);
+    }
+    
+    return !used;
+}
+
+void ChordMemoryNetwork::stopListening (std::string ipAddress, uint16_t port)
+{
+    _network_mutex.lock();
+    _listeners.erase(addressKey(ipAddress, port));
+    _network_mutex.unlock();
+}
+
+// connects the local address to the remote address
+std::shared_ptr<ChordConnection> ChordMemoryNetwork::connect (std::string localIpAddress, uint16_t localPort,
+                                                              std::string ipAddress, uint16_t port)
+{
+    std::string localAddress { addressKey(localIpAddress, localPort) };
+    std::string remoteAddress { addressKey(ipAddress, port) };
+    
+    _network_mutex.lock();
+    
+    auto listener = _listeners.find(remoteAddress);
+    
+    // nobody listens or one side is down - like a refused connection
+    if (listener == _listeners.end() ||
+        _failedAddresses.count(localAddress) > 0 || _failedAddresses.count(remoteAddress) > 0) {
+        _network_mutex.unlock();
+        return nullptr;
+    }
+    
+    ChordTransport::ChordAcceptHandler handler { listener->second };
+    
+    // both ends of the connection
+    std::shared_ptr<ChordMemoryConnection> localEnd;
+    localEnd = std::make_shared<ChordMemoryConnection>(shared_from_this(), localAddress, remoteAddress);
+    std::shared_ptr<ChordMemoryConnection> remoteEnd;
+    remoteEnd = std::make_shared<ChordMemoryConnection>(shared_from_this(), remoteAddress, localAddress);
+    
+    localEnd->setPeer(remoteEnd);
+    remoteEnd->setPeer(localEnd);
+    
+    _connections.insert(localEnd);
+    _connections.insert(remoteEnd);
+    
+    _network_mutex.unlock();
+    
+    // the remote node accepts the connection
+    // (messages that arrive before it receives are kept by the connection)
+    dispatch(std::bind(handler, remoteEnd));
+    
+    return localEnd;
+}
+
+// executes the task on one of the worker threads
+void ChordMemoryNetwork::dispatch (std::function<void ()> task)
+{
+    _tasks_mutex.lock();
+    _tasks.push(task);
+    _tasks_mutex.unlock();
+    
+    _tasks_condition.notify_one();
+}
+
+// executes the task at the given time
+void ChordMemoryNetwork::schedule (std::chrono::steady_clock::time_point time, std::function<void ()> task)
+{
+    _scheduledTasks_mutex.lock();
+    _scheduledTasks.push(ChordScheduledTask { time, _nextSequence++, task });
+    _scheduledTasks_mutex.unlock();
+    
+    _scheduledTasks_condition.notify_one();
+}
+
+// time a message that is send now arrives
+std::chrono::steady_clock::time_point ChordMemoryNetwork::arrivalTime ()
+{
+    int64_t delay { _latency };
+    int64_t jitter { _jitter };
+    
+    if (jitter > 0) {
+        _random_mutex.lock();
+        delay += std::uniform_int_distribution<int64_t>(0, jitter)(_random);
+        _random_mutex.unlock();
+    }
+    
+    return std::chrono::steady_clock::now() + std::chrono::microseconds(delay);
+}
+
+// counts a received message
+void ChordMemoryNetwork::countDelivered (ChordMessageType type)
+{
+    _deliveredMessages[static_cast<uint8_t>(type)]++;
+}
+
+// forgets a closed connection
+void ChordMemoryNetwork::removeConnection (std::shared_ptr<ChordMemoryConnection> connection)
+{
+    _network_mutex.lock();
+    _connections.erase(connection);
+    _network_mutex.unlock();
+}
+
+#pragma mark - Private
+
+// key of an address
+std::string ChordMemoryNetwork::addressKey (std::string ipAddress, uint16_t port)
+{
+    return (ipAddress += ":") += std::to_string(port);
+}
+
+void ChordMemoryNetwork::runWorker ()
+{
+    while (true) {
+        
+        std::unique_lock<std::mutex> lock(_tasks_mutex);
+        _tasks_condition.wait(lock, [this] { return _stop || !_tasks.empty(); });
+        
+        if (_stop) {
+            break;
+        }
+        
+        std::function<void ()> task { _tasks.front() };
+        _tasks.pop();
+        lock.unlock();
+        
+        task();
+    }
+}
+
+void ChordMemoryNetwork::runScheduler ()
+{
+    std::unique_lock<std::mutex> lock(_scheduledTasks_mutex);
+    
+    while (!_stop) {
+        
+        if (_scheduledTasks.empty()) {
+            _scheduledTasks_condition.wait(lock);
+            continue;
+        }
+        
+        // wait for the earliest task (a new task may be earlier)
+        std::chrono::steady_clock::time_point time { _scheduledTasks.top().time };
+        if (time > std::chrono::steady_clock::now()) {
+            _scheduledTasks_condition.wait_until(lock, time);
+            continue;
+        }
+        
+        std::function<void ()> task { _scheduledTasks.top().task };
+        _scheduledTasks.pop();
+        
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
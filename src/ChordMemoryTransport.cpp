@@ -0,0 +1,60 @@
+/*
+ ChordMemoryTransport.cpp
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/ChordMemoryTransport.h>
+
+using namespace rgp;
+
+#pragma mark - Constructor / Destructor
+
+ChordMemoryTransport::ChordMemoryTransport (std::shared_ptr<ChordMemoryNetwork> network, std::string ipAddress,
+                                            uint16_t port)
+: _network(network), _ipAddress(ipAddress), _port(port)
+{
+}
+
+#pragma mark - Public
+
+bool ChordMemoryTransport::listen (std::string ipAddress, uint16_t port, ChordAcceptHandler handler)
+{
+    return _network->listen(ipAddress, port, handler);
+}
+
+void ChordMemoryTransport::stopListening (std::string ipAddress, uint16_t port)
+{
+    _network->stopListening(ipAddress, port);
+}
+
+// connects from the address of our node
+std::shared_ptr<ChordConnection> ChordMemoryTransport::connect (std::string ipAddress, uint16_t port)
+{
+    return _network->connect(_ipAddress, _port, ipAddress, port);
+}
+
+void ChordMemoryTransport::dispatch (std::function<void ()> task)
+{
+    _network->dispatch(task);
+}
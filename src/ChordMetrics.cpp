@@ -0,0 +1,226 @@
+/*
+ ChordMetrics.cpp
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/ChordMetrics.h>
+
+#include <sstream>
+
+using namespace rgp;
+
+const int ChordMetrics::kMessageTypeCount;
+
+// labels of a line ({a="1",b="2"} or nothing)
+static std::string metricsLabels (std::string labels, std::string additionalLabels = "")
+{
+    if (!labels.empty() && !additionalLabels.empty()) {
+        labels += ",";
+    }
+    labels += additionalLabels;
+    
+    return labels.empty() ? "" : (std::string("{") += labels) += "}";
+}
+
+#pragma mark - Constructor / Destructor
+
+ChordMetrics::ChordMetrics ()
+{
+    for (std::atomic<ChordHistogram *> &histogram : _requestLatencies) {
+        histogram = nullptr;
+    }
+}
+
+ChordMetrics::~ChordMetrics ()
+{
+    for (std::atomic<ChordHistogram *> &histogram : _requestLatencies) {
+        delete histogram.load();
+    }
+}
+
+#pragma mark - Public
+
+// a message was sent
+void ChordMetrics::messageSent (ChordMessageType type, uint64_t dataSize)
+{
+    _messagesSent[indexForType(type)].add();
+    _bytesSent.add(dataSize);
+}
+
+// a message was received
+void ChordMetrics::messageReceived (ChordMessageType type, uint64_t dataSize)
+{
+    _messagesReceived[indexForType(type)].add();
+    _bytesReceived.add(dataSize);
+}
+
+// a request was answered
+void ChordMetrics::requestHandled (ChordMessageType type, std::chrono::steady_clock::duration duration)
+{
+    requestLatency(type)->record(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+}
+
+// a lookup of this node finished
+void ChordMetrics::lookupFinished (std::chrono::steady_clock::duration duration, bool failed)
+{
+    if (failed) {
+        _failedLookups.add();
+        return;
+    }
+    
+    _lookupLatency.record(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+}
+
+// one round of the stabilize protocol finished
+void ChordMetrics::stabilizeRoundFinished (std::chrono::steady_clock::duration duration)
+{
+    _stabilizeRoundDuration.record(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+}
+
+// all values as text
+std::string ChordMetrics::snapshot (std::string labels) const
+{
+    std::stringstream text;
+    
+    for (int index = 0; index < kMessageTypeCount; index++) {
+        
+        std::string typeLabels { metricsLabels(labels, (std::string("type=\"") += nameForMessageType(static_cast<ChordMessageType>(index))) += "\"") };
+        
+        // most types are never sent or received by a node
+        uint64_t sent { _messagesSent[index].value() };
+        if (sent > 0) {
+            text << "chord_messages_sent_total" << typeLabels << " " << sent << std::endl;
+        }
+        
+        uint64_t received { _messagesReceived[index].value() };
+        if (received > 0) {
+            text << "chord_messages_received_total" << typeLabels << " " << received << std::endl;
+        }
+    }
+    
+    text << "chord_bytes_sent_total" << metricsLabels(labels) << " " << _bytesSent.value() << std::endl;
+    text << "chord_bytes_received_total" << metricsLabels(labels) << " " << _bytesReceived.value() << std::endl;
+    
+    std::string histograms;
+    
+    for (int index = 0; index < kMessageTypeCount; index++) {
+        ChordHistogram *histogram { _requestLatencies[index].load(std::memory_order_acquire) };
+        
+        if (histogram) {
+            appendHistogram(&histograms, "chord_request_latency_us",
+                            metricsLabels(labels, (std::string("type=\"") += nameForMessageType(static_cast<ChordMessageType>(index))) += "\""),
+                            *histogram);
+        }
+    }
+    
+    appendHistogram(&histograms, "chord_lookup_latency_us", metricsLabels(labels), _lookupLatency);
+    appendHistogram(&histograms, "chord_lookup_hops", metricsLabels(labels), _lookupHops);
+    appendHistogram(&histograms, "chord_stabilize_round_us", metricsLabels(labels), _stabilizeRoundDuration);
+    
+    text << histograms;
+    text << "chord_lookups_failed_total" << metricsLabels(labels) << " " << _failedLookups.value() << std::endl;
+    text << "chord_searches_resolved_total" << metricsLabels(labels) << " " << _searchesResolved.value() << std::endl;
+    text << "chord_searches_forwarded_total" << metricsLabels(labels) << " " << _searchesForwarded.value() << std::endl;
+    
+    return text.str();
+}
+
+// name of the message type inside the snapshot
+const char * ChordMetrics::nameForMessageType (ChordMessageType type)
+{
+    switch (type) {
+        case ChordMessageTypeIdentify:                return "identify";
+        case ChordMessageTypeHeartbeat:               return "heartbeat";
+        case ChordMessageTypeHeartbeatReply:          return "heartbeat_reply";
+        case ChordMessageTypeSearch:                  return "search";
+        case ChordMessageTypeSearchNodeResponse:      return "search_node_response";
+        case ChordMessageTypeDataRequest:             return "data_request";
+        case ChordMessageTypeDataAnswer:              return "data_answer";
+        case ChordMessageTypeDataNotFound:            return "data_not_found";
+        case ChordMessageTypeDataAdd:                 return "data_add";
+        case ChordMessageTypeDataAddFailed:           return "data_add_failed";
+        case ChordMessageTypeDataAddSuccess:          return "data_add_success";
+        case ChordMessageTypeUpdatePredecessor:       return "update_predecessor";
+        case ChordMessageTypeTellPredecessor:         return "tell_predecessor";
+        case ChordMessageTypePredecessor:             return "predecessor";
+        case ChordMessageTypeSearchNextHops:          return "search_next_hops";
+        case ChordMessageTypeSearchNextHopsResponse:  return "search_next_hops_response";
+        case ChordMessageTypeReplicaAdd:              return "replica_add";
+        case ChordMessageTypeDataTransfer:            return "data_transfer";
+        case ChordMessageTypeDataMultiRequest:        return "data_multi_request";
+        case ChordMessageTypeDataMultiAnswer:         return "data_multi_answer";
+        case ChordMessageTypeReplicaTransfer:         return "replica_transfer";
+    }
+    
+    return "unknown";
+}
+
+#pragma mark - Private
+
+// histogram of the request type (creates it if needed)
+ChordHistogram * ChordMetrics::requestLatency (ChordMessageType type)
+{
+    std::atomic<ChordHistogram *> &slot = _requestLatencies[indexForType(type)];
+    
+    ChordHistogram *histogram { slot.load(std::memory_order_acquire) };
+    if (histogram) {
+        return histogram;
+    }
+    
+    // several threads may create it - only one of them wins
+    ChordHistogram *newHistogram { new ChordHistogram() };
+    if (slot.compare_exchange_strong(histogram, newHistogram, std::memory_order_acq_rel)) {
+        return newHistogram;
+    }
+    
+    delete newHistogram;
+    return histogram;
+}
+
+// index of the type inside the arrays
+int ChordMetrics::indexForType (ChordMessageType type)
+{
+    return type < kMessageTypeCount - 1 ? type : kMessageTypeCount - 1;
+}
+
+// appends the lines of a histogram
+void ChordMetrics::appendHistogram (std::string *text, std::string name, std::string labels, const ChordHistogram &histogram)
+{
+    if (histogram.count() == 0) {
+        return;
+    }
+    
+    // the quantile is the last label
+    std::string quantileLabels { labels.empty() ? "{" : labels.substr(0, labels.size() - 1) += "," };
+    
+    std::stringstream lines;
+    lines << name << quantileLabels << "quantile=\"0.5\"} " << histogram.valueAtPercentile(0.5) << std::endl
+          << name << quantileLabels << "quantile=\"0.99\"} " << histogram.valueAtPercentile(0.99) << std::endl
+          << name << quantileLabels << "quantile=\"0.999\"} " << histogram.valueAtPercentile(0.999) << std::endl
+          << name << "_max" << labels << " " << histogram.max() << std::endl
+          << name << "_mean" << labels << " " << histogram.mean() << std::endl
+          << name << "_count" << labels << " " << histogram.count() << std::endl;
+    
+    *text += lines.str();
+}
@@ -0,0 +1,174 @@
+/*
+ ChordMetricsServer.cpp
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/ChordMetricsServer.h>
+#include <rgp/ChordLog.h>
+#include <rgp/Log.h>
+
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+using namespace rgp;
+
+#pragma mark - Constructor / Destructor
+
+ChordMetricsServer::ChordMetricsServer (std::string socketPath, ChordMetricsProvider provider)
+: _socketPath { socketPath }, _provider { provider }
+{
+}
+
+ChordMetricsServer::~ChordMetricsServer ()
+{
+    _stop = true;
+    
+    if (_serverThread.joinable()) {
+        
+        // wake up server
+        uint64_t wakeup { 1 };
+        if (write(_wakeupSocket, &wakeup, sizeof(wakeup)) < 0) {
+            Log::sharedLog()->errorWithErrno("ChordMetricsServer::~ChordMetricsServer():write() ", errno);
+        }
+        
+        _serverThread.join();
+    }
+    
+    if (_listenSocket >= 0) {
+        close(_listenSocket);
+        unlink(_socketPath.c_str());
+    }
+    if (_wakeupSocket >= 0) {
+        close(_wakeupSocket);
+    }
+}
+
+#pragma mark - Public
+
+// binds the socket and starts serving (false on error)
+bool ChordMetricsServer::start ()
+{
+    struct sockaddr_un address { };
+    address.sun_family = AF_UNIX;
+    
+    if (_socketPath.empty() || _socketPath.size() >= sizeof(address.sun_path)) {
+        CHORD_LOGE("ChordMetricsServer::start(): invalid socket path " << _socketPath);
+        return false;
+    }
+    strncpy(address.sun_path, _socketPath.c_str(), sizeof(address.sun_path) - 1);
+    
+    _listenSocket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (_listenSocket < 0) {
+        Log::sharedLog()->errorWithErrno("ChordMetricsServer::start():socket() ", errno);
+        return false;
+    }
+    
+    // remove the socket of a previous run
+    unlink(_socketPath.c_str());
+    
+    if (bind(_listenSocket, (struct sockaddr *)&address, sizeof(address)) != 0) {
+        Log::sharedLog()->errorWithErrno("ChordMetricsServer::start():bind() ", errno);
+        close(_listenSocket);
+        _listenSocket = -1;
+        return false;
+    }
+    
+    if (listen(_listenSocket, 8) != 0) {
+        Log::sharedLog()->errorWithErrno("ChordMetricsServer::start():listen() ", errno);
+        close(_listenSocket);
+        unlink(_socketPath.c_str());
+        _listenSocket = -1;
+        return false;
+    }
+    
+    _wakeupSocket = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (_wakeupSocket < 0) {
+        Log::sharedLog()->errorWithErrno("ChordMetricsServer::start():eventfd() ", errno);
+        return false;
+    }
+    
+    _serverThread = std::thread(&ChordMetricsServer::runServer, this);
+    
+    return true;
+}
+
+#pragma mark - Private
+
+// method of serverThread
+void ChordMetricsServer::runServer ()
+{
+    struct pollfd sockets[2] { };
+    sockets[0].fd = _listenSocket;
+    sockets[0].events = POLLIN;
+    sockets[1].fd = _wakeupSocket;
+    sockets[1].events = POLLIN;
+    
+    while (!_stop) {
+        
+        int count = poll(sockets, 2, -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            Log::sharedLog()->errorWithErrno("ChordMetricsServer::runServer():poll() ", errno);
+            break;
+        }
+        
+        if (_stop || sockets[1].revents != 0) {
+            break;
+        }
+        
+        if (sockets[0].revents & POLLIN) {
+            int client = accept4(_listenSocket, nullptr, nullptr, SOCK_CLOEXEC);
+            if (client >= 0) {
+                serveClient(client);
+            }
+        }
+    }
+}
+
+// sends the snapshot to the client and closes it
+void ChordMetricsServer::serveClient (int socket)
+{
+    std::string text { _provider() };
+    
+    size_t sent { 0 };
+    while (sent < text.size()) {
+        ssize_t size = send(socket, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+        if (size < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break; // client is gone
+        }
+        sent += size;
+    }
+    
+    close(socket);
+}
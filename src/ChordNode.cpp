@@ -25,42 +25,67 @@
 */
 
 #include <rgp/ChordNode.h>
-#include <rgp/Log.h>
+#include <rgp/ChordConnection.h>
+#include <rgp/ChordTransport.h>
+#include <rgp/ChordWire.h>
+#include <rgp/ChordLog.h>
 
 #include <sstream>
 #include <unistd.h>
 #include <cstring>
 #include <memory>
+#include <list>
+#include <future>
+#include <chrono>
 
 // network
 #include <arpa/inet.h>
-#include <netdb.h>
 
 using namespace rgp;
 
+const uint32_t ChordNode::kTransferBatchSize;
+const int ChordNode::kTransferWindow;
+const int ChordNode::kRequestTimeoutSeconds;
+
+namespace rgp {
+    
+    // state of a data transfer (shared by all batches)
+    struct ChordTransfer {
+        // data transfer or replica transfer
+        ChordMessageType type { ChordMessageTypeDataTransfer };
+        std::shared_ptr<std::vector<ChordDataItem>> items;
+        ChordPutHandler handler;
+        // protect the transfer state
+        std::mutex mutex;
+        // first item that wasn't send yet
+        size_t nextItem { 0 };
+        // number of batches waiting for their ack
+        int pendingBatches { 0 };
+        // all items were added by the remote node
+        bool added { true };
+        // first error of a batch
+        std::exception_ptr error;
+        // the handler was called
+        bool finished { false };
+    };
+}
+
 #pragma mark - Constructor / Destructor
 
-ChordNode::ChordNode (ChordId node, std::string ip, uint16_t port, std::shared_ptr<Chord> chord)
-: _nodeID(node), _ipAddress(ip), _port(port)
+ChordNode::ChordNode (ChordId node, std::string ip, uint16_t port, std::weak_ptr<Chord> chord)
+: _nodeID(node), _ipAddress(ip), _port(port), _chord(chord)
 {
-    _chord = chord;
 }
 
 ChordNode::~ChordNode ()
 {
-    // stop request handler
-    _stopRequestHandlerThread = true;
-    try {
-        // wait till request handler finished
-        _requestHandlerThread.join();
-        
-        // catched if requestHandlerThread is not running (or not joinable)
-    } catch (...) {}
+    // stop handling requests
+    closeReceiveConnection();
     
-    // disconnect sendSocket if connected
-    if (_sendSocket != -1) {
-        close(_sendSocket);
-        _sendSocket = -1;
+    // disconnect send connection if connected
+    if (_sendConnection) {
+        _sendConnection->close();
+        _sendConnection.reset();
     }
 }
 
@@ -71,7 +96,7 @@ ChordHeaderNode ChordNode::chordNode () const
 {
     ChordHeaderNode node {0, 0, 0};
     
-    node.nodeId = htons(_nodeID);
+    node.nodeId = htonId(_nodeID);
     node.ip = htonl(inet_addr(_ipAddress.c_str()));
     node.port = htons(_port);
     
@@ -80,55 +105,36 @@ ChordHeaderNode ChordNode::chordNode () const
 
 bool ChordNode::isAlive ()
 {
+    _sendConnection_mutex.lock();
+    bool connected { _sendConnection != nullptr };
+    _sendConnection_mutex.unlock();
+    
     // if we have an open send connection - check if remote node is alive
-    if (_sendSocket > 0) {
+    if (connected) {
         
-        _sendSocket_mutex.lock(); // we use send socket to send data and receive the response
         try {
             // Hearbeat
-            sendRequest(ChordMessageTypeHeartbeat, nullptr, 0);
+            ChordResponse response = request(ChordMessageTypeHeartbeat, nullptr, 0);
+            
+            // success -> node is alive
+            if (response.type == ChordMessageTypeHeartbeatReply) {
+                return true;
+            }
             
         } catch (ChordConnectionException &exception) {
             // error
-            Log::sharedLog()->error(std::string("ChordNode::isAlive(): coulnd't send request: ") += exception.what());
-            
-            close(_sendSocket);
-            _sendSocket = -1;
-        }
-        
-        // receive heartbeat answer
-        if (_sendSocket > 0) {
+            CHORD_LOGE("ChordNode::isAlive(): heartbeat failed: " << exception.what());
             
-            try {
-                
-                std::shared_ptr<ChordMessageType> type;
-                std::shared_ptr<ssize_t> dataSize;
-                
-                std::shared_ptr<uint8_t> data = recvResponse(type, dataSize);
-                
-                // success -> node is alive
-                if (*type == ChordMessageTypeHeartbeatReply) {
-                    _sendSocket_mutex.unlock();
-                    return true;
-                }
-                
-            } catch (ChordConnectionException &exception) {
-                // error
-                Log::sharedLog()->error(std::string("ChordNode::isAlive(): coulnd't receive request: ") += exception.what());
-                
-                close(_sendSocket);
-                _sendSocket = -1;
-            }
+            closeSendConnection();
         }
-        _sendSocket_mutex.unlock();
     }
     
     // if receive connection is alive - we don't need a hearbeat for this
-    if (_receiveSocket > 0) {
-        return true;
-    }
+    _receiveConnection_mutex.lock();
+    bool receiving { _receiveConnection != nullptr };
+    _receiveConnection_mutex.unlock();
     
-    return false;
+    return receiving;
 }
 
 ChordConnectionStatus ChordNode::establishSendConnection ()
@@ -138,63 +144,68 @@ ChordConnectionStatus ChordNode::establishSendConnection ()
         return ChordConnectionStatusConnectingFailed;
     }
     
-    _sendSocket_mutex.lock();
-    
-    // check if already connected
-    if (_sendSocket != -1) {
-        _sendSocket_mutex.unlock();
-        return ChordConnectionStatusAlreadyConnected;
+    // create strong pointer to chord
+    std::shared_ptr<Chord> chord { _chord.lock() };
+    if (!chord) {
+        CHORD_LOGE("Lost chord pointer!");
+        return ChordConnectionStatusConnectingFailed;
     }
     
-    // create socket
-    _sendSocket = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
+    _sendConnection_mutex.lock();
     
-    // create sockaddr
-    struct sockaddr_in addr4client;
-    memset(&addr4client, 0, sizeof(addr4client)); // fill struct with zeros
-#ifndef __linux__
-    addr4client.sin_len = sizeof(addr4client);
-#endif
-    addr4client.sin_family = AF_INET;
-    addr4client.sin_port = htons(_port);
-    
-    if((addr4client.sin_addr.s_addr = inet_addr(_ipAddress.c_str())) == (unsigned long)INADDR_NONE)
-    {
-        // ERROR: INADDR_NONE - try with hostname
-        struct hostent *hostp = gethostbyname(_ipAddress.c_str());
-        if (hostp == NULL) {
-            Log::sharedLog()->errorWithErrno("ChordNode::establishSendConnection():hostent failed - cannot use given host address ", errno);
-            close(_sendSocket);
-            _sendSocket = -1;
-            _sendSocket_mutex.unlock();
-            return ChordConnectionStatusConnectingFailed; // we cannot connect
-        } else {
-            memcpy(&addr4client.sin_addr, hostp->h_addr, sizeof(addr4client.sin_addr));
-        }
+    // check if already connected
+    if (_sendConnection) {
+        _sendConnection_mutex.unlock();
+        return ChordConnectionStatusAlreadyConnected;
     }
     
     // connect
-    if (connect(_sendSocket, (struct sockaddr*)&addr4client, sizeof(struct sockaddr_in)) != 0) {
-        Log::sharedLog()->errorWithErrno("ChordNode::establishSendConnection():connect(): ", errno);
-        close(_sendSocket);
-        _sendSocket = -1;
-        _sendSocket_mutex.unlock();
+    std::shared_ptr<ChordConnection> connection { chord->transport()->connect(_ipAddress, _port) };
+    if (!connection) {
+        _sendConnection_mutex.unlock();
         return ChordConnectionStatusConnectingFailed; // we cannot connect
     }
     
     // identify ourself
+    // (names the node we want to reach - several nodes may share the port -
+    //  followed by our id width, nodes with another width can't share a ring)
     try {
-        sendRequest(ChordMessageTypeIdentify, NULL, 0);
+        std::shared_ptr<uint8_t> targetId {new uint8_t[kIdentifyDataSize], std::default_delete<uint8_t[]>()};
+        ChordId networkId { htonId(_nodeID) };
+        memcpy(targetId.get(), &networkId, sizeof(ChordId));
+        targetId.get()[sizeof(ChordId)] = ChordIdRing::kKeyLength;
+        
+        connection->send(chord->createChordHeader(ChordMessageTypeIdentify), targetId, kIdentifyDataSize);
     } catch (ChordConnectionException &exception) {
         // send failed
-        Log::sharedLog()->error(std::string("ChordNode::establishSendConnection():identify ") += exception.what());
-        close(_sendSocket);
-        _sendSocket = -1;
-        _sendSocket_mutex.unlock();
+        CHORD_LOGE("ChordNode::establishSendConnection():identify " << exception.what());
+        connection->close();
+        _sendConnection_mutex.unlock();
         return ChordConnectionStatusConnectingFailed; // we cannot connect
     }
     
-    _sendSocket_mutex.unlock();
+    _sendConnection = connection;
+    
+    // the connection must not keep us (or itself) alive
+    std::weak_ptr<ChordNode> weakNode { shared_from_this() };
+    std::weak_ptr<ChordConnection> weakConnection { connection };
+    
+    // responses are received by the transport
+    connection->receive([weakNode] (ChordHeader header, std::shared_ptr<uint8_t> data) {
+        std::shared_ptr<ChordNode> node { weakNode.lock() };
+        if (node) {
+            node->handleResponse(header, data);
+        }
+    }, [weakNode, weakConnection] () {
+        std::shared_ptr<ChordNode> node { weakNode.lock() };
+        std::shared_ptr<ChordConnection> connection { weakConnection.lock() };
+        if (node && connection) {
+            CHORD_LOGV("Node with id: " << node->getNodeID() << " closed the connection");
+            node->sendConnectionClosed(connection);
+        }
+    });
+    
+    _sendConnection_mutex.unlock();
     return ChordConnectionStatusSuccessfullyConnected;
 }
 
@@ -202,227 +213,528 @@ ChordConnectionStatus ChordNode::establishSendConnection ()
 // (f.e. we have a new successor and don't need to keep the connection alive anymore)
 void ChordNode::closeSendConnection ()
 {
-    _sendSocket_mutex.lock();
-    if (_sendSocket > 0) {
-        
-        close(_sendSocket);
-        _sendSocket = -1;
+    _sendConnection_mutex.lock();
+    std::shared_ptr<ChordConnection> connection { _sendConnection };
+    _sendConnection.reset();
+    _sendConnection_mutex.unlock();
+    
+    if (connection) {
+        connection->close();
     }
-    _sendSocket_mutex.unlock();
+    
+    // nobody will answer these requests anymore
+    failPendingRequests("connection closed");
 }
 
 // tell's remote node that i'm his predecessor
 // this method is used by stablilization
 // returns node that the remote node returns
-ChordHeaderNode ChordNode::getPredecessorFromRemoteNode (std::shared_ptr<ChordNode> ownNode)
+ChordHeaderNode ChordNode::getPredecessorFromRemoteNode (std::shared_ptr<ChordNode> ownNode,
+                                                         std::vector<ChordHeaderNode> *successorList)
 {
     ChordHeaderNode pred = ownNode->chordNode();
-    _sendSocket_mutex.lock();
-    // update predecessor with own node
-    try {
-        std::shared_ptr<uint8_t> sendData {new uint8_t[sizeof(ChordHeaderNode)], std::default_delete<uint8_t[]>()};
-        memcpy(sendData.get(), &pred, sizeof(ChordHeaderNode));
-        
-        sendRequest(ChordMessageTypeUpdatePredecessor, sendData, sizeof(ChordHeaderNode));
-    } catch (ChordConnectionException &exception) {
-        Log::sharedLog()->error(std::string("ChordNode::getPredecessorFromRemoteNode():sendRequest(): ") += exception.what());
-        _sendSocket_mutex.unlock();
-        throw ChordConnectionException { "couldn't send request" };
-    }
     
-    // receive the answer
-    std::shared_ptr<ChordMessageType> responseType;
-    std::shared_ptr<uint8_t> data;
-    std::shared_ptr<ssize_t> dataSize { 0 };
+    // update predecessor with own node
+    std::shared_ptr<uint8_t> sendData {new uint8_t[ChordWire::kEncodedNodeSize], std::default_delete<uint8_t[]>()};
+    ChordWire::encodeNode(pred, sendData.get());
     
-    try {
-        data = recvResponse(responseType, dataSize);
-    } catch (ChordConnectionException &exception) {
-        Log::sharedLog()->error(std::string("ChordNode::getPredecessorFromRemoteNode():recvResponse(): ") += exception.what());;
-        _sendSocket_mutex.unlock();
-        throw ChordConnectionException { "couldn't receive response" };
-    }
-    _sendSocket_mutex.unlock();
+    // send and receive the answer
+    ChordResponse response = request(ChordMessageTypeUpdatePredecessor, sendData, ChordWire::kEncodedNodeSize);
     
     // check for available data
-    if (*dataSize == sizeof(ChordHeaderNode)) {
+    // (the predecessor is followed by the successor list of the remote node)
+    if (response.type == ChordMessageTypePredecessor && response.data &&
+        response.dataSize >= ChordWire::kEncodedNodeSize && response.dataSize % ChordWire::kEncodedNodeSize == 0) {
         
-        ChordHeaderNode receivedNode { 0 };
-        if (!data) {
-            Log::sharedLog()->error("responseData == nullptr");
-        } else {
-            memcpy(&receivedNode, &data, sizeof(ChordHeaderNode));
+        ChordHeaderNode receivedNode { ChordWire::decodeNode(response.data.get()) };
+        
+        if (successorList) {
+            for (uint32_t offset = ChordWire::kEncodedNodeSize; offset < response.dataSize; offset += ChordWire::kEncodedNodeSize) {
+                successorList->push_back(ChordWire::decodeNode(response.data.get() + offset));
+            }
         }
+        
         return receivedNode;
         
     } else {
-        Log::sharedLog()->error("answer contains unexpected data size");
+        CHORD_LOGE("answer contains unexpected data size");
         throw ChordConnectionException { "answer contains unexpected data size" };
     }
 }
 
+// tell's remote node (our old predecessor) that the node joined between us
+void ChordNode::suggestSuccessorAsync (ChordHeaderNode node)
+{
+    std::shared_ptr<uint8_t> sendData {new uint8_t[ChordWire::kEncodedNodeSize], std::default_delete<uint8_t[]>()};
+    ChordWire::encodeNode(node, sendData.get());
+    
+    // same message as getPredecessorFromRemoteNode - but the node isn't the sender
+    try {
+        sendRequest(ChordMessageTypeUpdatePredecessor, sendData, ChordWire::kEncodedNodeSize,
+                    [] (std::exception_ptr, ChordResponse) {});
+    } catch (ChordConnectionException &exception) {
+        CHORD_LOGV("ChordNode::suggestSuccessorAsync(): " << exception.what());
+    }
+}
+
 // search for a key (or a node)
 ChordHeaderNode ChordNode::searchForKey (ChordId key)
 {
-    ChordId searchKey { htons(key) }; // convert key to network byte order
+    ChordId searchKey { htonId(key) }; // convert key to network byte order
     
     std::shared_ptr<uint8_t> searchData { new uint8_t[sizeof(ChordId)], std::default_delete<uint8_t[]>() };
-    memcpy(&searchData, &searchKey, sizeof(ChordId));
+    memcpy(searchData.get(), &searchKey, sizeof(ChordId));
+    
+    // send search and receive result
+    return nodeFromSearchResponse(request(ChordMessageTypeSearch, searchData, sizeof(ChordId)));
+}
+
+// receive data for key - nullptr if data not found
+std::shared_ptr<uint8_t> ChordNode::requestDataForKey (ChordId key)
+{
+    ChordId dataKey { htonId(key) }; // convert key to network byte order
+    
+    std::shared_ptr<uint8_t> requestData { new uint8_t[sizeof(ChordId)], std::default_delete<uint8_t[]>() };
+    memcpy(requestData.get(), &dataKey, sizeof(ChordId));
+    
+    // send request and receive the data
+    return dataFromDataResponse(request(ChordMessageTypeDataRequest, requestData, sizeof(ChordId)));
+}
+
+// sends the data to the remote node to add it there locally
+// returns true on success
+bool ChordNode::addData (ChordId key, std::shared_ptr<uint8_t> data)
+{
+    uint32_t messageSize { 0 };
+    std::shared_ptr<uint8_t> message { keyedData(key, data, &messageSize) };
     
-    // send search
-    _sendSocket_mutex.lock();
+    // send the data and receive answer
     try {
-        sendRequest(ChordMessageTypeSearch, searchData, sizeof(ChordId));
+        return resultFromAddResponse(request(ChordMessageTypeDataAdd, message, messageSize));
+        
     } catch (ChordConnectionException &exception) {
-        Log::sharedLog()->error(std::string("ChordNode::searchForKey():sendRequest(): ") += exception.what());
+        CHORD_LOGE("ChordNode::addData(): " << exception.what());
     }
     
-    // receive result
-    std::shared_ptr<ChordMessageType> responseType;
-    std::shared_ptr<uint8_t> responseData;
-    std::shared_ptr<ssize_t> responseDataSize { 0 };
+    return false;
+}
+
+// asynchronous search for a key (or a node)
+void ChordNode::searchForKeyAsync (ChordId key, ChordLookupHandler handler)
+{
+    searchForKeyAsync(key, 0, 0, [handler] (std::exception_ptr error, ChordHeaderNode node, uint8_t,
+                                            std::vector<ChordTraceHop>) {
+        handler(error, node);
+    });
+}
+
+// traced search (traceId 0: untraced)
+void ChordNode::searchForKeyAsync (ChordId key, uint32_t traceId, uint8_t hops, ChordTracedLookupHandler handler)
+{
+    ChordId searchKey { htonId(key) }; // convert key to network byte order
+    
+    std::shared_ptr<uint8_t> searchData { new uint8_t[sizeof(ChordId)], std::default_delete<uint8_t[]>() };
+    memcpy(searchData.get(), &searchKey, sizeof(ChordId));
     
     try {
-        responseData = recvResponse(responseType, responseDataSize);
+        sendRequest(ChordMessageTypeSearch, searchData, sizeof(ChordId),
+                    [handler, traceId] (std::exception_ptr error, ChordResponse response) {
+                        
+                        ChordHeaderNode node { 0, 0, 0 };
+                        std::vector<ChordTraceHop> path;
+                        uint8_t routeHops { 0 };
+                        if (!error) {
+                            try {
+                                node = nodeFromSearchResponse(response, traceId != 0 ? &path : nullptr, &routeHops);
+                            } catch (ChordConnectionException &exception) {
+                                error = std::current_exception();
+                            }
+                        }
+                        // our request is part of the route
+                        handler(error, node, static_cast<uint8_t>(std::min(routeHops + 1, 255)), path);
+                    }, traceId, hops);
+        
     } catch (ChordConnectionException &exception) {
-        Log::sharedLog()->error(std::string("ChordNode::searchForKey():recvResponse(): ") += exception.what());
-    }
-    _sendSocket_mutex.unlock();
-    
-    switch (*responseType) {
-        case ChordMessageTypeSearchNodeResponse:
-        {
-            // check for available data
-            if (*responseDataSize == sizeof(ChordHeaderNode)) {
-                
-                ChordHeaderNode receivedNode { 0 };
-                if (!responseData) {
-                    Log::sharedLog()->error("responseData == nullptr");
-                } else {
-                    memcpy(&receivedNode, &responseData, sizeof(ChordHeaderNode));
-                }
-                
-                return receivedNode;
-                
-            } else {
-                Log::sharedLog()->error("answer contains unexpected data size");
-                throw ChordConnectionException { "answer contains unexpected data size" };
-            }
-            break;
-        }
-            
-        default:
-        {
-            Log::sharedLog()->error(std::string("received unexpected answer type: ") += std::to_string(*responseType));
-            throw ChordConnectionException { "received unexpected answer: " };
-            break;
-        }
+        handler(std::current_exception(), ChordHeaderNode { 0, 0, 0 }, 0, std::vector<ChordTraceHop>());
     }
 }
 
-// receive data for key - nullptr if data not found
-std::shared_ptr<uint8_t> ChordNode::requestDataForKey (ChordId key)
+// asynchronous receive data for key
+void ChordNode::requestDataForKeyAsync (ChordId key, ChordGetHandler handler)
 {
-    ChordId dataKey { htons(key) }; // convert key to network byte order
+    ChordId dataKey { htonId(key) }; // convert key to network byte order
     
     std::shared_ptr<uint8_t> requestData { new uint8_t[sizeof(ChordId)], std::default_delete<uint8_t[]>() };
-    memcpy(&requestData, &dataKey, sizeof(ChordId));
+    memcpy(requestData.get(), &dataKey, sizeof(ChordId));
     
-    // send search
-    _sendSocket_mutex.lock();
     try {
-        sendRequest(ChordMessageTypeDataRequest, requestData, sizeof(ChordId));
+        sendRequest(ChordMessageTypeDataRequest, requestData, sizeof(ChordId),
+                    [handler] (std::exception_ptr error, ChordResponse response) {
+                        
+                        std::shared_ptr<uint8_t> data { nullptr };
+                        if (!error) {
+                            try {
+                                data = dataFromDataResponse(response);
+                            } catch (ChordConnectionException &exception) {
+                                error = std::current_exception();
+                            }
+                        }
+                        handler(error, data);
+                    });
+        
     } catch (ChordConnectionException &exception) {
-        Log::sharedLog()->error(std::string("ChordNode::requestDataForKey():sendRequest(): ") += exception.what());
+        handler(std::current_exception(), nullptr);
     }
-    
-    // receive the data
-    std::shared_ptr<ChordMessageType> responseType;
-    std::shared_ptr<uint8_t> responseData;
-    std::shared_ptr<ssize_t> responseDataSize { 0 };
+}
+
+// asynchronous add data to the remote node
+void ChordNode::addDataAsync (ChordId key, std::shared_ptr<uint8_t> data, ChordPutHandler handler)
+{
+    sendDataAsync(ChordMessageTypeDataAdd, key, data, handler);
+}
+
+// sends a copy of the data to the remote node (replication)
+void ChordNode::addReplicaAsync (ChordId key, std::shared_ptr<uint8_t> data, ChordPutHandler handler)
+{
+    sendDataAsync(ChordMessageTypeReplicaAdd, key, data, handler);
+}
+
+// sends the data with the given message type (add data or add replica)
+void ChordNode::sendDataAsync (ChordMessageType type, ChordId key, std::shared_ptr<uint8_t> data, ChordPutHandler handler)
+{
+    uint32_t messageSize { 0 };
+    std::shared_ptr<uint8_t> message { keyedData(key, data, &messageSize) };
     
     try {
-        responseData = recvResponse(responseType, responseDataSize);
+        sendRequest(type, message, messageSize,
+                    [handler] (std::exception_ptr error, ChordResponse response) {
+                        
+                        bool added { false };
+                        if (!error) {
+                            try {
+                                added = resultFromAddResponse(response);
+                            } catch (ChordConnectionException &exception) {
+                                error = std::current_exception();
+                            }
+                        }
+                        handler(error, added);
+                    });
+        
     } catch (ChordConnectionException &exception) {
-        Log::sharedLog()->error(std::string("ChordNode::requestDataForKey():recvResponse(): ") += exception.what());
+        handler(std::current_exception(), false);
     }
-    _sendSocket_mutex.unlock();
+}
+
+// transfers all items to the remote node (f.e. key range handoff)
+void ChordNode::transferDataAsync (std::shared_ptr<std::vector<ChordDataItem>> items, ChordPutHandler handler)
+{
+    std::shared_ptr<ChordTransfer> transfer { std::make_shared<ChordTransfer>() };
+    transfer->items = items;
+    transfer->handler = handler;
     
-    switch (*responseType) {
-        case ChordMessageTypeDataAnswer:
-        {
-            // check for available data
-            if (responseDataSize > 0) {
-                
-                if (!responseData) {
-                    Log::sharedLog()->error("ChordNode::requestDataForKey(): responseData == nullptr");
-                } else {
-                    
-                    return responseData;
-                }
-                
-            } else {
-                Log::sharedLog()->error("answer contains no data");
-                throw ChordConnectionException { "answer contains no data" };
-            }
-            break;
+    continueTransfer(transfer);
+}
+
+// transfers copies of all items to the remote node (replication)
+void ChordNode::transferReplicasAsync (std::shared_ptr<std::vector<ChordDataItem>> items, ChordPutHandler handler)
+{
+    std::shared_ptr<ChordTransfer> transfer { std::make_shared<ChordTransfer>() };
+    transfer->type = ChordMessageTypeReplicaTransfer;
+    transfer->items = items;
+    transfer->handler = handler;
+    
+    continueTransfer(transfer);
+}
+
+// sends the next batches of the transfer (as long as the window allows)
+void ChordNode::continueTransfer (std::shared_ptr<ChordTransfer> transfer)
+{
+    std::shared_ptr<ChordNode> node { shared_from_this() };
+    
+    while (true) {
+        
+        transfer->mutex.lock();
+        
+        // all batches are acknowledged (or the transfer failed)
+        bool sendNothing { transfer->error || transfer->nextItem >= transfer->items->size() };
+        if (sendNothing && transfer->pendingBatches == 0 && !transfer->finished) {
+            transfer->finished = true;
+            transfer->mutex.unlock();
+            
+            transfer->handler(transfer->error, transfer->added);
+            return;
+        }
+        
+        if (sendNothing || transfer->pendingBatches >= kTransferWindow) {
+            transfer->mutex.unlock();
+            return;
         }
+        
+        // collect the items of the next batch (at least one item)
+        size_t firstItem { transfer->nextItem };
+        uint32_t batchSize { sizeof(uint32_t) };
+        
+        while (transfer->nextItem < transfer->items->size()) {
             
-        case ChordMessageTypeDataNotFound:
-        {
-            Log::sharedLog()->error("ChordNode::requestDataForKey(): received data not found from remote node");
-            break;
+            uint32_t dataSize { 0 };
+            memcpy(&dataSize, (*transfer->items)[transfer->nextItem].second.get(), sizeof(dataSize));
+            dataSize = ntohl(dataSize);
+            
+            if (transfer->nextItem > firstItem && batchSize + sizeof(ChordId) + dataSize > kTransferBatchSize) {
+                break;
+            }
+            
+            batchSize += sizeof(ChordId) + dataSize;
+            transfer->nextItem++;
         }
+        size_t lastItem { transfer->nextItem };
+        transfer->pendingBatches++;
+        
+        transfer->mutex.unlock();
+        
+        std::shared_ptr<uint8_t> batch { batchFromItems(*transfer->items, firstItem, lastItem, &batchSize) };
+        
+        try {
+            sendRequest(transfer->type, batch, batchSize,
+                        [node, transfer] (std::exception_ptr error, ChordResponse response) {
+                            
+                            bool added { false };
+                            if (!error) {
+                                try {
+                                    added = resultFromAddResponse(response);
+                                } catch (ChordConnectionException &exception) {
+                                    error = std::current_exception();
+                                }
+                            }
+                            
+                            transfer->mutex.lock();
+                            transfer->pendingBatches--;
+                            transfer->added = transfer->added && added;
+                            if (error && !transfer->error) {
+                                transfer->error = error;
+                            }
+                            transfer->mutex.unlock();
+                            
+                            // the window has room for the next batch
+                            node->continueTransfer(transfer);
+                        });
             
-        default:
-        {
-            Log::sharedLog()->error(std::string("received unexpected answer type: ") += std::to_string(*responseType));
-            throw ChordConnectionException { "received unexpected answer: " };
-            break;
+        } catch (ChordConnectionException &exception) {
+            transfer->mutex.lock();
+            transfer->pendingBatches--;
+            transfer->added = false;
+            if (!transfer->error) {
+                transfer->error = std::current_exception();
+            }
+            transfer->mutex.unlock();
         }
     }
-    
-    return nullptr;
 }
 
-// sends the data to the remote node to add it there locally
-// returns true on success
-bool ChordNode::addData (std::shared_ptr<uint8_t> data)
+// receives the data of all keys with one request
+void ChordNode::requestDataForKeysAsync (std::vector<ChordId> keys, ChordMultiGetHandler handler)
 {
-    // protect the send socket
-    _sendSocket_mutex.lock();
+    // key count followed by the keys
+    uint32_t requestSize { static_cast<uint32_t>(sizeof(uint32_t) + keys.size() * sizeof(ChordId)) };
+    std::shared_ptr<uint8_t> requestData { new uint8_t[requestSize], std::default_delete<uint8_t[]>() };
+    uint8_t *pos = requestData.get();
     
-    // get data size from binary
-    uint8_t dataSizeNBO[4] { 0 };
-    memcpy(&dataSizeNBO, &data, 4 * sizeof(uint8_t));
-    uint32_t dataSize { ntohl(static_cast<uint32_t>(*dataSizeNBO)) };
+    uint32_t keyCount { htonl(static_cast<uint32_t>(keys.size())) };
+    memcpy(pos, &keyCount, sizeof(keyCount));
+    pos += sizeof(keyCount);
+    
+    for (ChordId key : keys) {
+        ChordId dataKey { htonId(key) }; // convert key to network byte order
+        memcpy(pos, &dataKey, sizeof(ChordId));
+        pos += sizeof(ChordId);
+    }
     
-    // send the data
     try {
-        sendRequest(ChordMessageTypeDataAdd, data, dataSize);
+        sendRequest(ChordMessageTypeDataMultiRequest, requestData, requestSize,
+                    [handler] (std::exception_ptr error, ChordResponse response) {
+                        
+                        std::map<ChordId, std::shared_ptr<uint8_t>> data;
+                        std::vector<ChordDataItem> items;
+                        if (!error) {
+                            try {
+                                itemsFromMultiResponse(response, &items);
+                            } catch (ChordConnectionException &exception) {
+                                error = std::current_exception();
+                            }
+                        }
+                        
+                        for (auto item : items) {
+                            data[item.first] = item.second;
+                        }
+                        handler(error, data);
+                    });
+        
     } catch (ChordConnectionException &exception) {
-        Log::sharedLog()->error(std::string("ChordNode::addData():sendRequest(): ") += exception.what());
+        handler(std::current_exception(), std::map<ChordId, std::shared_ptr<uint8_t>>());
+    }
+}
+
+// a batch contains the item count followed by key + data of every item
+std::shared_ptr<uint8_t> ChordNode::batchFromItems (const std::vector<ChordDataItem> &items,
+                                                    size_t first, size_t last, uint32_t *size)
+{
+    *size = sizeof(uint32_t);
+    for (size_t i = first; i < last; i++) {
+        uint32_t dataSize { 0 };
+        memcpy(&dataSize, items[i].second.get(), sizeof(dataSize));
+        *size += sizeof(ChordId) + ntohl(dataSize);
+    }
+    
+    std::shared_ptr<uint8_t> batch { new uint8_t[*size], std::default_delete<uint8_t[]>() };
+    uint8_t *pos = batch.get();
+    
+    uint32_t itemCount { htonl(static_cast<uint32_t>(last - first)) };
+    memcpy(pos, &itemCount, sizeof(itemCount));
+    pos += sizeof(itemCount);
+    
+    for (size_t i = first; i < last; i++) {
+        
+        uint32_t dataSize { 0 };
+        memcpy(&dataSize, items[i].second.get(), sizeof(dataSize));
+        dataSize = ntohl(dataSize);
+        
+        ChordId key { htonId(items[i].first) };
+        memcpy(pos, &key, sizeof(ChordId));
+        pos += sizeof(ChordId);
+        memcpy(pos, items[i].second.get(), dataSize);
+        pos += dataSize;
+    }
+    
+    return batch;
+}
+
+// the items share the buffer of the batch
+bool ChordNode::itemsFromBatch (std::shared_ptr<uint8_t> batch, uint32_t size,
+                                std::vector<ChordDataItem> *items)
+{
+    if (!batch || size < sizeof(uint32_t)) {
+        return false;
+    }
+    
+    uint32_t itemCount { 0 };
+    memcpy(&itemCount, batch.get(), sizeof(itemCount));
+    itemCount = ntohl(itemCount);
+    
+    uint32_t offset { sizeof(itemCount) };
+    
+    for (uint32_t i = 0; i < itemCount; i++) {
+        
+        ChordId key { 0 };
+        std::shared_ptr<uint8_t> itemData { nullptr };
+        
+        std::shared_ptr<uint8_t> item { batch, batch.get() + offset };
+        if (!keyAndDataFromKeyedData(item, size - offset, &key, &itemData)) {
+            return false;
+        }
+        
+        uint32_t dataSize { 0 };
+        memcpy(&dataSize, itemData.get(), sizeof(dataSize));
+        offset += sizeof(ChordId) + ntohl(dataSize);
+        
+        items->push_back(ChordDataItem(key, itemData));
+    }
+    
+    return true;
+}
+
+// the data of add messages is preceded by its key
+std::shared_ptr<uint8_t> ChordNode::keyedData (ChordId key, std::shared_ptr<uint8_t> data, uint32_t *size)
+{
+    // get data size from binary
+    uint32_t dataSize { 0 };
+    memcpy(&dataSize, data.get(), sizeof(dataSize));
+    dataSize = ntohl(dataSize);
+    
+    ChordId dataKey { htonId(key) }; // convert key to network byte order
+    
+    *size = sizeof(ChordId) + dataSize;
+    std::shared_ptr<uint8_t> message { new uint8_t[*size], std::default_delete<uint8_t[]>() };
+    memcpy(message.get(), &dataKey, sizeof(ChordId));
+    memcpy(message.get() + sizeof(ChordId), data.get(), dataSize);
+    
+    return message;
+}
+
+// splits the data of add messages into key and data
+bool ChordNode::keyAndDataFromKeyedData (std::shared_ptr<uint8_t> keyedData, uint32_t size,
+                                         ChordId *key, std::shared_ptr<uint8_t> *data)
+{
+    if (!keyedData || size < sizeof(ChordId) + sizeof(uint32_t)) {
+        return false;
+    }
+    
+    memcpy(key, keyedData.get(), sizeof(ChordId));
+    *key = ntohId(*key);
+    
+    // the data has to fit into the message
+    uint32_t dataSize { 0 };
+    memcpy(&dataSize, keyedData.get() + sizeof(ChordId), sizeof(dataSize));
+    if (ntohl(dataSize) > size - sizeof(ChordId)) {
+        return false;
     }
     
-    std::shared_ptr<ChordMessageType> responseType;
-    std::shared_ptr<uint8_t> responseData;
-    std::shared_ptr<ssize_t> responseDataSize { 0 };
+    // shares the buffer of the message - no copy
+    *data = std::shared_ptr<uint8_t>(keyedData, keyedData.get() + sizeof(ChordId));
+    
+    return true;
+}
+
+// one step of an iterative search
+void ChordNode::searchNextHopsAsync (ChordId key, uint8_t count, ChordNextHopsHandler handler)
+{
+    ChordId searchKey { htonId(key) }; // convert key to network byte order
+    
+    // key followed by the number of wanted nodes
+    std::shared_ptr<uint8_t> searchData { new uint8_t[sizeof(ChordId) + 1], std::default_delete<uint8_t[]>() };
+    memcpy(searchData.get(), &searchKey, sizeof(ChordId));
+    searchData.get()[sizeof(ChordId)] = count;
     
-    // receive answer
     try {
-        responseData = recvResponse(responseType, responseDataSize);
+        sendRequest(ChordMessageTypeSearchNextHops, searchData, sizeof(ChordId) + 1,
+                    [handler] (std::exception_ptr error, ChordResponse response) {
+                        
+                        std::vector<ChordHeaderNode> nodes;
+                        bool done { false };
+                        if (!error) {
+                            try {
+                                done = nextHopsFromResponse(response, &nodes);
+                            } catch (ChordConnectionException &exception) {
+                                error = std::current_exception();
+                            }
+                        }
+                        handler(error, done, nodes);
+                    });
+        
     } catch (ChordConnectionException &exception) {
-        Log::sharedLog()->error(std::string("ChordNode::addData():recvResponse(): ") += exception.what());
+        handler(std::current_exception(), false, std::vector<ChordHeaderNode>());
     }
+}
+
+// fails all requests that wait longer than kRequestTimeoutSeconds
+void ChordNode::failExpiredRequests ()
+{
+    std::list<ChordResponseHandler> expiredRequests;
+    std::chrono::steady_clock::time_point now { std::chrono::steady_clock::now() };
     
-    // we are done with the send socket
-    _sendSocket_mutex.unlock();
-    
-    if (*responseType == ChordMessageTypeDataAddSuccess) {
-        return true;
+    _pendingRequests_mutex.lock();
+    for (auto iterator = _pendingRequests.begin(); iterator != _pendingRequests.end();) {
+        if (iterator->second.deadline < now) {
+            expiredRequests.push_back(iterator->second.handler);
+            iterator = _pendingRequests.erase(iterator);
+        } else {
+            ++iterator;
+        }
     }
+    _pendingRequests_mutex.unlock();
     
-    return false;
+    for (ChordResponseHandler handler : expiredRequests) {
+        handler(std::make_exception_ptr(ChordConnectionException { "timeout waiting for response" }), ChordResponse());
+    }
 }
 
 // returns a describing string of the node
@@ -437,426 +749,820 @@ std::string ChordNode::description () const
 
 #pragma mark - Private
 
-void ChordNode::setReceiveSocket (int socket)
+void ChordNode::setReceiveConnection (std::shared_ptr<ChordConnection> connection)
 {
-    if (_receiveSocket != -1) {
-        Log::sharedLog()->error(std::string("warning receivesocket for node: ")
-                                += std::to_string(_nodeID)
-                                += " was already set");
-    }
+    _receiveConnection_mutex.lock();
+    bool replaced { _receiveConnection != nullptr };
+    _receiveConnection_mutex.unlock();
     
-    // stop request handler if already started
-    _stopRequestHandlerThread = true;
-    try {
-        // wait till request handler finished
-        _requestHandlerThread.join();
-        
-        // called if requestHandlerThread is not running (or not joinable)
-    } catch (...) {}
+    if (replaced) {
+        CHORD_LOGW("warning receive connection for node: " << _nodeID << " was already set");
+    }
     
-    _stopRequestHandlerThread = false;
-    _receiveSocket = socket;
+    // stop handling requests of the old connection
+    closeReceiveConnection();
     
-    // start request handler
-    if (!_requestHandlerThread.joinable()) { // only if it's not already running
-        _requestHandlerThread = std::thread(&ChordNode::handleRequests, this);
+    // create strong pointer to chord
+    std::shared_ptr<Chord> chord { _chord.lock() };
+    if (!chord) {
+        CHORD_LOGE("Lost chord pointer!");
+        connection->close();
+        return;
     }
+    
+    _receiveConnection_mutex.lock();
+    _receiveConnection = connection;
+    _receiveConnection_mutex.unlock();
+    
+    // the connection must not keep us (or itself) alive
+    std::weak_ptr<ChordNode> weakNode { shared_from_this() };
+    std::weak_ptr<Chord> weakChord { chord };
+    std::weak_ptr<ChordConnection> weakConnection { connection };
+    
+    // start handling requests
+    // the requests are handled by other workers, so several requests
+    // of this node can be handled at the same time
+    connection->receive([weakNode, weakChord, weakConnection] (ChordHeader requestHeader, std::shared_ptr<uint8_t> data) {
+        std::shared_ptr<ChordNode> node { weakNode.lock() };
+        std::shared_ptr<Chord> chord { weakChord.lock() };
+        std::shared_ptr<ChordConnection> connection { weakConnection.lock() };
+        if (node && chord && connection) {
+            node->messageReceived(chord, requestHeader.type, ntohl(requestHeader.dataSize));
+            chord->transport()->dispatch(std::bind(&ChordNode::handleMessage, node, connection, requestHeader, data,
+                                                   std::chrono::steady_clock::now()));
+        }
+    }, [weakNode, weakConnection] () {
+        std::shared_ptr<ChordNode> node { weakNode.lock() };
+        std::shared_ptr<ChordConnection> connection { weakConnection.lock() };
+        if (node && connection) {
+            CHORD_LOGV("Node with id: " << node->getNodeID() << " closed the connection");
+            node->receiveConnectionClosed(connection);
+        }
+    });
 }
 
-void ChordNode::handleRequests ()
+// stops handling requests and closes the receive connection
+void ChordNode::closeReceiveConnection ()
 {
-    RGPLOGV("ChordNode handleRequest");
-    
-    // receive request
-    ChordHeader requestHeader { {0, 0, 0}, ChordMessageTypeIdentify, 0 };
+    _receiveConnection_mutex.lock();
+    std::shared_ptr<ChordConnection> connection { _receiveConnection };
+    _receiveConnection.reset();
+    _receiveConnection_mutex.unlock();
     
-    std::shared_ptr<uint8_t> data { nullptr };
-    ssize_t readBytes { 0 };
+    if (connection) {
+        connection->close();
+    }
+}
+
+// the send connection was closed by the remote node
+void ChordNode::sendConnectionClosed (std::shared_ptr<ChordConnection> connection)
+{
+    _sendConnection_mutex.lock();
+    bool current { _sendConnection == connection };
+    _sendConnection_mutex.unlock();
     
-    while (!_stopRequestHandlerThread) {
+    // a newer connection already replaced it
+    if (current) {
+        closeSendConnection();
         
-        data.reset();
-        
-        // create strong pointer to chord
-        std::shared_ptr<Chord> chord { _chord };
-        if (!chord) {
-            RGPLOG_ERROR("Lost chord pointer!");
+        // the node may have left the ring
+        std::shared_ptr<Chord> chord { _chord.lock() };
+        if (chord) {
+            chord->membershipChanged();
         }
-        
-        // wait for incomming data
-        if ((readBytes = recv(_receiveSocket, &requestHeader, sizeof(ChordHeader), 0)) <= 0) {
-            if (readBytes == 0) {
-                RGPLOGV("Remote Node closed connection");
-                break;
-            }
-            Log::sharedLog()->errorWithErrno("ChordNode::handleRequests():recv1: ", errno);
-            break;
+    }
+}
+
+// the receive connection was closed by the remote node
+void ChordNode::receiveConnectionClosed (std::shared_ptr<ChordConnection> connection)
+{
+    _receiveConnection_mutex.lock();
+    bool current { _receiveConnection == connection };
+    _receiveConnection_mutex.unlock();
+    
+    // a newer connection already replaced it
+    if (current) {
+        closeReceiveConnection();
+    }
+}
+
+// creates the responsible node from a search response
+ChordHeaderNode ChordNode::nodeFromSearchResponse (ChordResponse response, std::vector<ChordTraceHop> *path, uint8_t *hops)
+{
+    if (response.type != ChordMessageTypeSearchNodeResponse) {
+        CHORD_LOGE("received unexpected answer type: " << static_cast<int>(response.type));
+        throw ChordConnectionException { "received unexpected answer: " };
+    }
+    
+    // check for available data (the path of a traced search or the number of hops follows the node)
+    if (response.dataSize < ChordWire::kEncodedNodeSize || !response.data ||
+        (!path && response.dataSize != ChordWire::kEncodedNodeSize && response.dataSize != ChordWire::kEncodedNodeSize + 1)) {
+        CHORD_LOGE("answer contains unexpected data size");
+        throw ChordConnectionException { "answer contains unexpected data size" };
+    }
+    
+    if (path && !ChordTracer::decodePath(response.data.get() + ChordWire::kEncodedNodeSize,
+                                         response.dataSize - ChordWire::kEncodedNodeSize, path)) {
+        CHORD_LOGE("answer contains malformed trace");
+        throw ChordConnectionException { "answer contains malformed trace" };
+    }
+    
+    // the remote node heads the path of a traced search
+    // (older nodes don't send the hops of an untraced search)
+    if (hops && path) {
+        *hops = static_cast<uint8_t>(std::min<size_t>(path->empty() ? 0 : path->size() - 1, 255));
+    } else if (hops) {
+        *hops = response.dataSize > ChordWire::kEncodedNodeSize ? response.data.get()[ChordWire::kEncodedNodeSize] : 0;
+    }
+    
+    return ChordWire::decodeNode(response.data.get());
+}
+
+// returns the received data or nullptr if the data wasn't found
+std::shared_ptr<uint8_t> ChordNode::dataFromDataResponse (ChordResponse response)
+{
+    switch (response.type) {
+        case ChordMessageTypeDataAnswer:
+        {
+            // check for available data
+            if (response.dataSize > 0 && response.data) {
+                return response.data;
+            }
+            
+            CHORD_LOGE("answer contains no data");
+            throw ChordConnectionException { "answer contains no data" };
         }
-        
-        // error check
-        if (readBytes != sizeof(ChordHeader)) {
-            Log::sharedLog()->error("don't received enough data ... something bad happened");
-            continue;
+            
+        case ChordMessageTypeDataNotFound:
+        {
+            CHORD_LOGV("ChordNode::dataFromDataResponse(): received data not found from remote node");
+            return nullptr;
         }
-        
-        // check for available data
-        if (ntohl(requestHeader.dataSize) > 0) {
             
-            // alloc space for the data
-            uint32_t dataSize = ntohl(requestHeader.dataSize);
-            data = std::shared_ptr<uint8_t>(new uint8_t[dataSize], std::default_delete<uint8_t[]>());
+        default:
+        {
+            CHORD_LOGE("received unexpected answer type: " << static_cast<int>(response.type));
+            throw ChordConnectionException { "received unexpected answer: " };
+        }
+    }
+}
+
+// returns true if the remote node added the data
+bool ChordNode::resultFromAddResponse (ChordResponse response)
+{
+    switch (response.type) {
+        case ChordMessageTypeDataAddSuccess:
+            return true;
             
-            // receive the data
-            readBytes = recv(_receiveSocket, data.get(), ntohl(requestHeader.dataSize), 0);
+        case ChordMessageTypeDataAddFailed:
+            return false;
             
-            if (readBytes == 0) {
-                RGPLOGV("Remote Node closed connection");
-                break;
-            }
+        default:
+        {
+            CHORD_LOGE("received unexpected answer type: " << static_cast<int>(response.type));
+            throw ChordConnectionException { "received unexpected answer: " };
+        }
+    }
+}
+
+// creates the found items from a data multi answer
+bool ChordNode::itemsFromMultiResponse (ChordResponse response, std::vector<ChordDataItem> *items)
+{
+    if (response.type != ChordMessageTypeDataMultiAnswer) {
+        CHORD_LOGE("received unexpected answer type: " << static_cast<int>(response.type));
+        throw ChordConnectionException { "received unexpected answer: " };
+    }
+    
+    if (!itemsFromBatch(response.data, response.dataSize, items)) {
+        CHORD_LOGE("received malformed data multi answer");
+        throw ChordConnectionException { "received malformed data multi answer" };
+    }
+    
+    return true;
+}
+
+// returns true if the response contains the responsible node
+// or false if it contains nodes closer to the key
+bool ChordNode::nextHopsFromResponse (ChordResponse response, std::vector<ChordHeaderNode> *nodes)
+{
+    // the remote node knows the responsible node
+    if (response.type == ChordMessageTypeSearchNodeResponse) {
+        nodes->push_back(nodeFromSearchResponse(response));
+        return true;
+    }
+    
+    if (response.type != ChordMessageTypeSearchNextHopsResponse) {
+        CHORD_LOGE("received unexpected answer type: " << static_cast<int>(response.type));
+        throw ChordConnectionException { "received unexpected answer: " };
+    }
+    
+    if (response.dataSize % ChordWire::kEncodedNodeSize != 0 || (response.dataSize > 0 && !response.data)) {
+        CHORD_LOGE("answer contains unexpected data size");
+        throw ChordConnectionException { "answer contains unexpected data size" };
+    }
+    
+    for (uint32_t offset = 0; offset < response.dataSize; offset += ChordWire::kEncodedNodeSize) {
+        nodes->push_back(ChordWire::decodeNode(response.data.get() + offset));
+    }
+    
+    return false;
+}
+
+// executes the handler of the request message (heartbeat, search, ...)
+void ChordNode::handleMessage (std::shared_ptr<ChordConnection> connection, ChordHeader requestHeader,
+                               std::shared_ptr<uint8_t> data, std::chrono::steady_clock::time_point receivedAt)
+{
+    // create strong pointer to chord
+    std::shared_ptr<Chord> chord { _chord.lock() };
+    if (!chord) {
+        CHORD_LOGE("Lost chord pointer!");
+        return;
+    }
+    
+    // responses are send with the id of the request
+    uint32_t requestId { ntohl(requestHeader.requestId) };
+    
+    // check message type and react appropriate
+    switch (requestHeader.type)
+    {
             
-            // error check
-            if (readBytes < 0) {
-                Log::sharedLog()->errorWithErrno("ChordNode::handleRequests():recv2: ", errno);
-                continue;
+        case ChordMessageTypeHeartbeat:
+        {
+            CHORD_LOGV("received Heartbeat message from: " << _nodeID);
+            // answer with heartbeat reply
+            try {
+                sendResponse(connection, requestId, ChordMessageTypeHeartbeatReply, nullptr, 0);
+            } catch (ChordConnectionException &exception) {
+                CHORD_LOGE("Error sending response: " << exception.what());
             }
             
-            if (readBytes != static_cast<ssize_t>(ntohl(requestHeader.dataSize))) {
-                Log::sharedLog()->error((std::string("data size: ")
-                                         += std::to_string(ntohl(requestHeader.dataSize))
-                                         += " readBytes: ")
-                                        += std::to_string(readBytes));
-                Log::sharedLog()->error("recv(): don't received the expected data size");
-                break;
-            }
+            break;
         }
-        
-        // check message type and react appropriate
-        switch (requestHeader.type)
+            
+        case ChordMessageTypeSearch:
         {
-                
-            case ChordMessageTypeHeartbeat:
-            {
-                RGPLOGV(std::string("received Heartbeat message from: ") += std::to_string(_nodeID));
-                // answer with heartbeat reply
-                sendResponse(ChordMessageTypeHeartbeatReply, nullptr, 0);
-                
+            CHORD_LOGV("received Search message");
+            
+            // error check
+            // (a peer with another id width would make us read beyond the data)
+            if (!data || ntohl(requestHeader.dataSize) != sizeof(ChordId)) {
+                CHORD_LOGE("received search without valid key ...");
+                sendEmptyResponse(connection, requestId, ChordMessageTypeSearchNodeResponse);
                 break;
             }
+            
+            ChordId key { 0 };
+            memcpy(&key, data.get(), sizeof(ChordId));
+            key = ntohId(key);
+            
+            // a traced search is followed by its trace id and the number of passed nodes
+            uint32_t traceId { (requestHeader.flags & ChordMessageFlagTraced) ? ntohl(requestHeader.traceId) : 0 };
+            uint8_t hops { requestHeader.hops };
+            
+            // search the key (checks local / sends search)
+            // the worker doesn't wait for a forwarded search
+            std::shared_ptr<ChordNode> node { shared_from_this() };
+            ChordHeaderNode ownNode { chord->ownNode()->chordNode() };
+            
+            chord->searchForKeyAsync(_nodeID, key, traceId, hops, [node, connection, ownNode, requestId, receivedAt, traceId, hops]
+                                     (std::exception_ptr error, ChordHeaderNode responsibleNode, uint8_t routeHops,
+                                      std::vector<ChordTraceHop> path) {
                 
-            case ChordMessageTypeSearch:
-            {
-                RGPLOGV("received Search message");
-                
-                // error check
-                if (!data) {
-                    Log::sharedLog()->error("received search without data ...");
-                    break;
+                // if we can't find a responsible node return self
+                if (error) {
+                    responsibleNode = ownNode;
                 }
                 
-                ChordId key = ntohl(*data);
-                
-                // search the key (checks local / sends search)
-                ChordHeaderNode node = chord->searchForKey(_nodeID, key);
+                // we are the node before the nodes of the path
+                if (traceId != 0) {
+                    path.insert(path.begin(), ChordTracer::hopForNode(ntohId(ownNode.nodeId), hops, receivedAt));
+                }
                 
                 // create understandable response format
-                std::shared_ptr<uint8_t> nodeData(new uint8_t[sizeof(ChordHeaderNode)], std::default_delete<uint8_t[]>());
-                memcpy(nodeData.get(), &node, sizeof(ChordHeaderNode));
+                // (followed by the path - or by the requests we sent for an untraced search)
+                ssize_t nodeDataSize = ChordWire::kEncodedNodeSize + (traceId != 0 ? path.size() * ChordTracer::kEncodedHopSize : 1);
+                std::shared_ptr<uint8_t> nodeData(new uint8_t[nodeDataSize], std::default_delete<uint8_t[]>());
+                ChordWire::encodeNode(responsibleNode, nodeData.get());
+                if (traceId != 0) {
+                    ChordTracer::encodePath(path, nodeData.get() + ChordWire::kEncodedNodeSize);
+                } else {
+                    nodeData.get()[ChordWire::kEncodedNodeSize] = error ? 0 : routeHops;
+                }
                 
                 // send response
                 try {
                     
-                    sendResponse(ChordMessageTypeSearchNodeResponse, nodeData, sizeof(ChordHeaderNode));
+                    node->sendResponse(connection, requestId, ChordMessageTypeSearchNodeResponse, nodeData, nodeDataSize,
+                                       traceId, hops);
                     
                 } catch (ChordConnectionException &exception) {
-                    Log::sharedLog()->error(std::string("Error sending response: ") += exception.what());
+                    CHORD_LOGE("Error sending response: " << exception.what());
                 }
                 
+                node->requestHandled(ChordMessageTypeSearch, receivedAt);
+            });
+            
+            break;
+        }
+            
+        case ChordMessageTypeSearchNextHops:
+        {
+            CHORD_LOGV("received Search Next Hops message");
+            
+            // error check
+            if (!data || ntohl(requestHeader.dataSize) != sizeof(ChordId) + 1) {
+                CHORD_LOGE("received search next hops with unexpected data size ...");
+                sendEmptyResponse(connection, requestId, ChordMessageTypeSearchNextHopsResponse);
                 break;
             }
-                
-            case ChordMessageTypeUpdatePredecessor:
-            {
-                RGPLOGV(std::string("received Update Predecessor message from: ") += std::to_string(_nodeID));
-                
-                // Error checking
-                if (!data) {
-                    Log::sharedLog()->error("received update predecessor without data ...");
-                    break;
-                }
-                
-                if (ntohl(requestHeader.dataSize) != sizeof(ChordHeaderNode)) {
-                    Log::sharedLog()->error("received update predecessor with unexpected data size ...");
-                    break;
-                }
-                
-                
-                
+            
+            ChordId key { 0 };
+            memcpy(&key, data.get(), sizeof(ChordId));
+            key = ntohId(key);
+            uint8_t count { data.get()[sizeof(ChordId)] };
+            
+            // only checks local state - never forwards the search
+            std::vector<ChordHeaderNode> nodes;
+            bool done = chord->nextHopsForKey(key, count, &nodes);
+            
+            // create understandable response format
+            std::shared_ptr<uint8_t> nodeData(new uint8_t[nodes.size() * ChordWire::kEncodedNodeSize], std::default_delete<uint8_t[]>());
+            for (size_t k = 0; k < nodes.size(); k++) {
+                ChordWire::encodeNode(nodes[k], nodeData.get() + k * ChordWire::kEncodedNodeSize);
+            }
+            
+            // send response
+            try {
+                sendResponse(connection, requestId, done ? ChordMessageTypeSearchNodeResponse : ChordMessageTypeSearchNextHopsResponse,
+                             nodeData, nodes.size() * ChordWire::kEncodedNodeSize);
+            } catch (ChordConnectionException &exception) {
+                CHORD_LOGE("Error sending response: " << exception.what());
+            }
+            
+            break;
+        }
+            
+        case ChordMessageTypeUpdatePredecessor:
+        {
+            CHORD_LOGV("received Update Predecessor message from: " << _nodeID);
+            
+            // Error checking
+            if (!data || ntohl(requestHeader.dataSize) != ChordWire::kEncodedNodeSize) {
+                CHORD_LOGE("received update predecessor with unexpected data size ...");
+                sendEmptyResponse(connection, requestId, ChordMessageTypePredecessor);
+                break;
+            }
+            
+            ChordHeaderNode node { ChordWire::decodeNode(data.get()) };
+            
+            ChordHeaderNode newPredecessor { chord->ownNode()->chordNode() };
+            if (node.nodeId == requestHeader.node.nodeId) {
                 // apply new predecessor
-                ChordHeaderNode node;
-                memcpy(&node, data.get(), sizeof(ChordHeaderNode));
-                ChordHeaderNode newPredecessor = chord->updatePredecessor(node);
-                
-                // create understandable response format
-                std::shared_ptr<uint8_t> nodeData(new uint8_t[sizeof(ChordHeaderNode)], std::default_delete<uint8_t[]>());
-                memcpy(nodeData.get(), &newPredecessor, sizeof(ChordHeaderNode));
+                newPredecessor = chord->updatePredecessor(node);
+            } else {
+                // our successor suggests a node that joined between us (the answer is ignored)
+                chord->successorSuggested(node);
+            }
+            
+            // the successor list is send along (the remote node needs it if we fail)
+            std::vector<ChordHeaderNode> successors { chord->successorList() };
+            ssize_t nodeDataSize = (1 + successors.size()) * ChordWire::kEncodedNodeSize;
+            
+            // create understandable response format
+            std::shared_ptr<uint8_t> nodeData(new uint8_t[nodeDataSize], std::default_delete<uint8_t[]>());
+            ChordWire::encodeNode(newPredecessor, nodeData.get());
+            for (size_t k = 0; k < successors.size(); k++) {
+                ChordWire::encodeNode(successors[k], nodeData.get() + (k + 1) * ChordWire::kEncodedNodeSize);
+            }
+            
+            // send answer
+            try {
+                sendResponse(connection, requestId, ChordMessageTypePredecessor, nodeData, nodeDataSize);
+            } catch (ChordConnectionException &exception) {
+                CHORD_LOGE("Error sending response: " << exception.what());
+            }
+            
+            break;
+        }
+            
+        case ChordMessageTypeDataAdd:
+        {
+            // someone wants to add data to us
+            CHORD_LOGV("received add data message");
+            
+            ChordId key { 0 };
+            std::shared_ptr<uint8_t> addedData { nullptr };
+            
+            // Error checking
+            if (!keyAndDataFromKeyedData(data, ntohl(requestHeader.dataSize), &key, &addedData)) {
+                CHORD_LOGE("received add data without data ...");
                 
                 // send answer
                 try {
-                    sendResponse(ChordMessageTypePredecessor, nodeData, sizeof(ChordHeaderNode));
+                    sendResponse(connection, requestId, ChordMessageTypeDataAddFailed, nullptr, 0);
                 } catch (ChordConnectionException &exception) {
-                    Log::sharedLog()->error(std::string("Error sending response: ") += exception.what());
+                    CHORD_LOGE("Error sending response: " << exception.what());
                 }
                 
                 break;
             }
+            
+            bool added = chord->addDataToHashMap(key, addedData);
+            
+            try {
+                if (added) {
+                    // send success answer
+                    sendResponse(connection, requestId, ChordMessageTypeDataAddSuccess, nullptr, 0);
+                } else {
+                    // send failed answer
+                    sendResponse(connection, requestId, ChordMessageTypeDataAddFailed, nullptr, 0);
+                }
                 
-            case ChordMessageTypeDataAdd:
-            {
-                // someone wants to add data to us
-                RGPLOGV("received add data message");
-                
-                // Error checking
-                if (!data) {
-                    Log::sharedLog()->error("received add data without data ...");
-                    
-                    // send answer
-                    try {
-                        sendResponse(ChordMessageTypeDataAddFailed, nullptr, 0);
-                    } catch (ChordConnectionException &exception) {
-                        Log::sharedLog()->error(std::string("Error sending response: ") += exception.what());
-                    }
-                    
-                    break;
+            } catch (ChordConnectionException &exception) {
+                CHORD_LOGE("Error sending response: " << exception.what());
+            }
+            
+            break;
+        }
+            
+        case ChordMessageTypeReplicaAdd:
+        {
+            // our predecessor wants us to keep a copy
+            CHORD_LOGV("received add replica message");
+            
+            ChordId key { 0 };
+            std::shared_ptr<uint8_t> addedData { nullptr };
+            
+            bool added = keyAndDataFromKeyedData(data, ntohl(requestHeader.dataSize), &key, &addedData);
+            if (added) {
+                chord->addReplicaToHashMap(key, addedData);
+            } else {
+                CHORD_LOGE("received add replica without data ...");
+            }
+            
+            try {
+                sendResponse(connection, requestId, added ? ChordMessageTypeDataAddSuccess : ChordMessageTypeDataAddFailed, nullptr, 0);
+            } catch (ChordConnectionException &exception) {
+                CHORD_LOGE("Error sending response: " << exception.what());
+            }
+            
+            break;
+        }
+            
+        case ChordMessageTypeDataTransfer:
+        {
+            // our successor hands over the keys we are responsible for now
+            CHORD_LOGV("received data transfer message");
+            
+            std::vector<ChordDataItem> items;
+            bool added { itemsFromBatch(data, ntohl(requestHeader.dataSize), &items) };
+            
+            if (added) {
+                // the items are replicated as one batch too
+                added = chord->addDataItemsToHashMap(items);
+            } else {
+                CHORD_LOGE("received malformed data transfer ...");
+            }
+            
+            // one ack for the whole batch
+            try {
+                sendResponse(connection, requestId, added ? ChordMessageTypeDataAddSuccess : ChordMessageTypeDataAddFailed, nullptr, 0);
+            } catch (ChordConnectionException &exception) {
+                CHORD_LOGE("Error sending response: " << exception.what());
+            }
+            
+            break;
+        }
+            
+        case ChordMessageTypeReplicaTransfer:
+        {
+            // our predecessor wants us to keep copies of a batch
+            CHORD_LOGV("received replica transfer message");
+            
+            std::vector<ChordDataItem> items;
+            bool added { itemsFromBatch(data, ntohl(requestHeader.dataSize), &items) };
+            
+            if (added) {
+                for (auto item : items) {
+                    chord->addReplicaToHashMap(item.first, item.second);
                 }
+            } else {
+                CHORD_LOGE("received malformed replica transfer ...");
+            }
+            
+            try {
+                sendResponse(connection, requestId, added ? ChordMessageTypeDataAddSuccess : ChordMessageTypeDataAddFailed, nullptr, 0);
+            } catch (ChordConnectionException &exception) {
+                CHORD_LOGE("Error sending response: " << exception.what());
+            }
+            
+            break;
+        }
+            
+        case ChordMessageTypeDataRequest:
+        {
+            CHORD_LOGV("received data request message");
+            
+            if (!data || ntohl(requestHeader.dataSize) != sizeof(ChordId)) {
+                CHORD_LOGE("received data request without valid key ...");
+                sendEmptyResponse(connection, requestId, ChordMessageTypeDataNotFound);
+                break;
+            }
+            
+            ChordId key { 0 };
+            memcpy(&key, data.get(), sizeof(ChordId));
+            key = ntohId(key);
+            
+            // search for the data
+            std::shared_ptr<uint8_t> foundData = chord->getDataWithKey(key);
+            
+            if (foundData) {
                 
-                bool added = chord->addDataToHashMap(data);
+                // first 4 bytes contain the data size
+                uint32_t dataSize { 0 };
+                memcpy(&dataSize, foundData.get(), sizeof(dataSize));
+                dataSize = ntohl(dataSize);
                 
+                // send response
                 try {
-                    if (added) {
-                        // send success answer
-                        sendResponse(ChordMessageTypeDataAddSuccess, nullptr, 0);
-                    } else {
-                        // send failed answer
-                        sendResponse(ChordMessageTypeDataAddFailed, nullptr, 0);
-                    }
+                    sendResponse(connection, requestId, ChordMessageTypeDataAnswer, foundData, dataSize);
                     
                 } catch (ChordConnectionException &exception) {
-                    Log::sharedLog()->error(std::string("Error sending response: ") += exception.what());
+                    CHORD_LOGE("Error sending response: " << exception.what());
                 }
                 
-                break;
-            }
-                
-            case ChordMessageTypeDataRequest:
-            {
-                RGPLOGV("received data request message");
-                
-                if (!data) {
-                    Log::sharedLog()->error("received data request without data ...");
-                    break;
+            } else {
+                // send response
+                try {
+                    sendResponse(connection, requestId, ChordMessageTypeDataNotFound, nullptr, 0);
+                    
+                } catch (ChordConnectionException &exception) {
+                    CHORD_LOGE("Error sending response: " << exception.what());
                 }
+            }
+            break;
+        }
+            
+        case ChordMessageTypeDataMultiRequest:
+        {
+            CHORD_LOGV("received data multi request message");
+            
+            uint32_t size { ntohl(requestHeader.dataSize) };
+            uint32_t keyCount { 0 };
+            
+            if (data && size >= sizeof(keyCount)) {
+                memcpy(&keyCount, data.get(), sizeof(keyCount));
+                keyCount = ntohl(keyCount);
+            }
+            
+            if (!data || size < sizeof(keyCount) || (size - sizeof(keyCount)) / sizeof(ChordId) < keyCount) {
+                CHORD_LOGE("received malformed data multi request ...");
+                keyCount = 0;
+            }
+            
+            // collect the found data
+            std::vector<ChordDataItem> items;
+            for (uint32_t i = 0; i < keyCount; i++) {
                 
-                ChordId key = ntohl(*data);
-                
-                // search for the data
-                std::shared_ptr<uint8_t> data = chord->getDataWithKey(key);
+                ChordId key { 0 };
+                memcpy(&key, data.get() + sizeof(keyCount) + i * sizeof(ChordId), sizeof(ChordId));
+                key = ntohId(key);
                 
-                if (data) {
-                    
-                    uint32_t dataSize { ntohl(*data.get()) };
-                    
-                    // send response
-                    try {
-                        sendResponse(ChordMessageTypeDataAnswer, data, dataSize);
-                        
-                    } catch (ChordConnectionException &exception) {
-                        Log::sharedLog()->error(std::string("Error sending response: ") += exception.what());
-                    }
-                    
-                } else {
-                    // send response
-                    try {
-                        sendResponse(ChordMessageTypeDataNotFound, nullptr, 0);
-                        
-                    } catch (ChordConnectionException &exception) {
-                        Log::sharedLog()->error(std::string("Error sending response: ") += exception.what());
-                    }
+                std::shared_ptr<uint8_t> foundData = chord->getDataWithKey(key);
+                if (foundData) {
+                    items.push_back(ChordDataItem(key, foundData));
                 }
-                break;
             }
-                
-            default:
-            {
-                Log::sharedLog()->error(std::string("received unknown message type: ") += std::to_string(requestHeader.type));
-                break;
+            
+            uint32_t answerSize { 0 };
+            std::shared_ptr<uint8_t> answer { batchFromItems(items, 0, items.size(), &answerSize) };
+            
+            try {
+                sendResponse(connection, requestId, ChordMessageTypeDataMultiAnswer, answer, answerSize);
+            } catch (ChordConnectionException &exception) {
+                CHORD_LOGE("Error sending response: " << exception.what());
             }
+            
+            break;
+        }
+            
+        default:
+        {
+            CHORD_LOGE("received unknown message type: " << static_cast<int>(requestHeader.type));
+            return;
         }
     }
     
-    RGPLOGV("close handlingThread");
-    
-    close(_receiveSocket);
-    _receiveSocket = -1;
+    // a forwarded search is answered later (by its handler)
+    if (requestHeader.type != ChordMessageTypeSearch) {
+        chord->metrics()->requestHandled(requestHeader.type, std::chrono::steady_clock::now() - receivedAt);
+    }
+}
+
+// records the time the request took till its response was sent
+void ChordNode::requestHandled (ChordMessageType type, std::chrono::steady_clock::time_point receivedAt)
+{
+    std::shared_ptr<Chord> chord { _chord.lock() };
+    if (chord) {
+        chord->metrics()->requestHandled(type, std::chrono::steady_clock::now() - receivedAt);
+    }
+}
+
+// counts a message in our metrics and in the metrics of the chord
+void ChordNode::messageSent (std::shared_ptr<Chord> chord, ChordMessageType type, uint32_t dataSize)
+{
+    _messagesSent.fetch_add(1, std::memory_order_relaxed);
+    _bytesSent.fetch_add(dataSize, std::memory_order_relaxed);
+    chord->metrics()->messageSent(type, dataSize);
+}
+
+void ChordNode::messageReceived (std::shared_ptr<Chord> chord, ChordMessageType type, uint32_t dataSize)
+{
+    _messagesReceived.fetch_add(1, std::memory_order_relaxed);
+    _bytesReceived.fetch_add(dataSize, std::memory_order_relaxed);
+    chord->metrics()->messageReceived(type, dataSize);
 }
 
 // sends response to remote node
 // throws ChordConnectionException on error
-void ChordNode::sendResponse (ChordMessageType type, std::shared_ptr<uint8_t> data, ssize_t dataSize)
+void ChordNode::sendResponse (std::shared_ptr<ChordConnection> connection, uint32_t requestId, ChordMessageType type,
+                              std::shared_ptr<uint8_t> data, ssize_t dataSize, uint32_t traceId, uint8_t hops)
 {
     // create strong pointer to chord
-    std::shared_ptr<Chord> chord { _chord };
+    std::shared_ptr<Chord> chord { _chord.lock() };
     if (!chord) {
-        RGPLOG_ERROR("Lost chord pointer!");
+        CHORD_LOGE("Lost chord pointer!");
+        throw ChordConnectionException { "Lost chord pointer" };
     }
     
-    // data that will be send later (ChordHeader + the data)
-    uint8_t *message = new uint8_t[sizeof(ChordHeader) + dataSize];
-    
     // header
     ChordHeader header = chord->createChordHeader(type);
-    header.dataSize = htonl(dataSize);
-    
-    // copy header to message
-    memcpy(message, &header, sizeof(ChordHeader));
-    
-    if (dataSize > 0) {
-        // copy data to message
-        memcpy((message + sizeof(ChordHeader)), data.get(), dataSize);
+    header.requestId = htonl(requestId);
+    if (traceId != 0) {
+        header.flags |= ChordMessageFlagTraced;
+        header.traceId = htonl(traceId);
+        header.hops = hops;
     }
     
-    // send message
-    ssize_t bytesSend { 0 };
-    if ((bytesSend = send(_receiveSocket, message, sizeof(ChordHeader) + dataSize, 0)) <= 0) {
-        
-        // memory management
-        delete [] message; message = nullptr;
-        
-        // check if connection was closed
-        if (bytesSend == 0) {
-            Log::sharedLog()->error("Remote Node closed connection");
-            throw ChordConnectionException { "Remote Node closed connection" };
-        }
-        
-        // check if send failed
-        if (bytesSend == -1) {
-            Log::sharedLog()->errorWithErrno("ChordNode::sendResponse():send() ", errno);
-            throw ChordConnectionException { "Error sending data to remote node" };
-        }
+    // several workers may answer at the same time (the connection serializes them)
+    if (!connection) {
+        throw ChordConnectionException { "not connected" };
     }
+    connection->send(header, data, static_cast<uint32_t>(dataSize));
     
-    // memory management
-    if (message != nullptr) {
-        delete [] message; message = nullptr;
+    messageSent(chord, type, static_cast<uint32_t>(dataSize));
+}
+
+// answers a malformed request without data
+void ChordNode::sendEmptyResponse (std::shared_ptr<ChordConnection> connection, uint32_t requestId, ChordMessageType type)
+{
+    try {
+        sendResponse(connection, requestId, type, nullptr, 0);
+    } catch (ChordConnectionException &exception) {
+        CHORD_LOGE("Error sending response: " << exception.what());
     }
 }
 
 // sends request to remote node
+// returns the id of the request
 // throws ChordConnectionException on error
-void ChordNode::sendRequest (ChordMessageType type, std::shared_ptr<uint8_t> data, ssize_t dataSize)
+uint32_t ChordNode::sendRequest (ChordMessageType type, std::shared_ptr<uint8_t> data, ssize_t dataSize,
+                                 ChordResponseHandler handler, uint32_t traceId, uint8_t hops)
 {
     // create strong pointer to chord
-    std::shared_ptr<Chord> chord { _chord };
+    std::shared_ptr<Chord> chord { _chord.lock() };
     if (!chord) {
-        RGPLOG_ERROR("Lost chord pointer!");
+        CHORD_LOGE("Lost chord pointer!");
+        throw ChordConnectionException { "Lost chord pointer" };
     }
     
-    // data that will be send later (ChordHeader + the data)
-    uint8_t *message = new uint8_t[sizeof(ChordHeader) + dataSize];
-    
     // header
     ChordHeader header = chord->createChordHeader(type);
-    header.dataSize = htonl(dataSize);
-    
-    // copy header to message
-    memcpy(message, &header, sizeof(ChordHeader));
-    
-    if (dataSize > 0) {
-        // copy data to message
-        memcpy((message + sizeof(ChordHeader)), data.get(), dataSize);
+    uint32_t requestId { 0 };
+    if (traceId != 0) {
+        header.flags |= ChordMessageFlagTraced;
+        header.traceId = htonl(traceId);
+        header.hops = hops;
     }
     
-    // send message
-    ssize_t bytesSend { 0 };
-    if ((bytesSend = send(_sendSocket, message, sizeof(ChordHeader) + dataSize, 0)) <= 0) {
+    // remember request to be able to assign the response
+    if (handler) {
+        requestId = _nextRequestId++;
+        header.requestId = htonl(requestId);
         
-        delete [] message;
-        message = nullptr;
+        ChordPendingRequest pendingRequest;
+        pendingRequest.handler = handler;
+        pendingRequest.deadline = std::chrono::steady_clock::now() + std::chrono::seconds(kRequestTimeoutSeconds);
         
-        // check if connection was closed
-        if (bytesSend == 0) {
-            Log::sharedLog()->error("Remote Node closed connection");
-            close(_sendSocket);
-            _sendSocket = -1;
-            throw ChordConnectionException { "Remote Node closed connection" };
-        }
-        
-        // check if send failed
-        if (bytesSend == -1) {
-            Log::sharedLog()->errorWithErrno("ChordNode::sendRequest():send() ", errno);
-            throw ChordConnectionException { "Error sending data to remote node" };
-        }
+        _pendingRequests_mutex.lock();
+        _pendingRequests[requestId] = pendingRequest;
+        _pendingRequests_mutex.unlock();
     }
     
-    // memory management
-    if (message != nullptr) {
-        delete [] message;
+    // several requests can be pending
+    _sendConnection_mutex.lock();
+    std::shared_ptr<ChordConnection> connection { _sendConnection };
+    _sendConnection_mutex.unlock();
+    
+    try {
+        if (!connection) {
+            throw ChordConnectionException { "not connected" };
+        }
+        connection->send(header, data, static_cast<uint32_t>(dataSize));
+        
+        messageSent(chord, type, static_cast<uint32_t>(dataSize));
+        
+    } catch (ChordConnectionException &exception) {
+        
+        // no response will arrive
+        _pendingRequests_mutex.lock();
+        _pendingRequests.erase(requestId);
+        _pendingRequests_mutex.unlock();
+        
+        throw;
     }
+    return requestId;
 }
 
-// receives response from remote node
-// throws ChordConnectionException on error
-std::shared_ptr<uint8_t> ChordNode::recvResponse (std::shared_ptr<ChordMessageType> type, std::shared_ptr<ssize_t> dataSize)
+// sends request to remote node and waits for the response
+// throws ChordConnectionException on error or timeout
+ChordResponse ChordNode::request (ChordMessageType type, std::shared_ptr<uint8_t> data, ssize_t dataSize)
 {
-    // receive answer
-    ssize_t readBytes { 0 };
-    ChordHeader responseHeader;
+    std::shared_ptr<std::promise<ChordResponse>> promise { std::make_shared<std::promise<ChordResponse>>() };
+    std::future<ChordResponse> future { promise->get_future() };
     
-    if ((readBytes = recv(_sendSocket, &responseHeader, sizeof(ChordHeader), 0)) <= 0) {
-        
-        if (readBytes == 0) { // connection was closed
-            Log::sharedLog()->error(std::string("Node with id: ") += std::to_string(_nodeID) += " closed the connection");
-            close(_sendSocket);
-            _sendSocket = -1;
-            throw ChordConnectionException { "Node closed the connection" };
+    uint32_t requestId = sendRequest(type, data, dataSize, [promise] (std::exception_ptr error, ChordResponse response) {
+        if (error) {
+            promise->set_exception(error);
+        } else {
+            promise->set_value(response);
         }
+    });
+    
+    if (future.wait_for(std::chrono::seconds(kRequestTimeoutSeconds)) != std::future_status::ready) {
+        CHORD_LOGW("ChordNode::request(): timeout waiting for node: " << _nodeID);
+        
+        // a late response will be dropped
+        _pendingRequests_mutex.lock();
+        _pendingRequests.erase(requestId);
+        _pendingRequests_mutex.unlock();
         
-        // error
-        Log::sharedLog()->errorWithErrno("ChordNode::recvResponse():recv1() ", errno);
-        throw ChordConnectionException { strerror(errno) };
+        throw ChordConnectionException { "timeout waiting for response" };
     }
     
-    // error check
-    if (readBytes != sizeof(ChordHeader)) {
-        Log::sharedLog()->error("don't received enough data ... something bad happened");
-        throw ChordConnectionException { "don't received enough data ... something bad happened" };
+    // throws the exception of the request
+    return future.get();
+}
+
+// passes a response to its waiting request
+void ChordNode::handleResponse (ChordHeader responseHeader, std::shared_ptr<uint8_t> data)
+{
+    // find the request of this response
+    uint32_t requestId { ntohl(responseHeader.requestId) };
+    ChordResponseHandler handler { nullptr };
+    
+    _pendingRequests_mutex.lock();
+    auto iterator = _pendingRequests.find(requestId);
+    if (iterator != _pendingRequests.end()) {
+        handler = iterator->second.handler;
+        _pendingRequests.erase(iterator);
     }
+    _pendingRequests_mutex.unlock();
     
-    *type = static_cast<ChordMessageType>(responseHeader.type);
-    *dataSize = ntohl(responseHeader.dataSize);
+    if (!handler) {
+        CHORD_LOGW("ChordNode::handleResponse(): received response for unknown request: " << requestId);
+        return;
+    }
     
-    if (dataSize > 0) {
-        std::shared_ptr<uint8_t> data(new uint8_t[*dataSize], std::default_delete<uint8_t[]>());
-        
-        // receive the data
-        if ((readBytes = recv(_sendSocket, &data, *dataSize, 0)) <= 0) {
-            if (readBytes == 0) {
-                Log::sharedLog()->error(std::string("Node with id: ") += std::to_string(_nodeID) += " closed the connection");
-                close(_sendSocket);
-                _sendSocket = -1;
-                throw ChordConnectionException { "Node closed the connection" };
-            }
-            Log::sharedLog()->errorWithErrno("ChordNode::recvResponse():recv2() ", errno);
-            throw ChordConnectionException { strerror(errno) };
-        }
-        
-        // error check
-        if (readBytes != *dataSize) {
-            Log::sharedLog()->error("don't received enough data ... something bad happened");
-            throw ChordConnectionException { "don't received enough data ... something bad happened" };
-        }
-        
-        return data;
+    ChordResponse response;
+    response.type = responseHeader.type;
+    response.data = data;
+    response.dataSize = ntohl(responseHeader.dataSize);
+    
+    // create strong pointer to chord
+    std::shared_ptr<Chord> chord { _chord.lock() };
+    if (!chord) {
+        // the chord is destroyed - its protocol threads may still wait for the response
+        handler(std::exception_ptr(), response);
+        return;
     }
     
-    return nullptr;
+    messageReceived(chord, responseHeader.type, response.dataSize);
+    
+    // the handler may send new requests - don't block the connection
+    chord->transport()->dispatch(std::bind(handler, std::exception_ptr(), response));
+}
+
+// all pending requests will fail with the given reason
+void ChordNode::failPendingRequests (std::string reason)
+{
+    std::map<uint32_t, ChordPendingRequest> failedRequests;
+    
+    _pendingRequests_mutex.lock();
+    failedRequests.swap(_pendingRequests);
+    _pendingRequests_mutex.unlock();
+    
+    for (auto iterator : failedRequests) {
+        iterator.second.handler(std::make_exception_ptr(ChordConnectionException { reason }), ChordResponse());
+    }
 }
@@ -0,0 +1,233 @@
+/*
+ ChordReactor.cpp
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/ChordReactor.h>
+#include <rgp/Log.h>
+
+#include <unistd.h>
+#include <cerrno>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+
+using namespace rgp;
+
+#pragma mark - Constructor / Destructor
+
+ChordReactor::ChordReactor (int workerCount)
+{
+    _epollSocket = epoll_create1(EPOLL_CLOEXEC);
+    if (_epollSocket < 0) {
+        Log::sharedLog()->errorWithErrno("ChordReactor::ChordReactor():epoll_create1() ", errno);
+    }
+    
+    // the wakeup socket is the only socket that is not oneshot
+    _wakeupSocket = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    struct epoll_event event { };
+    event.events = EPOLLIN;
+    event.data.u64 = static_cast<uint32_t>(_wakeupSocket);
+    epoll_ctl(_epollSocket, EPOLL_CTL_ADD, _wakeupSocket, &event);
+    
+    // start workers
+    if (workerCount < 1) {
+        workerCount = 1;
+    }
+    for (int k = 0; k < workerCount; k++) {
+        _workerThreads.push_back(std::thread(&ChordReactor::runWorker, this));
+    }
+    
+    // start event loop
+    _eventThread = std::thread(&ChordReactor::runEventLoop, this);
+}
+
+ChordReactor::~ChordReactor ()
+{
+    _stop = true;
+    
+    // wake up event loop
+    uint64_t wakeup { 1 };
+    if (write(_wakeupSocket, &wakeup, sizeof(wakeup)) < 0) {
+        Log::sharedLog()->errorWithErrno("ChordReactor::~ChordReactor():write() ", errno);
+    }
+    
+    try {
+        _eventThread.join();
+    } catch (...) {} // if thread not joinable
+    
+    // unblock workers that wait for data of a socket
+    _handlers_mutex.lock();
+    for (auto iterator : _handlers) {
+        shutdown(iterator.first, SHUT_RDWR);
+    }
+    _handlers_mutex.unlock();
+    
+    // wake up workers
+    _tasks_mutex.lock();
+    _tasks_condition.notify_all();
+    _tasks_mutex.unlock();
+    
+    for (std::thread &worker : _workerThreads) {
+        try {
+            worker.join();
+        } catch (...) {} // if thread not joinable
+    }
+    
+    close(_wakeupSocket);
+    close(_epollSocket);
+}
+
+#pragma mark - Public
+
+// watch the socket and call handler (on a worker) if there is data
+// replaces the handler if the socket is already watched
+void ChordReactor::addSocket (int socket, ChordReadHandler handler)
+{
+    _handlers_mutex.lock();
+    bool add = _handlers.find(socket) == _handlers.end();
+    uint32_t generation = _nextGeneration++;
+    if (_nextGeneration == 0) {
+        _nextGeneration = 1;
+    }
+    _handlers[socket] = ChordRegistration { handler, generation };
+    armSocket(socket, generation, add);
+    _handlers_mutex.unlock();
+}
+
+// stops watching the socket (the socket will not be closed)
+void ChordReactor::removeSocket (int socket)
+{
+    _handlers_mutex.lock();
+    if (_handlers.erase(socket) > 0) {
+        epoll_ctl(_epollSocket, EPOLL_CTL_DEL, socket, nullptr);
+    }
+    _handlers_mutex.unlock();
+}
+
+// executes the task on one of the worker threads
+void ChordReactor::dispatch (std::function<void ()> task)
+{
+    _tasks_mutex.lock();
+    _tasks.push(task);
+    _tasks_mutex.unlock();
+    
+    _tasks_condition.notify_one();
+}
+
+#pragma mark - Private
+
+void ChordReactor::runEventLoop ()
+{
+    const int kMaxEvents { 64 };
+    struct epoll_event events[kMaxEvents];
+    
+    while (!_stop) {
+        
+        int count = epoll_wait(_epollSocket, events, kMaxEvents, -1);
+        
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            Log::sharedLog()->errorWithErrno("ChordReactor::runEventLoop():epoll_wait() ", errno);
+            break;
+        }
+        
+        for (int k = 0; k < count; k++) {
+            
+            // socket in the low, generation in the high half
+            int socket = static_cast<int>(events[k].data.u64 & 0xffffffff);
+            uint32_t generation = static_cast<uint32_t>(events[k].data.u64 >> 32);
+            
+            if (generation == 0) {
+                continue;
+            }
+            
+            // socket is disarmed until the handler finished (oneshot)
+            dispatch(std::bind(&ChordReactor::handleSocket, this, socket, generation));
+        }
+    }
+}
+
+void ChordReactor::runWorker ()
+{
+    while (true) {
+        
+        std::unique_lock<std::mutex> lock(_tasks_mutex);
+        _tasks_condition.wait(lock, [this] { return _stop || !_tasks.empty(); });
+        
+        if (_stop) {
+            break;
+        }
+        
+        std::function<void ()> task { _tasks.front() };
+        _tasks.pop();
+        lock.unlock();
+        
+        task();
+    }
+}
+
+// executes the handler of the socket and arms the socket again
+// does nothing if the socket was registered again meanwhile
+void ChordReactor::handleSocket (int socket, uint32_t generation)
+{
+    // copy the handler - the handler may remove or replace itself
+    // a task queued for a closed socket must not run the handler of a new
+    // socket with the same number
+    _handlers_mutex.lock();
+    auto iterator = _handlers.find(socket);
+    if (iterator == _handlers.end() || iterator->second.generation != generation) {
+        _handlers_mutex.unlock();
+        return;
+    }
+    ChordReadHandler handler { iterator->second.handler };
+    _handlers_mutex.unlock();
+    
+    if (handler()) {
+        
+        // only arm if nobody removed or registered the socket meanwhile
+        // (addSocket arms the socket itself)
+        _handlers_mutex.lock();
+        iterator = _handlers.find(socket);
+        if (iterator != _handlers.end() && iterator->second.generation == generation) {
+            armSocket(socket, generation, false);
+        }
+        _handlers_mutex.unlock();
+    }
+}
+
+// wait for the next event on the socket
+// handlers_mutex has to be locked
+void ChordReactor::armSocket (int socket, uint32_t generation, bool add)
+{
+    struct epoll_event event { };
+    event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+    event.data.u64 = (static_cast<uint64_t>(generation) << 32) | static_cast<uint32_t>(socket);
+    
+    if (epoll_ctl(_epollSocket, add ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, socket, &event) != 0) {
+        Log::sharedLog()->errorWithErrno("ChordReactor::armSocket():epoll_ctl() ", errno);
+    }
+}
@@ -0,0 +1,133 @@
+/*
+ ChordShardedDataStore.cpp
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/ChordShardedDataStore.h>
+#include <rgp/Chord.h>
+
+#include <limits>
+
+using namespace rgp;
+
+const int ChordShardedDataStore::kShardBits;
+const int ChordShardedDataStore::kShardCount;
+
+#pragma mark - Constructor / Destructor
+
+ChordShardedDataStore::ChordShardedDataStore ()
+{
+    for (Shard &shard : _shards) {
+        pthread_rwlock_init(&shard.lock, nullptr);
+    }
+}
+
+ChordShardedDataStore::~ChordShardedDataStore ()
+{
+    for (Shard &shard : _shards) {
+        pthread_rwlock_destroy(&shard.lock);
+    }
+}
+
+#pragma mark - Public
+
+void ChordShardedDataStore::put (ChordId key, std::shared_ptr<uint8_t> data)
+{
+    Shard &shard = _shards[shardIndex(key)];
+    
+    pthread_rwlock_wrlock(&shard.lock);
+    shard.store.put(key, data);
+    pthread_rwlock_unlock(&shard.lock);
+}
+
+std::shared_ptr<uint8_t> ChordShardedDataStore::get (ChordId key)
+{
+    Shard &shard = _shards[shardIndex(key)];
+    
+    pthread_rwlock_rdlock(&shard.lock);
+    std::shared_ptr<uint8_t> data { shard.store.get(key) };
+    pthread_rwlock_unlock(&shard.lock);
+    
+    return data;
+}
+
+bool ChordShardedDataStore::remove (ChordId key)
+{
+    Shard &shard = _shards[shardIndex(key)];
+    
+    pthread_rwlock_wrlock(&shard.lock);
+    bool removed { shard.store.remove(key) };
+    pthread_rwlock_unlock(&shard.lock);
+    
+    return removed;
+}
+
+// removes all data inside the ring interval [from, to]
+void ChordShardedDataStore::removeRange (ChordId from, ChordId to, std::vector<ChordDataItem> *removed)
+{
+    if (from <= to) {
+        removeSlice(from, to, removed);
+    } else {
+        // interval wraps around zero
+        removeSlice(from, std::numeric_limits<ChordId>::max(), removed);
+        removeSlice(0, to, removed);
+    }
+}
+
+// number of stored keys
+size_t ChordShardedDataStore::size ()
+{
+    size_t size { 0 };
+    
+    for (Shard &shard : _shards) {
+        pthread_rwlock_rdlock(&shard.lock);
+        size += shard.store.size();
+        pthread_rwlock_unlock(&shard.lock);
+    }
+    
+    return size;
+}
+
+#pragma mark - Private
+
+// shard of the key
+int ChordShardedDataStore::shardIndex (ChordId key)
+{
+    // keys are hashes - the highest bits are distributed evenly
+    return static_cast<int>((static_cast<uint64_t>(key) >> (Chord::kKeyLenght - kShardBits)) & (kShardCount - 1));
+}
+
+// removes the interval [from, to] (from <= to) from the shards it covers
+void ChordShardedDataStore::removeSlice (ChordId from, ChordId to, std::vector<ChordDataItem> *removed)
+{
+    // the shards are ordered by key - only the covered ones are locked
+    for (int index = shardIndex(from); index <= shardIndex(to); index++) {
+        
+        Shard &shard = _shards[index];
+        
+        pthread_rwlock_wrlock(&shard.lock);
+        shard.store.removeRange(from, to, removed);
+        pthread_rwlock_unlock(&shard.lock);
+    }
+}
@@ -0,0 +1,513 @@
+/*
+ ChordSimulator.cpp
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/ChordSimulator.h>
+#include <rgp/ChordMemoryTransport.h>
+#include <rgp/ChordSocketTransport.h>
+#include <rgp/ChordNode.h>
+#include <rgp/ChordHash.h>
+#include <rgp/ChordHost.h>
+#include <rgp/Log.h>
+
+#include <set>
+#include <thread>
+#include <tuple>
+#include <algorithm>
+#include <cstring>
+#include <arpa/inet.h>
+
+using namespace rgp;
+
+const uint16_t ChordSimulator::kPort;
+const uint16_t ChordSimulator::kLoopbackPort;
+const int ChordSimulator::kDefaultJoinBatchSize;
+
+#pragma mark - Constructor / Destructor
+
+ChordSimulator::ChordSimulator (int workerCount, ChordSimulatorNetwork network)
+: _minStabilizeInterval(Chord::kMinStabilizeInterval), _maxStabilizeInterval(Chord::kMaxStabilizeInterval), _random(std::random_device()())
+{
+    if (network == ChordSimulatorNetworkLoopback) {
+        _socketTransport = std::make_shared<ChordSocketTransport>(workerCount);
+    } else {
+        _network = std::make_shared<ChordMemoryNetwork>(workerCount);
+    }
+}
+
+ChordSimulator::~ChordSimulator ()
+{
+    _nodes_mutex.lock();
+    std::vector<std::shared_ptr<Chord>> nodes;
+    for (auto iterator : _nodes) {
+        nodes.push_back(iterator.second);
+    }
+    _nodes.clear();
+    _nodes_mutex.unlock();
+    
+    // stops the protocols of all nodes
+    // (before they are released - a protocol thread must not destroy its own node)
+    for (std::shared_ptr<Chord> node : nodes) {
+        node->stop();
+    }
+    nodes.clear();
+    
+    // failed nodes may still be destroyed and tasks of the workers may still
+    // use a node (and its transport) - the network must not be destroyed by
+    // one of its own workers
+    std::chrono::steady_clock::time_point deadline { std::chrono::steady_clock::now() +
+                                                     2 * std::chrono::seconds(ChordNode::kRequestTimeoutSeconds) };
+    while ((_network.use_count() > 1 || _socketTransport.use_count() > 1) &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    
+    _network.reset();
+    _socketTransport.reset();
+}
+
+#pragma mark - Public
+
+// stabilize interval of the nodes that are added afterwards
+void ChordSimulator::setStabilizeInterval (std::chrono::milliseconds minimum, std::chrono::milliseconds maximum)
+{
+    _minStabilizeInterval = minimum;
+    _maxStabilizeInterval = maximum;
+}
+
+// lookup mode of the nodes that are added afterwards
+void ChordSimulator::setLookupMode (ChordLookupMode mode, int parallelism)
+{
+    _lookupMode = mode;
+    _lookupParallelism = parallelism;
+}
+
+// virtual nodes per host of the nodes that are added afterwards
+void ChordSimulator::setVirtualNodes (int weight)
+{
+    _virtualNodes = std::max(1, std::min(weight, ChordHost::kMaxWeight));
+    _hostNodeCount = 0;
+}
+
+// replication factor of the nodes that are added afterwards
+void ChordSimulator::setReplicationFactor (int replicationFactor)
+{
+    _replicationFactor = replicationFactor;
+}
+
+// starts count new nodes
+void ChordSimulator::addNodes (int count, int batchSize)
+{
+    batchSize = std::max(1, batchSize);
+    
+    while (count > 0) {
+        
+        // ids, addresses and join nodes of this batch
+        std::vector<ChordId> nodeIds;
+        std::vector<std::string> ipAddresses;
+        std::vector<uint16_t> ports;
+        std::vector<std::shared_ptr<Chord>> joinNodes;
+        std::vector<std::shared_ptr<ChordShardedDataStore>> dataMaps;
+        std::vector<std::shared_ptr<ChordShardedDataStore>> replicaMaps;
+        
+        _nodes_mutex.lock();
+        
+        std::vector<std::shared_ptr<Chord>> runningNodes;
+        for (auto iterator : _nodes) {
+            runningNodes.push_back(iterator.second);
+        }
+        
+        // the first node has to create the ring before anybody can join
+        int batch { runningNodes.empty() ? 1 : std::min(batchSize, count) };
+        
+        while (static_cast<int>(nodeIds.size()) < batch) {
+            std::string ipAddress;
+            uint16_t port { 0 };
+            addressForIndex(_nextAddress++, &ipAddress, &port);
+            ChordId nodeId { ChordHash::keyForNode(ipAddress, port) };
+            
+            // a node with the same id couldn't join - skip this address
+            if (_nodes.count(nodeId) > 0 || std::find(nodeIds.begin(), nodeIds.end(), nodeId) != nodeIds.end()) {
+                continue;
+            }
+            
+            nodeIds.push_back(nodeId);
+            ipAddresses.push_back(ipAddress);
+            ports.push_back(port);
+            
+            // the virtual nodes of a host share its stores
+            if (_virtualNodes > 1) {
+                if (_hostNodeCount % _virtualNodes == 0) {
+                    _hostDataMap = std::make_shared<ChordShardedDataStore>();
+                    _hostReplicaMap = std::make_shared<ChordShardedDataStore>();
+                }
+                _hostNodeCount++;
+            }
+            dataMaps.push_back(_virtualNodes > 1 ? _hostDataMap : nullptr);
+            replicaMaps.push_back(_virtualNodes > 1 ? _hostReplicaMap : nullptr);
+            
+            if (runningNodes.empty()) {
+                joinNodes.push_back(nullptr);
+            } else {
+                std::uniform_int_distribution<size_t> distribution(0, runningNodes.size() - 1);
+                joinNodes.push_back(runningNodes[distribution(_random)]);
+            }
+        }
+        
+        _nodes_mutex.unlock();
+        
+        // joining waits for the network - join the whole batch at the same time
+        std::vector<std::shared_ptr<Chord>> startedNodes(batch);
+        std::vector<std::thread> threads;
+        
+        for (int k = 0; k < batch; k++) {
+            threads.push_back(std::thread([this, k, &startedNodes, &nodeIds, &ipAddresses, &ports, &joinNodes,
+                                           &dataMaps, &replicaMaps] () {
+                startedNodes[k] = startNode(nodeIds[k], ipAddresses[k], ports[k], joinNodes[k],
+                                            dataMaps[k], replicaMaps[k]);
+            }));
+        }
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+        
+        _nodes_mutex.lock();
+        for (std::shared_ptr<Chord> node : startedNodes) {
+            _nodes[node->ownNode()->getNodeID()] = node;
+        }
+        _nodes_mutex.unlock();
+        
+        count -= batch;
+    }
+}
+
+// all running nodes ordered by their id
+std::vector<std::shared_ptr<Chord>> ChordSimulator::nodes ()
+{
+    std::vector<std::shared_ptr<Chord>> nodes;
+    
+    _nodes_mutex.lock();
+    for (auto iterator : _nodes) {
+        nodes.push_back(iterator.second);
+    }
+    _nodes_mutex.unlock();
+    
+    return nodes;
+}
+
+// fails the fraction of the running nodes
+int ChordSimulator::failNodes (double fraction)
+{
+    _nodes_mutex.lock();
+    
+    std::vector<ChordId> nodeIds;
+    for (auto iterator : _nodes) {
+        nodeIds.push_back(iterator.first);
+    }
+    std::shuffle(nodeIds.begin(), nodeIds.end(), _random);
+    
+    // at least one node keeps running
+    int count { static_cast<int>(fraction * nodeIds.size() + 0.5) };
+    count = std::max(0, std::min(count, static_cast<int>(nodeIds.size()) - 1));
+    
+    std::vector<std::shared_ptr<Chord>> failedNodes;
+    
+    for (int k = 0; k < count; k++) {
+        std::shared_ptr<Chord> node { _nodes[nodeIds[k]] };
+        
+        if (_network) {
+            _network->setFailed(node->ownNode()->getIPAddress(), node->ownNode()->getPort(), true);
+        }
+        
+        failedNodes.push_back(node);
+        _nodes.erase(nodeIds[k]);
+    }
+    
+    _nodes_mutex.unlock();
+    
+    // a crashed node doesn't run its protocols anymore
+    // (destroying a node waits for its requests - that may take up to the request timeout)
+    std::thread([failedNodes] () mutable {
+        for (std::shared_ptr<Chord> node : failedNodes) {
+            node->stop();
+        }
+        failedNodes.clear();
+    }).detach();
+    
+    return count;
+}
+
+// fraction of the running nodes that know their correct successor
+double ChordSimulator::correctSuccessors ()
+{
+    std::vector<std::shared_ptr<Chord>> runningNodes { nodes() };
+    
+    if (runningNodes.empty()) {
+        return 1.0;
+    }
+    
+    size_t correct { 0 };
+    
+    for (size_t k = 0; k < runningNodes.size(); k++) {
+        
+        // the nodes are ordered by their id
+        ChordId expected { runningNodes[(k + 1) % runningNodes.size()]->ownNode()->getNodeID() };
+        std::vector<ChordHeaderNode> successors { runningNodes[k]->successorList() };
+        
+        if (successors.empty()) {
+            // only a single node doesn't have a successor
+            correct += runningNodes.size() == 1 ? 1 : 0;
+        } else if (ntohId(successors.front().nodeId) == expected) {
+            correct++;
+        }
+    }
+    
+    return static_cast<double>(correct) / runningNodes.size();
+}
+
+// waits till every running node knows its correct successor
+bool ChordSimulator::waitForConvergence (std::chrono::milliseconds timeout)
+{
+    std::chrono::steady_clock::time_point deadline { std::chrono::steady_clock::now() + timeout };
+    
+    while (correctSuccessors() < 1.0) {
+        
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    
+    return true;
+}
+
+// runs count lookups of random keys from random nodes
+ChordSimulator::ChordLookupStatistics ChordSimulator::measureLookups (int count, std::chrono::seconds timeout)
+{
+    ChordLookupStatistics statistics;
+    
+    std::vector<std::shared_ptr<Chord>> runningNodes { nodes() };
+    if (runningNodes.empty()) {
+        return statistics;
+    }
+    
+    std::uniform_int_distribution<size_t> nodeDistribution(0, runningNodes.size() - 1);
+    
+    int routes { 0 };
+    int64_t hops { 0 };
+    int successfulLookups { 0 };
+    double milliseconds { 0 };
+    
+    for (int k = 0; k < count; k++) {
+        
+        std::shared_ptr<Chord> node { runningNodes[nodeDistribution(_random)] };
+        ChordId key { randomKey() };
+        
+        statistics.lookups++;
+        
+        // the lookup returns the hops of its route
+        std::shared_ptr<std::promise<std::pair<ChordHeaderNode, int>>> promise { std::make_shared<std::promise<std::pair<ChordHeaderNode, int>>>() };
+        std::future<std::pair<ChordHeaderNode, int>> future { promise->get_future() };
+        
+        std::chrono::steady_clock::time_point start { std::chrono::steady_clock::now() };
+        node->routedLookupAsync(key, [promise] (std::exception_ptr error, ChordHeaderNode responsibleNode, int hops) {
+            if (error) {
+                promise->set_exception(error);
+            } else {
+                promise->set_value(std::make_pair(responsibleNode, hops));
+            }
+        });
+        
+        if (future.wait_for(timeout) != std::future_status::ready) {
+            statistics.failedLookups++;
+            continue;
+        }
+        
+        ChordHeaderNode responsibleNode;
+        int routeLength { 0 };
+        try {
+            std::tie(responsibleNode, routeLength) = future.get();
+        } catch (...) {
+            statistics.failedLookups++;
+            continue;
+        }
+        
+        std::chrono::duration<double, std::milli> duration { std::chrono::steady_clock::now() - start };
+        
+        if (ntohId(responsibleNode.nodeId) != responsibleNodeId(key)) {
+            statistics.wrongLookups++;
+        } else {
+            successfulLookups++;
+            milliseconds += duration.count();
+        }
+        
+        routes++;
+        hops += routeLength;
+        statistics.maxHops = std::max(statistics.maxHops, routeLength);
+    }
+    
+    if (routes > 0) {
+        statistics.averageHops = static_cast<double>(hops) / routes;
+    }
+    if (successfulLookups > 0) {
+        statistics.averageMilliseconds = milliseconds / successfulLookups;
+    }
+    
+    return statistics;
+}
+
+// stores count random keys from random nodes
+int ChordSimulator::storeKeys (int count, std::chrono::seconds timeout)
+{
+    std::vector<std::shared_ptr<Chord>> runningNodes { nodes() };
+    if (runningNodes.empty()) {
+        return count;
+    }
+    
+    std::uniform_int_distribution<size_t> nodeDistribution(0, runningNodes.size() - 1);
+    int failedKeys { 0 };
+    
+    for (int k = 0; k < count; k++) {
+        
+        ChordId key { randomKey() };
+        
+        // the data starts with its size (see ChordDataStore) followed by the key
+        uint32_t size { sizeof(uint32_t) + sizeof(ChordId) };
+        std::shared_ptr<uint8_t> data { new uint8_t[size], std::default_delete<uint8_t[]>() };
+        uint32_t networkSize { htonl(size) };
+        memcpy(data.get(), &networkSize, sizeof(uint32_t));
+        memcpy(data.get() + sizeof(uint32_t), &key, sizeof(ChordId));
+        
+        std::future<bool> future { runningNodes[nodeDistribution(_random)]->putAsync(key, data) };
+        
+        bool stored { false };
+        try {
+            stored = future.wait_for(timeout) == std::future_status::ready && future.get();
+        } catch (...) {
+        }
+        
+        if (stored) {
+            _storedKeys.push_back(key);
+        } else {
+            failedKeys++;
+        }
+    }
+    
+    return failedKeys;
+}
+
+// reads every stored key from a random node
+int ChordSimulator::missingKeys (std::chrono::seconds timeout)
+{
+    std::vector<std::shared_ptr<Chord>> runningNodes { nodes() };
+    if (runningNodes.empty()) {
+        return static_cast<int>(_storedKeys.size());
+    }
+    
+    std::uniform_int_distribution<size_t> nodeDistribution(0, runningNodes.size() - 1);
+    int missing { 0 };
+    
+    for (ChordId key : _storedKeys) {
+        
+        std::future<std::shared_ptr<uint8_t>> future { runningNodes[nodeDistribution(_random)]->getAsync(key) };
+        
+        bool found { false };
+        try {
+            found = future.wait_for(timeout) == std::future_status::ready && future.get() != nullptr;
+        } catch (...) {
+        }
+        
+        if (!found) {
+            missing++;
+        }
+    }
+    
+    return missing;
+}
+
+#pragma mark - Private
+
+// ip address of the node with the given index (10.x.y.z)
+void ChordSimulator::addressForIndex (int index, std::string *ipAddress, uint16_t *port) const
+{
+    if (_socketTransport) {
+        *ipAddress = "127.0.0.1";
+        *port = static_cast<uint16_t>(kLoopbackPort + index);
+        return;
+    }
+    
+    index++; // 10.0.0.0 is no host address
+    
+    *ipAddress = (((((std::string("10.") += std::to_string((index >> 16) & 0xFF)) += ".")
+                    += std::to_string((index >> 8) & 0xFF)) += ".") += std::to_string(index & 0xFF));
+    *port = kPort;
+}
+
+// creates and starts a node
+std::shared_ptr<Chord> ChordSimulator::startNode (ChordId nodeId, std::string ipAddress, uint16_t port,
+                                                  std::shared_ptr<Chord> joinNode,
+                                                  std::shared_ptr<ChordShardedDataStore> dataMap,
+                                                  std::shared_ptr<ChordShardedDataStore> replicaMap)
+{
+    // all nodes on the loopback network share one reactor
+    std::shared_ptr<ChordTransport> transport { _socketTransport };
+    if (!transport) {
+        transport = std::make_shared<ChordMemoryTransport>(_network, ipAddress, port);
+    }
+    
+    std::string joinIpAddress { joinNode ? joinNode->ownNode()->getIPAddress() : "" };
+    uint16_t joinPort { static_cast<uint16_t>(joinNode ? joinNode->ownNode()->getPort() : 0) };
+    
+    std::shared_ptr<Chord> node { std::make_shared<Chord>(nodeId, ipAddress, port, joinIpAddress, joinPort, transport,
+                                                          true, dataMap, replicaMap) };
+    node->setStabilizeInterval(_minStabilizeInterval, _maxStabilizeInterval);
+    node->setLookupMode(_lookupMode, _lookupParallelism);
+    node->setReplicationFactor(_replicationFactor);
+    node->start();
+    
+    return node;
+}
+
+// running node that is responsible for the key (first node at or after the key)
+ChordId ChordSimulator::responsibleNodeId (ChordId key)
+{
+    _nodes_mutex.lock();
+    auto iterator = _nodes.lower_bound(key);
+    if (iterator == _nodes.end()) {
+        iterator = _nodes.begin();
+    }
+    ChordId nodeId { iterator->first };
+    _nodes_mutex.unlock();
+    
+    return nodeId;
+}
+
+// random key of the whole ring
+ChordId ChordSimulator::randomKey ()
+{
+    std::uniform_int_distribution<ChordId> distribution(0, Chord::highestID());
+    return distribution(_random);
+}
@@ -0,0 +1,222 @@
+/*
+ ChordSocketConnection.cpp
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/ChordSocketConnection.h>
+#include <rgp/ChordReactor.h>
+#include <rgp/ChordWire.h>
+#include <rgp/ChordLog.h>
+#include <rgp/Log.h>
+
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+using namespace rgp;
+
+#pragma mark - Constructor / Destructor
+
+ChordSocketConnection::ChordSocketConnection (int socket, std::shared_ptr<ChordReactor> reactor)
+: _socket(socket), _reactor(reactor)
+{
+    // requests and responses are small - don't delay them till more data is send (nagle)
+    int noDelay { 1 };
+    setsockopt(_socket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+}
+
+ChordSocketConnection::~ChordSocketConnection ()
+{
+    close();
+    
+    // nobody reads from the socket anymore (the reactor's handler keeps the connection alive)
+    if (_socket != -1) {
+        ::close(_socket);
+    }
+}
+
+#pragma mark - Public
+
+// sends the header followed by the data
+void ChordSocketConnection::send (ChordHeader header, std::shared_ptr<uint8_t> data, uint32_t dataSize)
+{
+    header.dataSize = htonl(dataSize);
+    
+    uint8_t encodedHeader[ChordWire::kMaxHeaderSize];
+    size_t headerSize { ChordWire::encodeHeader(header, encodedHeader) };
+    
+    // header and data are send directly from their buffers (no copy)
+    struct iovec parts[2];
+    parts[0].iov_base = encodedHeader;
+    parts[0].iov_len = headerSize;
+    parts[1].iov_base = data.get();
+    parts[1].iov_len = (dataSize > 0 && data) ? dataSize : 0;
+    
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = parts;
+    message.msg_iovlen = parts[1].iov_len > 0 ? 2 : 1;
+    
+    _socket_mutex.lock();
+    
+    if (_socket == -1 || _closed) {
+        _socket_mutex.unlock();
+        throw ChordConnectionException { "not connected" };
+    }
+    
+    // send message - the socket may take only a part of it
+    while (message.msg_iovlen > 0) {
+        
+        ssize_t bytesSend { sendmsg(_socket, &message, MSG_NOSIGNAL) };
+        
+        if (bytesSend < 0 && errno == EINTR) {
+            continue;
+        }
+        
+        if (bytesSend <= 0) {
+            _socket_mutex.unlock();
+            
+            // check if connection was closed
+            if (bytesSend == 0) {
+                CHORD_LOGW("Remote Node closed connection");
+                throw ChordConnectionException { "Remote Node closed connection" };
+            }
+            
+            // check if send failed
+            Log::sharedLog()->errorWithErrno("ChordSocketConnection::send():sendmsg() ", errno);
+            throw ChordConnectionException { "Error sending data to remote node" };
+        }
+        
+        // skip the parts that were send completely
+        while (message.msg_iovlen > 0 && static_cast<size_t>(bytesSend) >= message.msg_iov->iov_len) {
+            bytesSend -= message.msg_iov->iov_len;
+            message.msg_iov++;
+            message.msg_iovlen--;
+        }
+        
+        // continue inside the partially send part
+        if (message.msg_iovlen > 0) {
+            message.msg_iov->iov_base = static_cast<uint8_t *>(message.msg_iov->iov_base) + bytesSend;
+            message.msg_iov->iov_len -= bytesSend;
+        }
+    }
+    
+    _socket_mutex.unlock();
+}
+
+// passes the received messages to the handler
+void ChordSocketConnection::receive (ChordMessageHandler handler, ChordClosedHandler closedHandler)
+{
+    _handler_mutex.lock();
+    _handler = handler;
+    _closedHandler = closedHandler;
+    bool startReceiving { !_receiving };
+    _receiving = true;
+    _handler_mutex.unlock();
+    
+    // a new handler of a watched socket is used for the next message
+    if (!startReceiving) {
+        return;
+    }
+    
+    std::shared_ptr<ChordReactor> reactor { _reactor.lock() };
+    if (!reactor) {
+        return;
+    }
+    
+    // the reactor keeps the connection alive till it is closed
+    std::shared_ptr<ChordSocketConnection> connection { shared_from_this() };
+    
+    _socket_mutex.lock();
+    if (_socket != -1 && !_closed) {
+        reactor->addSocket(_socket, [connection] () {
+            return connection->handleReadable();
+        });
+    }
+    _socket_mutex.unlock();
+}
+
+// closes the connection
+// the socket is only shut down - a worker may still read from it, the
+// descriptor is released with the connection (and can't be reused before)
+void ChordSocketConnection::close ()
+{
+    _socket_mutex.lock();
+    if (_socket != -1 && !_closed) {
+        
+        // the reactor may already be gone
+        std::shared_ptr<ChordReactor> reactor { _reactor.lock() };
+        if (reactor) {
+            reactor->removeSocket(_socket);
+        }
+        
+        shutdown(_socket, SHUT_RDWR);
+        _closed = true;
+    }
+    _socket_mutex.unlock();
+    
+    _handler_mutex.lock();
+    _handler = nullptr;
+    _closedHandler = nullptr;
+    _handler_mutex.unlock();
+}
+
+#pragma mark - Private
+
+// reads the available messages (called by reactor)
+bool ChordSocketConnection::handleReadable ()
+{
+    bool connected = _reader.readFrames(_socket, [this] (ChordHeader header, std::shared_ptr<uint8_t> data) {
+        
+        // the handler may replace itself
+        _handler_mutex.lock();
+        ChordMessageHandler handler { _handler };
+        _handler_mutex.unlock();
+        
+        if (handler) {
+            handler(header, data);
+        }
+    });
+    
+    if (!connected) {
+        
+        _handler_mutex.lock();
+        ChordClosedHandler closedHandler { _closedHandler };
+        _handler_mutex.unlock();
+        
+        close();
+        
+        if (closedHandler) {
+            closedHandler();
+        }
+        return false;
+    }
+    
+    return true;
+}
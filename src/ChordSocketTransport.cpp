@@ -0,0 +1,191 @@
+/*
+ ChordSocketTransport.cpp
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/ChordSocketTransport.h>
+#include <rgp/ChordSocketConnection.h>
+#include <rgp/ChordLog.h>
+#include <rgp/Log.h>
+
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <netdb.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+using namespace rgp;
+
+#pragma mark - Constructor / Destructor
+
+ChordSocketTransport::ChordSocketTransport (int workerCount)
+: _reactor(std::make_shared<ChordReactor>(workerCount))
+{
+}
+
+ChordSocketTransport::~ChordSocketTransport ()
+{
+    // stop accepting connections
+    _listeningSockets_mutex.lock();
+    for (auto iterator : _listeningSockets) {
+        _reactor->removeSocket(iterator.second);
+        close(iterator.second);
+    }
+    _listeningSockets.clear();
+    _listeningSockets_mutex.unlock();
+    
+    // stops event loop and workers
+    _reactor.reset();
+}
+
+#pragma mark - Public
+
+// accepts connections on the port (of all interfaces - the address isn't needed)
+bool ChordSocketTransport::listen (std::string, uint16_t port, ChordAcceptHandler handler)
+{
+    int listeningSocket { listenOnPort(port) };
+    if (listeningSocket == -1) {
+        return false;
+    }
+    
+    _listeningSockets_mutex.lock();
+    _listeningSockets[port] = listeningSocket;
+    _listeningSockets_mutex.unlock();
+    
+    // handle incomming connects
+    _reactor->addSocket(listeningSocket, std::bind(&ChordSocketTransport::acceptConnection, this, listeningSocket, handler));
+    
+    return true;
+}
+
+// stops accepting connections on the port
+void ChordSocketTransport::stopListening (std::string, uint16_t port)
+{
+    _listeningSockets_mutex.lock();
+    auto iterator = _listeningSockets.find(port);
+    if (iterator != _listeningSockets.end()) {
+        _reactor->removeSocket(iterator->second);
+        close(iterator->second);
+        _listeningSockets.erase(iterator);
+    }
+    _listeningSockets_mutex.unlock();
+}
+
+// opens a connection to the given address
+std::shared_ptr<ChordConnection> ChordSocketTransport::connect (std::string ipAddress, uint16_t port)
+{
+    // create socket
+    int sendSocket = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
+    
+    // create sockaddr
+    struct sockaddr_in addr4client;
+    memset(&addr4client, 0, sizeof(addr4client)); // fill struct with zeros
+#ifndef __linux__
+    addr4client.sin_len = sizeof(addr4client);
+#endif
+    addr4client.sin_family = AF_INET;
+    addr4client.sin_port = htons(port);
+    
+    if((addr4client.sin_addr.s_addr = inet_addr(ipAddress.c_str())) == (unsigned long)INADDR_NONE)
+    {
+        // ERROR: INADDR_NONE - try with hostname
+        struct hostent *hostp = gethostbyname(ipAddress.c_str());
+        if (hostp == NULL) {
+            Log::sharedLog()->errorWithErrno("ChordSocketTransport::connect():hostent failed - cannot use given host address ", errno);
+            close(sendSocket);
+            return nullptr; // we cannot connect
+        } else {
+            memcpy(&addr4client.sin_addr, hostp->h_addr, sizeof(addr4client.sin_addr));
+        }
+    }
+    
+    // connect
+    if (::connect(sendSocket, (struct sockaddr*)&addr4client, sizeof(struct sockaddr_in)) != 0) {
+        Log::sharedLog()->errorWithErrno("ChordSocketTransport::connect():connect(): ", errno);
+        close(sendSocket);
+        return nullptr; // we cannot connect
+    }
+    
+    return std::make_shared<ChordSocketConnection>(sendSocket, _reactor);
+}
+
+// executes the task on one of the reactor's workers
+void ChordSocketTransport::dispatch (std::function<void ()> task)
+{
+    _reactor->dispatch(task);
+}
+
+#pragma mark - Private
+
+// opens a socket that listens on the given port
+int ChordSocketTransport::listenOnPort (uint16_t port)
+{
+    // sockets
+    struct sockaddr_in server_sockaddr;
+	int opt { 1 }; // socket options
+    
+    // init struct
+    memset(&server_sockaddr, 0, sizeof(server_sockaddr)); // fill struct with zeros
+	server_sockaddr.sin_family = AF_INET;
+	server_sockaddr.sin_addr.s_addr = INADDR_ANY;
+	server_sockaddr.sin_port = htons(port);
+    
+    // init server socket
+    int listeningSocket = socket(AF_INET, SOCK_STREAM, 0);
+    setsockopt(listeningSocket, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(int));
+    
+    if (bind(listeningSocket, (struct sockaddr *)&server_sockaddr, sizeof(server_sockaddr)) != 0) {
+        Log::sharedLog()->errorWithErrno("ChordSocketTransport::listenOnPort():bind() ", errno);
+        close(listeningSocket);
+        return -1;
+    }
+    
+    if (::listen(listeningSocket, 20) != 0) {
+        Log::sharedLog()->errorWithErrno("ChordSocketTransport::listenOnPort():listen() ", errno);
+        close(listeningSocket);
+        return -1;
+    }
+    
+    return listeningSocket;
+}
+
+// accepts an incomming connection (called by reactor)
+bool ChordSocketTransport::acceptConnection (int listeningSocket, ChordAcceptHandler handler)
+{
+    int client_socket = accept(listeningSocket, nullptr, nullptr);
+    
+    if (client_socket < 0) {
+        Log::sharedLog()->errorWithErrno("ChordSocketTransport::acceptConnection():accept() ", errno);
+        return true;
+    }
+    
+    CHORD_LOGV("ChordSocketTransport::acceptConnection(): client connected ...");
+    
+    handler(std::make_shared<ChordSocketConnection>(client_socket, _reactor));
+    
+    // wait for the next connection
+    return true;
+}
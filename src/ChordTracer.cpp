@@ -0,0 +1,189 @@
+/*
+ ChordTracer.cpp
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/ChordTracer.h>
+#include <rgp/ChordLog.h>
+
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <iomanip>
+#include <arpa/inet.h>
+
+using namespace rgp;
+
+const size_t ChordTracer::kEncodedHopSize;
+
+#pragma mark - Public
+
+// called with every finished trace
+void ChordTracer::setHandler (ChordTraceHandler handler)
+{
+    _handler_mutex.lock();
+    _handler = handler;
+    _handler_mutex.unlock();
+}
+
+// returns the id of a new trace or 0 if the search isn't sampled
+uint32_t ChordTracer::sample ()
+{
+    uint32_t interval { _samplingInterval.load(std::memory_order_relaxed) };
+    if (interval == 0) {
+        return 0;
+    }
+    
+    if (_searchCount.fetch_add(1, std::memory_order_relaxed) % interval != 0) {
+        return 0;
+    }
+    
+    // ids of different nodes shouldn't collide
+    static thread_local std::mt19937 generator { std::random_device()() };
+    
+    uint32_t traceId { 0 };
+    while (traceId == 0) {
+        traceId = generator();
+    }
+    
+    return traceId;
+}
+
+// passes the finished trace to the handler
+void ChordTracer::traceFinished (const ChordTrace &trace)
+{
+    _handler_mutex.lock();
+    ChordTraceHandler handler { _handler };
+    _handler_mutex.unlock();
+    
+    if (handler) {
+        handler(trace);
+    } else {
+        CHORD_LOGI(description(trace));
+    }
+}
+
+// entry of this node for the path
+ChordTraceHop ChordTracer::hopForNode (ChordId nodeId, uint8_t hop, std::chrono::steady_clock::time_point receivedAt)
+{
+    std::chrono::steady_clock::duration duration { std::chrono::steady_clock::now() - receivedAt };
+    
+    // the arrival on the wall clock (the steady clock has no epoch)
+    std::chrono::system_clock::time_point arrival { std::chrono::system_clock::now() -
+                                                    std::chrono::duration_cast<std::chrono::system_clock::duration>(duration) };
+    
+    ChordTraceHop traceHop;
+    traceHop.nodeId = nodeId;
+    traceHop.hop = hop;
+    traceHop.receivedAt = std::chrono::duration_cast<std::chrono::microseconds>(arrival.time_since_epoch()).count();
+    traceHop.duration = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+    
+    return traceHop;
+}
+
+// writes the path
+void ChordTracer::encodePath (const std::vector<ChordTraceHop> &path, uint8_t *buffer)
+{
+    for (const ChordTraceHop &hop : path) {
+        
+        ChordId nodeId { htonId(hop.nodeId) };
+        memcpy(buffer, &nodeId, sizeof(nodeId));
+        buffer += sizeof(nodeId);
+        
+        *buffer++ = hop.hop;
+        
+        uint32_t receivedAt[2] { htonl(static_cast<uint32_t>(hop.receivedAt >> 32)), htonl(static_cast<uint32_t>(hop.receivedAt)) };
+        memcpy(buffer, receivedAt, sizeof(receivedAt));
+        buffer += sizeof(receivedAt);
+        
+        uint32_t duration { htonl(hop.duration) };
+        memcpy(buffer, &duration, sizeof(duration));
+        buffer += sizeof(duration);
+    }
+}
+
+// reads the path
+bool ChordTracer::decodePath (const uint8_t *buffer, size_t size, std::vector<ChordTraceHop> *path)
+{
+    if (size % kEncodedHopSize != 0) {
+        return false;
+    }
+    
+    for (size_t offset = 0; offset < size; offset += kEncodedHopSize) {
+        
+        const uint8_t *position { buffer + offset };
+        ChordTraceHop hop;
+        
+        ChordId nodeId { 0 };
+        memcpy(&nodeId, position, sizeof(nodeId));
+        hop.nodeId = ntohId(nodeId);
+        position += sizeof(nodeId);
+        
+        hop.hop = *position++;
+        
+        uint32_t receivedAt[2] { 0, 0 };
+        memcpy(receivedAt, position, sizeof(receivedAt));
+        hop.receivedAt = (static_cast<uint64_t>(ntohl(receivedAt[0])) << 32) | ntohl(receivedAt[1]);
+        position += sizeof(receivedAt);
+        
+        uint32_t duration { 0 };
+        memcpy(&duration, position, sizeof(duration));
+        hop.duration = ntohl(duration);
+        
+        path->push_back(hop);
+    }
+    
+    return true;
+}
+
+// readable form of the trace
+std::string ChordTracer::description (const ChordTrace &trace)
+{
+    std::stringstream description;
+    
+    description << "trace " << std::hex << std::setw(8) << std::setfill('0') << trace.traceId << std::dec << std::setfill(' ') << " key: " << trace.key;
+    if (trace.failed) {
+        description << " failed";
+    } else {
+        description << " responsible: " << ntohId(trace.responsibleNode.nodeId);
+    }
+    description << " hops: " << trace.path.size()
+                << " duration: " << std::chrono::duration_cast<std::chrono::microseconds>(trace.duration).count() << " us";
+    
+    for (size_t k = 0; k < trace.path.size(); k++) {
+        const ChordTraceHop &hop = trace.path[k];
+        
+        // the time of the node without the following hops
+        uint32_t ownDuration { hop.duration };
+        if (k + 1 < trace.path.size() && trace.path[k + 1].duration <= hop.duration) {
+            ownDuration = hop.duration - trace.path[k + 1].duration;
+        }
+        
+        description << std::endl << "  hop " << static_cast<int>(hop.hop) << " node: " << hop.nodeId
+                    << " received at: " << hop.receivedAt << " duration: " << hop.duration << " us"
+                    << " own: " << ownDuration << " us";
+    }
+    
+    return description.str();
+}
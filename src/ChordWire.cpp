@@ -0,0 +1,224 @@
+/*
+ ChordWire.cpp
+ Chord
+
+ Created by Ralph-Gordon Paul on 16. October 2026.
+ 
+ -------------------------------------------------------------------------------
+ GNU Lesser General Public License Version 3, 29 June 2007
+ 
+ Copyright (c) 2026 Ralph-Gordon Paul. All rights reserved.
+ 
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+ 
+ You should have received a copy of the GNU Lesser General Public License
+ along with this library.
+ -------------------------------------------------------------------------------
+*/
+
+#include <rgp/ChordWire.h>
+#include <rgp/ChordLog.h>
+
+#include <cstring>
+#include <arpa/inet.h>
+
+using namespace rgp;
+
+const uint8_t ChordWire::kMagic;
+const uint8_t ChordWire::kVersion;
+const uint8_t ChordWire::kMinVersion;
+const uint8_t ChordWire::kSupportedFlags;
+const uint8_t ChordWire::kTraceVersion;
+const size_t ChordWire::kFixedHeaderSize;
+const size_t ChordWire::kMaxVarintSize;
+const size_t ChordWire::kMaxIdVarintSize;
+const size_t ChordWire::kMaxHeaderSize;
+const size_t ChordWire::kEncodedNodeSize;
+
+#pragma mark - Public
+
+// writes the header into the buffer
+size_t ChordWire::encodeHeader (const ChordHeader &header, uint8_t *buffer)
+{
+    size_t size { 0 };
+    
+    bool traced { (header.flags & ChordMessageFlagTraced) != 0 };
+    
+    buffer[size++] = kMagic;
+    buffer[size++] = traced ? kTraceVersion : kMinVersion; // oldest version that knows the header
+    buffer[size++] = header.flags;
+    buffer[size++] = header.type;
+    
+    // ip and port are already in network byte order
+    memcpy(buffer + size, &header.node.ip, sizeof(header.node.ip));
+    size += sizeof(header.node.ip);
+    memcpy(buffer + size, &header.node.port, sizeof(header.node.port));
+    size += sizeof(header.node.port);
+    
+    size += encodeVarint(ntohl(header.requestId), buffer + size);
+    size += encodeVarint(ntohl(header.dataSize), buffer + size);
+    size += encodeVarint(ntohId(header.node.nodeId), buffer + size);
+    
+    if (traced) {
+        size += encodeVarint(ntohl(header.traceId), buffer + size);
+        buffer[size++] = header.hops;
+    }
+    
+    return size;
+}
+
+// reads a header from the buffer
+ssize_t ChordWire::decodeHeader (const uint8_t *buffer, size_t size, ChordHeader *header)
+{
+    if (size < kFixedHeaderSize) {
+        // check the first bytes as soon as they are there (fail early)
+        if ((size > 0 && buffer[0] != kMagic) || (size > 1 && (buffer[1] < kMinVersion || buffer[1] > kVersion))) {
+            return -1;
+        }
+        return 0;
+    }
+    
+    if (buffer[0] != kMagic) {
+        CHORD_LOGE("ChordWire::decodeHeader(): wrong magic");
+        return -1;
+    }
+    
+    if (buffer[1] < kMinVersion || buffer[1] > kVersion) {
+        CHORD_LOGE("ChordWire::decodeHeader(): unsupported version: " << static_cast<int>(buffer[1]));
+        return -1;
+    }
+    
+    if ((buffer[2] & ~kSupportedFlags) != 0 || ((buffer[2] & ChordMessageFlagTraced) && buffer[1] < kTraceVersion)) {
+        CHORD_LOGE("ChordWire::decodeHeader(): unsupported flags: " << static_cast<int>(buffer[2]));
+        return -1;
+    }
+    
+    ChordHeader decoded { };
+    decoded.version = buffer[1];
+    decoded.flags = buffer[2];
+    decoded.type = static_cast<ChordMessageType>(buffer[3]);
+    
+    memcpy(&decoded.node.ip, buffer + 4, sizeof(decoded.node.ip));
+    memcpy(&decoded.node.port, buffer + 8, sizeof(decoded.node.port));
+    
+    size_t position { kFixedHeaderSize };
+    uint64_t values[3] { 0, 0, 0 };
+    const size_t maxSizes[3] { kMaxVarintSize, kMaxVarintSize, kMaxIdVarintSize };
+    
+    for (int i = 0; i < 3; i++) {
+        ssize_t varintSize { decodeVarint(buffer + position, size - position, maxSizes[i], &values[i]) };
+        if (varintSize <= 0) {
+            return varintSize;
+        }
+        position += varintSize;
+    }
+    
+    // 5 varint bytes can hold more than 32 bits
+    if (values[0] > UINT32_MAX || values[1] > UINT32_MAX) {
+        CHORD_LOGE("ChordWire::decodeHeader(): value is too big");
+        return -1;
+    }
+    
+    // the node id has to fit on the ring
+    if (values[2] > ChordIdRing::highestId()) {
+        CHORD_LOGE("ChordWire::decodeHeader(): node id is too big (different id width?)");
+        return -1;
+    }
+    
+    decoded.requestId = htonl(static_cast<uint32_t>(values[0]));
+    decoded.dataSize = htonl(static_cast<uint32_t>(values[1]));
+    decoded.node.nodeId = htonId(static_cast<ChordId>(values[2]));
+    
+    if (decoded.flags & ChordMessageFlagTraced) {
+        
+        uint64_t traceId { 0 };
+        ssize_t varintSize { decodeVarint(buffer + position, size - position, kMaxVarintSize, &traceId) };
+        if (varintSize <= 0) {
+            return varintSize;
+        }
+        position += varintSize;
+        
+        if (position == size) {
+            return 0; // hop counter is missing
+        }
+        
+        if (traceId > UINT32_MAX) {
+            CHORD_LOGE("ChordWire::decodeHeader(): trace id is too big");
+            return -1;
+        }
+        
+        decoded.traceId = htonl(static_cast<uint32_t>(traceId));
+        decoded.hops = buffer[position++];
+    }
+    
+    *header = decoded;
+    return position;
+}
+
+// writes the node into the buffer
+void ChordWire::encodeNode (const ChordHeaderNode &node, uint8_t *buffer)
+{
+    // all fields are already in network byte order
+    memcpy(buffer, &node.nodeId, sizeof(node.nodeId));
+    memcpy(buffer + sizeof(node.nodeId), &node.ip, sizeof(node.ip));
+    memcpy(buffer + sizeof(node.nodeId) + sizeof(node.ip), &node.port, sizeof(node.port));
+}
+
+// reads a node from the buffer
+ChordHeaderNode ChordWire::decodeNode (const uint8_t *buffer)
+{
+    ChordHeaderNode node { 0, 0, 0 };
+    
+    memcpy(&node.nodeId, buffer, sizeof(node.nodeId));
+    memcpy(&node.ip, buffer + sizeof(node.nodeId), sizeof(node.ip));
+    memcpy(&node.port, buffer + sizeof(node.nodeId) + sizeof(node.ip), sizeof(node.port));
+    
+    return node;
+}
+
+#pragma mark - Private
+
+// writes value as varint
+size_t ChordWire::encodeVarint (uint64_t value, uint8_t *buffer)
+{
+    size_t size { 0 };
+    
+    while (value >= 0x80) {
+        buffer[size++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    buffer[size++] = static_cast<uint8_t>(value);
+    
+    return size;
+}
+
+// reads a varint
+ssize_t ChordWire::decodeVarint (const uint8_t *buffer, size_t size, size_t maxSize, uint64_t *value)
+{
+    uint64_t result { 0 };
+    
+    for (size_t i = 0; i < maxSize; i++) {
+        
+        if (i == size) {
+            return 0; // more bytes needed
+        }
+        
+        result |= static_cast<uint64_t>(buffer[i] & 0x7F) << (7 * i);
+        
+        if ((buffer[i] & 0x80) == 0) {
+            *value = result;
+            return i + 1;
+        }
+    }
+    
+    // longer than the value can be
+    return -1;
+}